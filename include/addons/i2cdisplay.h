@@ -7,11 +7,15 @@
 #define DISPLAY_H_
 
 #include <string>
+#include <vector>
 #include <hardware/i2c.h>
 #include "OneBitDisplay.h"
 #include "BoardConfig.h"
 #include "gpaddon.h"
 #include "gamepad.h"
+#include "FrameScheduler.hpp"
+#include "displaylayouts.h"
+#include "messagebus.h"
 
 #ifndef HAS_I2C_DISPLAY
 #define HAS_I2C_DISPLAY -1
@@ -53,9 +57,72 @@
 #define DISPLAY_USEWIRE 1
 #endif
 
+#ifndef DISPLAY_FRAME_RATE
+#define DISPLAY_FRAME_RATE 30 // Most refreshes a second, the display is only redrawn when its state changes
+#endif
+
+#ifndef PERF_HUD_HOTKEY
+#define PERF_HUD_HOTKEY GAMEPAD_MASK_A2 // Held with F1 to toggle the performance page
+#endif
+
+#define DISPLAY_TEXT_LINES 8  // Rows on a text page (performance page, menu)
+#define DISPLAY_TEXT_WIDTH 21 // Characters per row in the 6x8 font
+
 // i2c Display Module
 #define I2CDisplayName "I2CDisplay"
 
+// Everything the display shows, a redraw only happens when this changes
+struct DisplayState
+{
+	uint32_t buttons; // Processed dpad << 16 | buttons, as the GAMEPAD_MASK_D* masks expect
+	uint8_t inputMode;
+	uint8_t dpadMode;
+	uint8_t socdMode;
+	uint8_t turboShotCount;
+	bool configMode;
+};
+
+// A button shape rasterized once in the display's page layout, shifted down for the row it starts on
+struct ButtonSprite
+{
+	uint8_t shape;  // LayoutShape
+	uint8_t width;  // Pixels
+	uint8_t height;
+	uint8_t shift;  // Rows into the first page
+	uint8_t pages;
+	std::vector<uint8_t> cover; // Pixels the button owns, page-major like the back buffer
+	std::vector<uint8_t> pressed;
+	std::vector<uint8_t> released;
+};
+
+struct ButtonElement
+{
+	int16_t x;      // Left column
+	int8_t page;    // First page
+	uint32_t mask;  // Button shown, 0 for parts that never change
+	uint16_t sprite;
+};
+
+// A stick shows its ball at one of nine places around the gate
+struct StickElement
+{
+	uint32_t up, down, left, right;
+	ButtonElement gate;
+	ButtonElement balls[9]; // Rows up, neutral, down by columns left, neutral, right
+	int16_t x1, y1, x2, y2; // Area cleared when the ball moves
+};
+
+// Where everything on the splash is this frame, the rows that moved are all that get redrawn
+struct SplashFrame
+{
+	bool image;          // Full screen image under everything else
+	bool logos;
+	int16_t logoTop;     // Top edge of each half of the boot logo
+	int16_t logoBottom;
+	int16_t bandTop;     // Last row of the band closing in from the top, -1 for none
+	int16_t bandBottom;  // First row of the band closing in from the bottom, past the last row for none
+};
+
 // i2C OLED Display
 class I2CDisplayAddon : public GPAddon
 {
@@ -65,39 +132,58 @@ public:
 	virtual void process();
 	virtual std::string name() { return I2CDisplayName; }
 	void clearScreen(int render); // DisplayModule
-	void drawStickless(int startX, int startY, int buttonRadius, int buttonPadding);
-	void drawWasdBox(int startX, int startY, int buttonRadius, int buttonPadding);
-	void drawArcadeStick(int startX, int startY, int buttonRadius, int buttonPadding);
 	void drawStatusBar(Gamepad*);
 	void drawText(int startX, int startY, std::string text);
 	void initMenu(char**);
 	//Adding my stuff here, remember to sort before PR
-	void drawDiamond(int cx, int cy, int size, uint8_t colour, uint8_t filled);
-	void drawUDLR(int startX, int startY, int buttonRadius, int buttonPadding);
-	void drawMAMEA(int startX, int startY, int buttonSize, int buttonPadding);
-	void drawMAMEB(int startX, int startY, int buttonSize, int buttonPadding);
-	void drawKeyboardAngled(int startX, int startY, int buttonRadius, int buttonPadding);
-	void drawVewlix(int startX, int startY, int buttonRadius, int buttonPadding);
-	void drawVewlix7(int startX, int startY, int buttonRadius, int buttonPadding);
-	void drawSega2p(int startX, int startY, int buttonRadius, int buttonPadding);
-	void drawNoir8(int startX, int startY, int buttonRadius, int buttonPadding);
-	void drawCapcom(int startX, int startY, int buttonRadius, int buttonPadding);
-	void drawCapcom6(int startX, int startY, int buttonRadius, int buttonPadding);
-	void drawSticklessButtons(int startX, int startY, int buttonRadius, int buttonPadding);
-	void drawWasdButtons(int startX, int startY, int buttonRadius, int buttonPadding);
-	void drawArcadeButtons(int startX, int startY, int buttonRadius, int buttonPadding);
-	void drawSplashScreen(int splashMode, int splashSpeed);
-	void drawDancepadA(int startX, int startY, int buttonSize, int buttonPadding);
-	void drawDancepadB(int startX, int startY, int buttonSize, int buttonPadding);
-	void drawTwinStickA(int startX, int startY, int buttonSize, int buttonPadding);
-	void drawTwinStickB(int startX, int startY, int buttonSize, int buttonPadding);
-	void drawBlankA(int startX, int startY, int buttonSize, int buttonPadding);
-	void drawBlankB(int startX, int startY, int buttonSize, int buttonPadding);
+	void drawDiamond(OBDISP *pOBD, int cx, int cy, int size, uint8_t colour, uint8_t filled);
+	SplashFrame getSplashFrame(int splashMode, int splashSpeed);
+	bool updateSplash();
+	void drawSplashScreen();
+	void loadButtonLayout();
+	static void handleConfigChanged(const Message &message, void *context);
+	void addLayout(const LayoutTable &layout);
+	void addElement(const LayoutElement &element);
+	void addButton(uint8_t shape, int x, int y, int width, int height, uint32_t mask);
+	void addStick(int startX, int startY, int buttonRadius, int buttonMargin, uint32_t up, uint32_t down, uint32_t left, uint32_t right);
+	uint16_t getSprite(uint8_t shape, int width, int height, int shift);
+	std::vector<uint8_t> rasterize(const ButtonSprite &sprite, bool filled);
+	void blitSprite(const ButtonElement &element, bool isPressed);
+	void drawButtons();
+	static void handlePerfHUD(const Message &message, void *context);
+	void setLEDStats(const FrameStats *stats) { ledStats = stats; }
+	bool updatePerfHUD(uint64_t now);
+	bool updateMenuPage(bool updated);
+	bool updateTextPage(char lines[DISPLAY_TEXT_LINES][DISPLAY_TEXT_WIDTH + 1]);
+	void drawTextPage();
+	bool pressed(uint32_t mask) { return displayState.buttons & mask; }
+	bool regionDirty(uint32_t mask) { return fullRedraw || (changedButtons & mask); }
+	DisplayState readState();
 	uint8_t ucBackBuffer[1024];
 	OBDISP obd;
 	std::string statusBar;
 	Gamepad* gamepad;
 	Gamepad* pGamepad;
+	FrameScheduler scheduler;
+	DisplayState displayState;
+	uint32_t changedButtons; // Buttons that changed since the last redraw
+	bool fullRedraw;         // Clear and draw everything on the next frame
+	bool splashShown;
+	SplashFrame splashFrame; // Last splash frame drawn
+	int8_t splashFirstPage;  // Pages the next splash draw covers, none when first is past last
+	int8_t splashLastPage;
+	bool flushPending;       // Last frame found a flush still running and wasn't sent yet
+	std::vector<ButtonSprite> buttonSprites;
+	std::vector<ButtonElement> buttonElements;
+	std::vector<StickElement> stickElements;
+	bool hudShown;           // Performance page instead of the buttons
+	bool menuShown;
+	uint64_t nextHudUpdate;
+	DisplayMenuState menuState;
+	std::string textLines[DISPLAY_TEXT_LINES];
+	uint8_t textDirty;       // Text page rows that changed since they were drawn
+	Core0Stats core0Stats;
+	const FrameStats *ledStats;
 };
 
 #endif
\ No newline at end of file
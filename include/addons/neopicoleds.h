@@ -16,6 +16,7 @@
 #include "gamepad.h"
 #include "gpaddon.h"
 #include "storagemanager.h"
+#include "messagebus.h"
 
 // MPGS
 #include "BoardConfig.h"
@@ -54,6 +55,10 @@
 #define LEDS_BUTTON_COLOR_INDEX 1
 #endif
 
+#ifndef LEDS_PRESS_EFFECT_INDEX
+#define LEDS_PRESS_EFFECT_INDEX 0 // PressEffects, 0 lights held buttons with a static color
+#endif
+
 #ifndef LEDS_THEME_INDEX
 #define LEDS_THEME_INDEX 0
 #endif
@@ -74,6 +79,10 @@
 #define LED_BRIGHTNESS_STEPS 5
 #endif
 
+#ifndef LED_FRAME_RATE
+#define LED_FRAME_RATE 100 // Target LED frames per second, effects run at the same speed at any rate
+#endif
+
 #ifndef LEDS_DPAD_LEFT
 #define LEDS_DPAD_LEFT  -1
 #endif
@@ -146,7 +155,12 @@
 #define LEDS_BUTTON_A2  -1
 #endif
 
+#ifndef LED_HOTKEY_REPEAT_MS
+#define LED_HOTKEY_REPEAT_MS 250 // Repeat rate for held LED hotkeys
+#endif
+
 void configureAnimations(AnimationStation *as);
+bool hasLEDChains(const LEDOptions &ledOptions);
 AnimationHotkey animationHotkeys(Gamepad *gamepad);
 PixelMatrix createLedButtonLayout(ButtonLayout layout, int ledsPerPixel);
 PixelMatrix createLedButtonLayout(ButtonLayout layout, std::vector<uint8_t> *positions);
@@ -170,21 +184,29 @@ public:
 	virtual void process();
 	virtual std::string name() { return NeoPicoLEDName; }
 	void configureLEDs();
-	uint32_t frame[100];
+	const FrameStats &getFrameStats() const { return scheduler.GetStats(); }
+	std::vector<uint32_t> frame; // Logical frame, chains take consecutive slices
 private:
+	static void handleConfigChanged(const Message &message, void *context);
+	static void handleHotkey(const Message &message, void *context);
+	static void handleAnimationOptions(const Message &message, void *context);
+	static void handlePlayerLEDs(const Message &message, void *context);
+	void loadLEDProgram();
 	std::vector<uint8_t> * getLEDPositions(std::string button, std::vector<std::vector<uint8_t>> *positions);
 	std::vector<std::vector<Pixel>> generatedLEDButtons(std::vector<std::vector<uint8_t>> *positions);
 	std::vector<std::vector<Pixel>> generatedLEDHitbox(std::vector<std::vector<uint8_t>> *positions);
 	std::vector<std::vector<Pixel>> generatedLEDWasd(std::vector<std::vector<uint8_t>> *positions);
 	std::vector<std::vector<Pixel>> createLEDLayout(ButtonLayout layout, uint8_t ledsPerPixel, uint8_t ledButtonCount);
 	uint8_t setupButtonPositions();
-	const uint32_t intervalMS = 10;
-	absolute_time_t nextRunTime;
-	uint8_t ledCount;
+	FrameScheduler scheduler;
+	uint16_t ledCount;
 	PixelMatrix matrix;
-	NeoPico *neopico;
+	uint32_t ledMask = 0; // Buttons that have LEDs
+	LEDFormat frameFormat;
+	std::vector<NeoPico *> chains;
+	bool framePending = false; // Last frame didn't reach every chain
 	InputMode inputMode; // HACK
-	PLEDAnimationState animationState; // NeoPico can control the player LEDs
+	PLEDAnimationState animationState = { 0, PLED_ANIM_NONE, PLED_SPEED_OFF }; // NeoPico can control the player LEDs
 	NeoPicoPlayerLEDs * neoPLEDs = nullptr;
 	AnimationStation as;
 	std::map<std::string, int> buttonPositions;
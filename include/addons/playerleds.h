@@ -12,18 +12,53 @@
 #include "PlayerLEDs.h"
 #include "gpaddon.h"
 #include "helper.h"
+#include "messagebus.h"
 
 // This needs to be moved to storage if we're going to share between modules
-extern NeoPico *neopico;
 extern AnimationStation as;
 
+#define PLED_FADE_STEPS 128 // Fade table length, a power of two so the DMA read ring can wrap it
+
+#ifndef PLED_FADE_STEP_US
+#define PLED_FADE_STEP_US 16000 // Time per fade step, a full fade out and back in takes PLED_FADE_STEPS steps
+#endif
+
+/* PWM player LEDs animate on the hardware. Fades are a table per PWM slice that DMA feeds to the
+   compare register, paced by the wrap of a spare slice. Blink and cycle change state from a
+   repeating timer. Levels are only written when they change, so core1 does no per-frame work. */
 class PWMPlayerLEDs : public PlayerLEDs
 {
 public:
 	void setup();
 	void display();
+	void play(const PLEDAnimationState &animationState); // Restarts the animation only if the pattern changed
+
+protected:
+	struct FadeSlice
+	{
+		uint slice;
+		int dmaChannel;
+	};
+
+	static bool handleTimer(repeating_timer_t *timer);
+	void stop();
+	bool startFade();
+	void showState(uint8_t state);
+	void writeLevel(int index, uint16_t level);
+
+	PLEDAnimationState playing = { 0, PLED_ANIM_NONE, PLED_SPEED_OFF };
+	repeating_timer_t timer;
+	bool timerActive = false;
+	bool softwareFade = false;  // No DMA channel was free, so the fade steps on the CPU
+	int paceSlice = -1;         // Spare slice whose wrap paces the fade DMA
+	FadeSlice fadeSlices[PLED_COUNT];
+	uint8_t fadeSliceCount = 0;
+	uint8_t step = 0;           // Blink phase or steps taken by the cycle
+	uint32_t writtenLevels[PLED_COUNT] = { UINT32_MAX, UINT32_MAX, UINT32_MAX, UINT32_MAX }; // UINT32_MAX if unknown
 };
 
+PLEDAnimationState getXInputAnimation(const uint8_t *data);
+
 // Player LED Module
 #define PLEDName "PLED"
 
@@ -38,9 +73,10 @@ public:
 	PlayerLEDAddon() : type(PLED_TYPE) { }
 	PlayerLEDAddon(PLEDType type) : type(type) { }
 protected:
+	static void handlePlayerLEDs(const Message &message, void *context);
 	PLEDType type;
 	PWMPlayerLEDs * pwmLEDs = nullptr;
-	PLEDAnimationState animationState;
+	PLEDAnimationState animationState = { 0, PLED_ANIM_NONE, PLED_SPEED_OFF };
 };
 
 #endif
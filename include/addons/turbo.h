@@ -3,6 +3,9 @@
 
 #include "gpaddon.h"
 
+#define TURBO_SHOT_MIN 5
+#define TURBO_SHOT_MAX 30
+
 #ifndef DEFAULT_SHOT_PER_SEC
 #define DEFAULT_SHOT_PER_SEC 15
 #endif  // DEFAULT_SHOT_PER_SEC
@@ -34,6 +37,7 @@ private:
     uint16_t lastDpad;          // Last d-pad pressed (for Turbo Change)
     uint16_t buttonsEnabled;    // Turbo Buttons Enabled
     uint32_t uIntervalMS;       // Turbo Interval
+    uint8_t shotCount;          // Shots per second uIntervalMS was worked out for
     bool bTurboState;           // Turbo Buttons State
     bool bTurboFlicker;         // Turbo Enable Buttons Toggle OFF Flag ??
     uint32_t nextTimer;         // Turbo Timer
@@ -8,6 +8,8 @@
 // `bootLogoBottom` is the default image that will scroll up from the bottom.
 // `splashCustom` is a custom image that you can change as needed.
 // If you plan to use a custom image through `splashCustom`, make sure to remove ` /*` from the top and bottom of the section 
+// Keep the size comment (e.g. `// 'name', 128x64px`) at the top of each image, the firmware doesn't include this file directly.
+// `tools/compress-bitmaps.py` compresses it into `bitmaps_rle.h` before each build.
 
 
 // Hard coded default
@@ -0,0 +1,216 @@
+// Generated by tools/compress-bitmaps.py from bitmaps.h, edit that file instead.
+
+#ifndef BITMAPS_RLE_H_
+#define BITMAPS_RLE_H_
+
+#include "rlebitmap.h"
+
+// 128x64px, 291 bytes from 1024
+static const uint8_t splashImageMainData[] = {
+	0x7f, 0x7f, 0x7f, 0x7f, 0x7f, 0x49, 0x03, 0x80, 0x00, 0x80, 0x80, 0x51, 0x12, 0x80, 0xc0, 0xe0,
+	0xf0, 0xf0, 0x70, 0xf8, 0xf0, 0xfc, 0x3e, 0x65, 0x20, 0x70, 0x30, 0xf0, 0xf8, 0xfe, 0xfc, 0xb8,
+	0xc1, 0x9c, 0x03, 0x8c, 0x1c, 0x04, 0x08, 0x50, 0x07, 0x80, 0x80, 0xc0, 0xc0, 0xe0, 0x80, 0xa0,
+	0x80, 0xc1, 0xc0, 0x02, 0xf0, 0xf0, 0xd8, 0xc0, 0xc0, 0x07, 0x80, 0x80, 0x00, 0xc0, 0xe0, 0xf0,
+	0x70, 0x78, 0xc0, 0xf8, 0x15, 0xf0, 0x30, 0x00, 0x20, 0x90, 0xf0, 0xd8, 0xf8, 0x78, 0x3c, 0x18,
+	0x1c, 0xfc, 0xf8, 0xf8, 0xa0, 0xf0, 0xfc, 0xfe, 0xdf, 0xc3, 0xe0, 0xc0, 0xf8, 0x0a, 0x60, 0xc0,
+	0xe4, 0xf2, 0xfe, 0x3b, 0x1f, 0x0f, 0x07, 0x03, 0xc3, 0x81, 0x04, 0x7f, 0x14, 0xe0, 0x60, 0xf0,
+	0xc0, 0x70, 0x15, 0x38, 0x78, 0x28, 0x10, 0x08, 0x40, 0xf8, 0xfe, 0xff, 0x5f, 0x07, 0x03, 0x81,
+	0x80, 0xc0, 0xc1, 0xe1, 0x60, 0x74, 0x1a, 0xce, 0xfe, 0x81, 0x06, 0xef, 0xe7, 0xe3, 0x73, 0xf3,
+	0x71, 0x73, 0xc0, 0x20, 0x4b, 0x10, 0x80, 0xe0, 0xf0, 0xf8, 0x7e, 0x7e, 0x6f, 0xf7, 0x77, 0xf3,
+	0xf9, 0xf8, 0xd9, 0x9c, 0x8d, 0xe2, 0xfd, 0x81, 0x13, 0x7f, 0x79, 0x39, 0x3d, 0x1f, 0x0f, 0x0f,
+	0x87, 0xc3, 0xe1, 0xf1, 0xfc, 0xfe, 0xff, 0xef, 0xe7, 0xe3, 0x60, 0x70, 0x7c, 0x81, 0x0a, 0xf7,
+	0xc1, 0xe0, 0xf0, 0x78, 0x78, 0x3e, 0x1f, 0x0f, 0x07, 0x07, 0xc0, 0x03, 0x04, 0x7b, 0xff, 0xbf,
+	0x17, 0x02, 0x41, 0x0b, 0x1f, 0x3f, 0x3f, 0x3e, 0x38, 0x3c, 0x1e, 0x1f, 0x0f, 0x07, 0x03, 0x01,
+	0x4c, 0x13, 0x01, 0x07, 0x07, 0x0f, 0x07, 0x0f, 0x07, 0x07, 0x03, 0x03, 0x01, 0x03, 0x02, 0x03,
+	0x0f, 0x07, 0x0b, 0x03, 0x01, 0x01, 0x54, 0x11, 0x1f, 0x3f, 0x7f, 0x3d, 0x78, 0x3c, 0x1e, 0x9e,
+	0xef, 0xff, 0x7f, 0x0f, 0x03, 0xf1, 0x3f, 0x5f, 0x0f, 0x07, 0x46, 0x00, 0x02, 0xc0, 0x07, 0x01,
+	0x03, 0x03, 0xc0, 0x01, 0x44, 0xc2, 0x01, 0x4b, 0x00, 0x05, 0x7f, 0x4d, 0x01, 0x05, 0x03, 0x7f,
+	0x7f, 0x7f, 0x71,
+};
+const RLEBitmap splashImageMain = { 128, 64, sizeof(splashImageMainData), splashImageMainData };
+
+// 128x64px, 356 bytes from 1024
+static const uint8_t splashImage01Data[] = {
+	0x7f, 0x7f, 0x7f, 0x7f, 0x4b, 0x01, 0x80, 0xe0, 0xcf, 0xf8, 0x05, 0x38, 0x08, 0xc0, 0xf0, 0xf8,
+	0xf8, 0xc4, 0x78, 0xc2, 0xf8, 0x04, 0x38, 0x08, 0x40, 0x70, 0x58, 0xc3, 0x48, 0x09, 0xc8, 0x48,
+	0x08, 0x88, 0xe8, 0x38, 0x18, 0xc0, 0x70, 0x18, 0xc7, 0x88, 0x0b, 0x08, 0x08, 0xc8, 0x78, 0x18,
+	0x80, 0xe0, 0x38, 0x88, 0xe8, 0x38, 0x08, 0x42, 0x06, 0x80, 0xe0, 0x38, 0x88, 0xe8, 0x38, 0x08,
+	0x44, 0x02, 0xc0, 0x70, 0x18, 0xc7, 0x88, 0x05, 0x08, 0x08, 0x88, 0xe8, 0x38, 0x08, 0x48, 0x08,
+	0x80, 0xe0, 0xf8, 0xfe, 0xff, 0x7f, 0x1f, 0x07, 0x01, 0xc5, 0x80, 0x07, 0x82, 0x83, 0x83, 0x03,
+	0x03, 0xc3, 0xf0, 0xfc, 0x82, 0x01, 0xc7, 0xc1, 0xc1, 0xc0, 0x06, 0xe0, 0xf8, 0xfe, 0xff, 0x3f,
+	0x0f, 0xc3, 0xc6, 0x40, 0x0d, 0x60, 0x38, 0x8e, 0xe3, 0x38, 0x0e, 0xc3, 0x70, 0x1c, 0xc7, 0x71,
+	0x1c, 0x07, 0x01, 0x43, 0x0d, 0xc0, 0x70, 0x1c, 0xc6, 0x73, 0x1c, 0x87, 0xe1, 0x38, 0x0e, 0x03,
+	0x78, 0x4e, 0x43, 0xc0, 0x40, 0x12, 0x60, 0x38, 0x0e, 0x03, 0x78, 0x4e, 0x43, 0x40, 0xc0, 0x40,
+	0x00, 0xc0, 0x70, 0x1c, 0xc7, 0x71, 0x1c, 0x07, 0x01, 0x43, 0x07, 0x80, 0xe0, 0x38, 0x8e, 0xe3,
+	0x38, 0x0e, 0x03, 0x47, 0x08, 0x80, 0xe0, 0xf8, 0xfe, 0xff, 0x7f, 0x1f, 0x07, 0x01, 0x43, 0x02,
+	0x01, 0x07, 0xc7, 0x82, 0x05, 0x7f, 0x3f, 0x07, 0xc1, 0xf0, 0xfc, 0x81, 0x01, 0x3f, 0x0f, 0xc8,
+	0x03, 0x06, 0xc3, 0x70, 0x1c, 0xc7, 0x71, 0x1c, 0x06, 0xc6, 0x02, 0x07, 0xc3, 0x70, 0x1c, 0xc7,
+	0x71, 0x1c, 0x07, 0x01, 0x43, 0x0a, 0xc0, 0x70, 0x1c, 0x87, 0xf1, 0x1c, 0x07, 0x01, 0x00, 0x02,
+	0x03, 0xc2, 0x02, 0x06, 0xc2, 0x72, 0x1e, 0x86, 0xe0, 0x38, 0x0e, 0xc2, 0x02, 0x07, 0xc3, 0x71,
+	0x1c, 0xc7, 0x71, 0x1c, 0x07, 0x01, 0x43, 0x07, 0x80, 0xe0, 0x38, 0x8e, 0xe3, 0x38, 0x0e, 0x03,
+	0x48, 0x02, 0x20, 0x38, 0x3e, 0xc2, 0x3f, 0xc6, 0x3e, 0x06, 0x3f, 0x3f, 0x1f, 0x07, 0x01, 0x30,
+	0x3c, 0xc0, 0x3f, 0x01, 0x0f, 0x03, 0x49, 0x07, 0x20, 0x30, 0x3c, 0x27, 0x21, 0x20, 0x20, 0x23,
+	0xc3, 0x22, 0x09, 0x32, 0x1e, 0x06, 0x30, 0x3c, 0x27, 0x21, 0x20, 0x20, 0x23, 0xc4, 0x22, 0x04,
+	0x23, 0x31, 0x1c, 0x07, 0x01, 0x48, 0x06, 0x30, 0x3c, 0x27, 0x21, 0x38, 0x0e, 0x03, 0x43, 0x07,
+	0x20, 0x30, 0x3c, 0x27, 0x21, 0x20, 0x20, 0x23, 0xc5, 0x22, 0x03, 0x23, 0x38, 0x0e, 0x03, 0x7f,
+	0x7f, 0x7f, 0x7f, 0x4b,
+};
+const RLEBitmap splashImage01 = { 128, 64, sizeof(splashImage01Data), splashImage01Data };
+
+// 128x64px, 894 bytes from 1024
+static const uint8_t splashImage02Data[] = {
+	0x02, 0x00, 0xf0, 0xf0, 0xc3, 0x0c, 0xc2, 0x8c, 0x41, 0x01, 0xfc, 0xfc, 0xc4, 0x8c, 0x01, 0x70,
+	0x70, 0x42, 0x08, 0x30, 0x30, 0x0c, 0x0c, 0x8c, 0xcc, 0xec, 0x70, 0x30, 0x41, 0x01, 0xf0, 0xf0,
+	0xc0, 0x0c, 0x03, 0x8c, 0xec, 0xf0, 0xf0, 0x42, 0x06, 0x80, 0xc0, 0xe0, 0x70, 0x30, 0xfc, 0xfc,
+	0x42, 0x01, 0xf0, 0xf0, 0xc0, 0x0c, 0x03, 0x8c, 0xec, 0xf0, 0xf0, 0x41, 0x00, 0x80, 0x43, 0x01,
+	0xf0, 0xf0, 0xc0, 0x0c, 0x00, 0x4c, 0xc2, 0x0c, 0x02, 0x3c, 0x30, 0x80, 0x41, 0x1f, 0xfc, 0xfc,
+	0x8c, 0xac, 0x8c, 0x8c, 0x0c, 0x0c, 0x4c, 0x0c, 0x00, 0x80, 0x00, 0x08, 0x80, 0x10, 0x80, 0x80,
+	0x48, 0x50, 0x20, 0x20, 0x10, 0x10, 0x8c, 0x84, 0x04, 0x04, 0xf8, 0x40, 0x00, 0x44, 0x41, 0x01,
+	0x3f, 0x3f, 0xc3, 0xc0, 0xc0, 0xc1, 0x01, 0x3f, 0x3f, 0x41, 0x81, 0xc4, 0x01, 0x44, 0x05, 0xf0,
+	0xfc, 0xce, 0xc7, 0xc3, 0xc1, 0xc0, 0xc0, 0x41, 0x0d, 0x3f, 0x3f, 0xdc, 0xc7, 0xc3, 0xc3, 0xc0,
+	0x3f, 0x3f, 0x00, 0x3e, 0x3f, 0x33, 0x31, 0xc0, 0x30, 0x81, 0x14, 0x30, 0x30, 0x00, 0x3f, 0x3f,
+	0xdc, 0xc7, 0xc3, 0xc3, 0xc0, 0x3f, 0x3f, 0x00, 0x0c, 0x0c, 0x8c, 0x0c, 0x0c, 0x00, 0x3f, 0x3f,
+	0xc1, 0xc0, 0x09, 0xc4, 0xc0, 0xc1, 0xc8, 0xc0, 0xf0, 0x30, 0x00, 0x04, 0x00, 0x81, 0xc1, 0xc1,
+	0x03, 0xc8, 0xc0, 0xc0, 0xc9, 0x41, 0x0d, 0x44, 0xfc, 0x02, 0x01, 0xf0, 0x78, 0x3c, 0x1e, 0x06,
+	0xc7, 0xff, 0x7f, 0x3f, 0x0f, 0x41, 0x04, 0x3f, 0x10, 0x19, 0xe0, 0x42, 0x45, 0x00, 0x40, 0x41,
+	0x00, 0x40, 0x41, 0x00, 0x20, 0x41, 0x00, 0x20, 0x41, 0x00, 0x10, 0x41, 0x07, 0x80, 0x04, 0x00,
+	0x20, 0x40, 0x02, 0x00, 0x90, 0x41, 0x37, 0x10, 0x80, 0x00, 0x10, 0x00, 0x10, 0x00, 0x40, 0x00,
+	0x04, 0x00, 0x10, 0x40, 0x00, 0xa0, 0x00, 0x02, 0x00, 0x01, 0x48, 0x80, 0x10, 0x02, 0x40, 0x80,
+	0x00, 0xa0, 0x0a, 0x10, 0x00, 0x20, 0x04, 0x80, 0x24, 0x80, 0x00, 0x44, 0x80, 0xc0, 0x82, 0xd0,
+	0x82, 0xa8, 0x00, 0x44, 0xa0, 0x80, 0x14, 0xc4, 0x70, 0x10, 0x08, 0xcc, 0xc4, 0xe4, 0xe2, 0xc1,
+	0xf2, 0x0e, 0xe2, 0xe6, 0xc4, 0xcc, 0x08, 0x10, 0x64, 0xc8, 0x38, 0x08, 0x84, 0xe4, 0xe2, 0xf2,
+	0xf0, 0xc0, 0xf9, 0x0d, 0xf8, 0xf0, 0xf0, 0xe0, 0xe0, 0x82, 0x01, 0x31, 0x98, 0x9c, 0xfc, 0xfe,
+	0xff, 0x38, 0x41, 0x3f, 0xc3, 0x3f, 0xda, 0x40, 0x80, 0x11, 0x00, 0x40, 0x80, 0x14, 0x00, 0x20,
+	0x80, 0x02, 0x00, 0x89, 0x20, 0x00, 0x22, 0x80, 0x21, 0x04, 0x90, 0x00, 0x04, 0x50, 0x00, 0xa2,
+	0x00, 0x09, 0xa0, 0x08, 0x90, 0x02, 0x40, 0x08, 0x52, 0x80, 0x2a, 0x80, 0x10, 0xc4, 0x10, 0x45,
+	0x10, 0x20, 0x45, 0x48, 0x90, 0x25, 0xc0, 0x1a, 0xe0, 0x02, 0x58, 0xa2, 0x40, 0xac, 0x92, 0x28,
+	0xc2, 0x18, 0xe1, 0x84, 0x07, 0x79, 0x1c, 0x06, 0xc2, 0xf2, 0xf1, 0xf9, 0xf8, 0xc1, 0xfc, 0x08,
+	0xf8, 0xf9, 0xf1, 0xf2, 0xc2, 0x07, 0x01, 0x00, 0x3c, 0x8d, 0x00, 0x3c, 0x42, 0x01, 0x1e, 0x7f,
+	0x8b, 0x3f, 0x7f, 0x1e, 0x00, 0xc0, 0x39, 0xe9, 0xb8, 0x28, 0x54, 0xee, 0x2d, 0xdb, 0x9b, 0x66,
+	0x84, 0xa8, 0x00, 0xaa, 0x80, 0x28, 0x41, 0x24, 0xc8, 0x12, 0x54, 0x80, 0x34, 0x41, 0x94, 0x50,
+	0xa4, 0x11, 0x64, 0x84, 0x59, 0xa2, 0x9a, 0xa0, 0x19, 0xe2, 0x94, 0x2a, 0xc1, 0xbc, 0x21, 0xd4,
+	0x25, 0xda, 0x22, 0x6c, 0xd2, 0xa4, 0x5d, 0x61, 0x9b, 0x74, 0xa5, 0xda, 0xa5, 0x5a, 0x6a, 0xda,
+	0xa2, 0xdd, 0x0e, 0x2a, 0xda, 0xb5, 0xe6, 0x2c, 0xdb, 0x76, 0xc9, 0xd6, 0x3d, 0xff, 0x60, 0x80,
+	0x0f, 0x3f, 0x8b, 0x01, 0x3f, 0x0f, 0x42, 0x0c, 0x80, 0x83, 0xc3, 0xc7, 0xc7, 0xcf, 0x8f, 0x8f,
+	0x0f, 0x07, 0x07, 0x03, 0x03, 0x43, 0x3f, 0x80, 0x80, 0xc0, 0xc1, 0xe1, 0xe3, 0xe3, 0xe7, 0xc7,
+	0xc7, 0x87, 0x83, 0x13, 0x31, 0xc9, 0x58, 0xac, 0x13, 0x45, 0xb4, 0x25, 0x86, 0x29, 0xa2, 0x0d,
+	0xaa, 0x10, 0x8b, 0x12, 0x58, 0x76, 0x80, 0x7e, 0xc1, 0x3d, 0xe2, 0x1c, 0xf5, 0xa5, 0x4a, 0xbd,
+	0xda, 0x62, 0xdd, 0xb2, 0xad, 0xeb, 0x1c, 0xfb, 0x42, 0xfe, 0xaa, 0x55, 0xfe, 0xaa, 0x5b, 0xf2,
+	0x2e, 0xdd, 0x7a, 0x53, 0xed, 0x5d, 0xeb, 0x27, 0x3a, 0xed, 0x9b, 0x73, 0xae, 0x6d, 0xbb, 0xa4,
+	0x6f, 0x9d, 0x7b, 0xa5, 0xae, 0x5b, 0xbd, 0xa3, 0x5e, 0xa9, 0x5f, 0xd1, 0xbf, 0x22, 0xad, 0xab,
+	0x7a, 0x17, 0x0c, 0xcb, 0xc6, 0xe4, 0xe0, 0xf0, 0xf1, 0xf1, 0xf3, 0xe3, 0xe3, 0xc3, 0xc1, 0x01,
+	0x42, 0x01, 0xf0, 0xfc, 0x8b, 0x01, 0xfc, 0xf0, 0x42, 0x01, 0x78, 0xfe, 0x8b, 0x0a, 0xfe, 0x78,
+	0x00, 0x03, 0xfc, 0x22, 0x08, 0x01, 0x48, 0x00, 0x4a, 0x41, 0x3f, 0x4a, 0x00, 0x12, 0x00, 0xbb,
+	0xdd, 0x23, 0xde, 0x6b, 0xad, 0x5b, 0xbb, 0x66, 0x9d, 0x7b, 0xa6, 0xa9, 0x5f, 0xba, 0xa3, 0x3e,
+	0xc1, 0x2f, 0xdb, 0x2c, 0xd3, 0xad, 0xa3, 0x1e, 0x55, 0xa9, 0x67, 0x8a, 0x3d, 0xc3, 0x1c, 0x53,
+	0xa5, 0x9d, 0x22, 0x46, 0x5d, 0x42, 0x9d, 0x22, 0x4d, 0xa2, 0x1d, 0x21, 0x46, 0x1c, 0x41, 0x1e,
+	0x40, 0x95, 0x2a, 0x81, 0x14, 0x22, 0x85, 0x2c, 0x7f, 0x81, 0x00, 0x00, 0x3c, 0x8d, 0x08, 0x3c,
+	0x00, 0x80, 0x60, 0xc3, 0x4f, 0x8f, 0x9f, 0x1f, 0xc1, 0x3f, 0x0e, 0x1f, 0x9f, 0x8f, 0x4f, 0xc3,
+	0x20, 0x18, 0x46, 0x0c, 0x30, 0x21, 0xa7, 0x47, 0x4f, 0x8f, 0xc1, 0x9f, 0x09, 0x8f, 0x4f, 0xc7,
+	0x27, 0x21, 0x10, 0x0c, 0x03, 0x10, 0x02, 0x41, 0x02, 0x22, 0x00, 0x41, 0x41, 0x00, 0x22, 0x42,
+	0x3f, 0x45, 0x9d, 0x22, 0x9d, 0x22, 0x45, 0x1a, 0x65, 0x02, 0x2d, 0x4a, 0x10, 0xd7, 0x00, 0x35,
+	0x42, 0x05, 0x58, 0x03, 0x54, 0x02, 0x4a, 0x10, 0x05, 0x49, 0x12, 0x24, 0x81, 0x02, 0x2c, 0x01,
+	0x42, 0x0c, 0x20, 0x0a, 0x91, 0x00, 0x25, 0x00, 0x2a, 0x00, 0x02, 0x28, 0x01, 0x04, 0xa9, 0x00,
+	0x01, 0x42, 0x08, 0x20, 0x12, 0x00, 0x09, 0x20, 0x00, 0x12, 0x00, 0x03, 0x16, 0x08, 0x90, 0x13,
+	0x23, 0x15, 0x27, 0x47, 0x4f, 0xcf, 0x4f, 0x4f, 0x47, 0x27, 0x23, 0x13, 0x10, 0x08, 0x46, 0x01,
+	0x00, 0x08, 0x01, 0x20, 0x00, 0x03, 0x01, 0x09, 0xc0, 0x01, 0x00, 0x08, 0x44, 0x02, 0x24, 0x00,
+	0x10, 0x43, 0x00, 0x11, 0x41, 0x00, 0x10, 0x42, 0x00, 0x08, 0x42, 0x00, 0x08, 0x4d,
+};
+const RLEBitmap splashImage02 = { 128, 64, sizeof(splashImage02Data), splashImage02Data };
+
+// 128x64px, 552 bytes from 1024
+static const uint8_t splashImage03Data[] = {
+	0xc9, 0xd5, 0xff, 0x55, 0xe9, 0x55, 0xc3, 0xd5, 0x03, 0xaa, 0xaa, 0x6a, 0xaa, 0xc0, 0x2a, 0x07,
+	0x0a, 0x0a, 0x02, 0xe0, 0xf0, 0xf8, 0x7c, 0x1e, 0xc2, 0x0e, 0x02, 0x3e, 0x3c, 0x38, 0x42, 0x00,
+	0xe0, 0xc0, 0xfe, 0xc2, 0x0e, 0x03, 0xfe, 0xfc, 0xfc, 0xf0, 0x41, 0x0a, 0x38, 0x3c, 0x3c, 0x1e,
+	0x0e, 0x06, 0x0e, 0xfe, 0xfe, 0xfc, 0x78, 0x41, 0x0a, 0xe0, 0xf8, 0xfc, 0x1e, 0x0e, 0x06, 0x0e,
+	0x1e, 0xfe, 0xfc, 0xf0, 0x43, 0x08, 0x80, 0xc0, 0xf0, 0x78, 0xfc, 0xfe, 0xfe, 0x7e, 0x02, 0x41,
+	0x0a, 0xe0, 0xf8, 0xfc, 0x1e, 0x0e, 0x06, 0x0e, 0x1e, 0xfe, 0xfc, 0xf0, 0x41, 0x04, 0xe0, 0xf0,
+	0xfc, 0x3c, 0x1e, 0xc1, 0x0e, 0x03, 0x1e, 0x7e, 0x7c, 0x70, 0x41, 0x00, 0xe0, 0xc0, 0xfe, 0xc5,
+	0x0e, 0x41, 0x03, 0x2a, 0x2a, 0xaa, 0x6a, 0xc1, 0xaa, 0x07, 0xb2, 0xaa, 0xa7, 0xa2, 0xa0, 0x80,
+	0x00, 0x3f, 0x82, 0x02, 0xc0, 0x80, 0x80, 0xc0, 0x8e, 0xc0, 0xfe, 0x00, 0x0e, 0x41, 0x00, 0xf8,
+	0x81, 0x00, 0x1f, 0xc2, 0x0e, 0x10, 0x0f, 0x07, 0x07, 0x03, 0x00, 0x80, 0xc0, 0xc0, 0xe0, 0xf0,
+	0xf8, 0xbc, 0x9e, 0x8f, 0x87, 0x83, 0x81, 0x41, 0x00, 0x7f, 0x81, 0x00, 0x87, 0xc0, 0x80, 0x00,
+	0xe0, 0x81, 0x09, 0x3f, 0x03, 0x30, 0x38, 0x3e, 0x3f, 0x37, 0x33, 0x30, 0xf8, 0x81, 0x01, 0x3f,
+	0x30, 0x41, 0x00, 0x7f, 0x81, 0x00, 0x87, 0xc0, 0x80, 0x00, 0xe0, 0x81, 0x03, 0x3f, 0x03, 0x00,
+	0x3f, 0x82, 0xc2, 0x80, 0x03, 0xe0, 0xf0, 0xf0, 0x70, 0x41, 0x00, 0xf8, 0x81, 0x00, 0x9f, 0xc4,
+	0x87, 0x42, 0x07, 0xa0, 0xa2, 0xa7, 0xaa, 0xb2, 0xaa, 0xaa, 0x5a, 0xc0, 0x1a, 0x01, 0xda, 0xda,
+	0xc0, 0x5a, 0x12, 0x98, 0x90, 0x51, 0x53, 0x53, 0xd3, 0x93, 0x13, 0x13, 0x93, 0xd3, 0x51, 0x70,
+	0x30, 0x70, 0xd2, 0x13, 0xd3, 0x53, 0xc8, 0x50, 0xc8, 0x53, 0x00, 0x51, 0xc0, 0x50, 0x00, 0x51,
+	0xc3, 0x53, 0x00, 0x51, 0xc6, 0x50, 0x00, 0x52, 0xc0, 0x53, 0xc2, 0x50, 0x00, 0x51, 0xc3, 0x53,
+	0x00, 0x51, 0xc3, 0x50, 0x0e, 0x51, 0x53, 0x53, 0xd3, 0x13, 0xd3, 0xd3, 0x91, 0xd1, 0x50, 0x90,
+	0x90, 0x52, 0x53, 0x93, 0xc5, 0x13, 0x04, 0x11, 0x10, 0x10, 0x1a, 0x9a, 0xc3, 0x1a, 0x03, 0x20,
+	0x18, 0x04, 0x03, 0x45, 0x05, 0x1c, 0x36, 0xe2, 0xe6, 0x3e, 0x1d, 0xc0, 0x01, 0x42, 0x13, 0xc0,
+	0xc0, 0xef, 0xa0, 0xef, 0x60, 0x60, 0xe0, 0xf0, 0xf0, 0x60, 0xe0, 0xe0, 0x70, 0x30, 0x30, 0x20,
+	0x20, 0xa0, 0xa0, 0xc0, 0xe0, 0x73, 0x02, 0xff, 0x00, 0xff, 0x47, 0x12, 0x01, 0x02, 0x04, 0x18,
+	0x20, 0x10, 0x10, 0x08, 0x04, 0x04, 0x02, 0x01, 0x01, 0x00, 0x01, 0x02, 0x04, 0x08, 0x10, 0xc0,
+	0x20, 0xc1, 0x10, 0xc0, 0x08, 0x08, 0x0c, 0x0c, 0x1c, 0x1f, 0x1f, 0x1a, 0x0a, 0x02, 0x02, 0xc0,
+	0x01, 0x14, 0x0f, 0x0e, 0x06, 0x01, 0x05, 0x0f, 0x0e, 0x0c, 0x01, 0x81, 0x41, 0x60, 0x20, 0x10,
+	0x08, 0x0c, 0x14, 0x2a, 0x55, 0x2e, 0x57, 0x82, 0x00, 0x00, 0xdd, 0xa0, 0x05, 0x08, 0xf8, 0xe8,
+	0xe8, 0xc8, 0x88, 0xc7, 0x08, 0x0e, 0x68, 0x68, 0x28, 0x2b, 0x28, 0xab, 0xa8, 0x88, 0x48, 0x58,
+	0x18, 0x98, 0x88, 0x90, 0x10, 0xc0, 0x30, 0x03, 0x20, 0x20, 0x60, 0x60, 0xc1, 0x40, 0x00, 0xc0,
+	0xc2, 0x80, 0x41, 0xdb, 0x05, 0x00, 0xff, 0x41, 0x0a, 0x80, 0x80, 0xc0, 0x60, 0x30, 0x18, 0x0c,
+	0x06, 0x02, 0x01, 0x01, 0x63, 0x10, 0x01, 0x01, 0x03, 0x03, 0x07, 0x0d, 0x1e, 0x34, 0x4c, 0x88,
+	0x90, 0x23, 0x25, 0xe5, 0x43, 0x43, 0x41, 0xc2, 0x40, 0x01, 0x49, 0x4d, 0xc2, 0x55, 0x05, 0x59,
+	0x48, 0x41, 0x41, 0x49, 0x49, 0xc3, 0x54, 0xc0, 0x48, 0x08, 0x40, 0x41, 0x41, 0x61, 0x8a, 0x4a,
+	0x2a, 0x2a, 0x1a, 0xd6, 0x0a, 0x04, 0x0f, 0x0a, 0x05, 0x02, 0x01, 0x77, 0x02, 0x01, 0x02, 0x0f,
+	0xda, 0x08, 0x04, 0x18, 0x28, 0x28, 0x48, 0x88,
+};
+const RLEBitmap splashImage03 = { 128, 64, sizeof(splashImage03Data), splashImage03Data };
+
+// 43x39px, 118 bytes from 234
+static const uint8_t bootLogoTopData[] = {
+	0x00, 0x80, 0xc0, 0x40, 0xc2, 0x60, 0x05, 0x70, 0x70, 0x78, 0x78, 0x7c, 0x7c, 0xc0, 0x7e, 0xc4,
+	0x7f, 0xc0, 0x7e, 0x05, 0x7c, 0x7c, 0x78, 0x78, 0x70, 0x70, 0xc2, 0x60, 0xc0, 0x40, 0x00, 0x80,
+	0x59, 0x01, 0x80, 0x80, 0x41, 0x01, 0x80, 0x80, 0x54, 0x00, 0x18, 0xc0, 0x3c, 0x00, 0x18, 0x44,
+	0x10, 0xc6, 0xef, 0xef, 0xc6, 0x30, 0x7b, 0x7f, 0x37, 0x63, 0xf3, 0xf7, 0x67, 0xc3, 0xec, 0xfe,
+	0xde, 0x0c, 0x45, 0x03, 0x0c, 0x30, 0xe0, 0x80, 0x50, 0x01, 0x01, 0x01, 0x49, 0x01, 0x01, 0x01,
+	0x43, 0x03, 0x80, 0xe0, 0x30, 0x0c, 0x42, 0x01, 0x01, 0x01, 0xc1, 0x03, 0x05, 0x07, 0x07, 0x0f,
+	0x0f, 0x1f, 0x1f, 0xc1, 0x3f, 0xc2, 0x7f, 0xc1, 0x3f, 0x05, 0x1f, 0x1f, 0x0f, 0x0f, 0x07, 0x07,
+	0xc1, 0x03, 0x01, 0x01, 0x01, 0x42,
+};
+const RLEBitmap bootLogoTop = { 43, 39, sizeof(bootLogoTopData), bootLogoTopData };
+
+// 80x21px, 153 bytes from 210
+static const uint8_t bootLogoBottomData[] = {
+	0x00, 0xfe, 0x82, 0xc1, 0x0f, 0xc1, 0x3f, 0x00, 0x00, 0x83, 0xc1, 0x0f, 0x82, 0x03, 0xfe, 0xf8,
+	0x00, 0x7e, 0xc0, 0x7f, 0xc0, 0x0f, 0x00, 0x8f, 0x82, 0x06, 0xfe, 0x00, 0xf0, 0xfc, 0xfe, 0xfe,
+	0x3f, 0xc0, 0x0f, 0x05, 0x3f, 0xfe, 0xfe, 0xfc, 0xe0, 0x00, 0x83, 0x43, 0x83, 0x05, 0x00, 0xe0,
+	0xfc, 0xfe, 0xfe, 0xff, 0xc0, 0x0f, 0x04, 0x1f, 0xfe, 0xfe, 0xfc, 0xf0, 0x83, 0x41, 0x01, 0x0f,
+	0x0f, 0x83, 0x00, 0x00, 0x83, 0xc4, 0x0f, 0x0f, 0x07, 0x01, 0x00, 0xf0, 0xf8, 0xf8, 0xfc, 0x3e,
+	0x3e, 0x1f, 0x0f, 0xc7, 0xc7, 0xc3, 0xc1, 0x00, 0x83, 0x00, 0x80, 0x42, 0x00, 0x80, 0x83, 0x01,
+	0x00, 0x07, 0xc4, 0x0f, 0x83, 0x00, 0x00, 0x84, 0x42, 0x00, 0x80, 0x83, 0x03, 0x07, 0x0f, 0x1f,
+	0x1f, 0xc1, 0x1e, 0x04, 0x1f, 0x0f, 0x0f, 0x07, 0x00, 0xc1, 0x1f, 0x49, 0xc9, 0x1f, 0x41, 0x02,
+	0x03, 0x07, 0x0f, 0xc2, 0x1f, 0x02, 0x0f, 0x07, 0x03, 0x49, 0xc1, 0x1f, 0x41, 0x03, 0x03, 0x07,
+	0x0f, 0x0f, 0xc1, 0x1f, 0x03, 0x0f, 0x07, 0x03, 0x00,
+};
+const RLEBitmap bootLogoBottom = { 80, 21, sizeof(bootLogoBottomData), bootLogoBottomData };
+
+// Empty in bitmaps.h
+const RLEBitmap splashCustom = { 0, 0, 0, nullptr };
+
+// 128x64px, 294 bytes from 1024
+static const uint8_t splashImageLegacyData[] = {
+	0x6a, 0xc0, 0x80, 0xc2, 0xc0, 0x05, 0xe0, 0xe0, 0xf0, 0xf0, 0xf8, 0xf8, 0xc0, 0xfc, 0xc4, 0xfe,
+	0xc0, 0xfc, 0x05, 0xf8, 0xf8, 0xf0, 0xf0, 0xe0, 0xe0, 0xc2, 0xc0, 0xc0, 0x80, 0x7f, 0x55, 0x00,
+	0x01, 0x68, 0x00, 0x01, 0x7f, 0x5e, 0x00, 0x30, 0xc0, 0x78, 0x00, 0x30, 0x44, 0x10, 0x8c, 0xde,
+	0xde, 0x8c, 0x60, 0xf6, 0xff, 0x6f, 0xc6, 0xe6, 0xef, 0xcf, 0x86, 0xd8, 0xfc, 0xbc, 0x18, 0x7f,
+	0x5a, 0x02, 0x18, 0x60, 0xc0, 0x50, 0x03, 0x01, 0x03, 0x03, 0x01, 0x44, 0x06, 0x01, 0x01, 0x00,
+	0x01, 0x03, 0x03, 0x01, 0x43, 0x02, 0xc0, 0x60, 0x18, 0x7f, 0x56, 0x02, 0x01, 0x03, 0x02, 0xc1,
+	0x06, 0x05, 0x0e, 0x0e, 0x1e, 0x1e, 0x3e, 0x3e, 0xc1, 0x7e, 0xc2, 0xfe, 0xc1, 0x7e, 0x05, 0x3e,
+	0x3e, 0x1e, 0x1e, 0x0e, 0x0e, 0xc1, 0x06, 0x02, 0x02, 0x03, 0x01, 0x7f, 0x44, 0x00, 0xf8, 0xc0,
+	0xfc, 0xc1, 0x3c, 0xc1, 0xfc, 0x00, 0x00, 0xc1, 0xfc, 0xc1, 0x3c, 0xc0, 0xfc, 0x03, 0xf8, 0xe0,
+	0x00, 0xf8, 0xc0, 0xfc, 0xc1, 0x3c, 0xc0, 0xfc, 0x06, 0xf8, 0x00, 0xc0, 0xf0, 0xf8, 0xf8, 0xfc,
+	0xc0, 0x3c, 0x05, 0xfc, 0xf8, 0xf8, 0xf0, 0x80, 0x00, 0xc1, 0xfc, 0x43, 0xc1, 0xfc, 0x05, 0x00,
+	0x80, 0xf0, 0xf8, 0xf8, 0xfc, 0xc0, 0x3c, 0x04, 0x7c, 0xf8, 0xf8, 0xf0, 0xc0, 0x6f, 0x83, 0x41,
+	0x01, 0x3c, 0x3c, 0xc1, 0xfc, 0x00, 0x00, 0x83, 0xc1, 0x3c, 0xc0, 0x3f, 0x0f, 0x1f, 0x07, 0x00,
+	0xc1, 0xe1, 0xe1, 0xf1, 0xf8, 0xf8, 0x7c, 0x3e, 0x1f, 0x1f, 0x0f, 0x07, 0x00, 0x83, 0x44, 0x83,
+	0x01, 0x00, 0x1f, 0xc0, 0x3f, 0xc1, 0x3c, 0x83, 0x00, 0x00, 0x84, 0x43, 0x83, 0x6f, 0x03, 0x1f,
+	0x3f, 0x7f, 0x7f, 0xc1, 0x78, 0x04, 0x7f, 0x3f, 0x3f, 0x1f, 0x00, 0xc1, 0x7f, 0x49, 0xc1, 0x7f,
+	0xc1, 0x7c, 0xc1, 0x7f, 0x05, 0x00, 0x03, 0x0f, 0x1f, 0x3f, 0x7e, 0xc0, 0x7c, 0x04, 0x7e, 0x3f,
+	0x1f, 0x0f, 0x03, 0x48, 0xc1, 0x7f, 0x05, 0x00, 0x03, 0x0f, 0x1f, 0x3f, 0x3f, 0xc0, 0x7c, 0x04,
+	0x7e, 0x3f, 0x1f, 0x0f, 0x03, 0x57,
+};
+const RLEBitmap splashImageLegacy = { 128, 64, sizeof(splashImageLegacyData), splashImageLegacyData };
+
+#endif
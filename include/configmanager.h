@@ -4,6 +4,7 @@
 #include "enums.h"
 #include "gpconfig.h"
 #include "storagemanager.h"
+#include "AnimationStation.hpp"
 
 class ConfigManager {
 public:
@@ -18,9 +19,13 @@ public:
     void setGamepadOptions(Gamepad*);
     void setBoardOptions(BoardOptions);
     void setLedOptions(LEDOptions);
+    void setAnimationOptions(AnimationOptions);
+    void setLedProgram(const uint8_t *code, uint16_t size);
+    void setDisplayLayout(const LayoutElement *elements, uint8_t count);
 private:
-    ConfigManager() {}
+    ConfigManager() : config(nullptr) {}
     void setupConfig(GPConfig*);
+    void notifyChanged(uint32_t configBlocks);
     ConfigType cType;
     GPConfig * config;
 };
@@ -3,27 +3,72 @@
 
 #include "gpconfig.h"
 
-#include <vector>
+#include <stdint.h>
 
-class DisplayState {
-public:
-private:
-    std::vector<char*> options;
+#ifndef DISPLAY_MENU_HOTKEY
+#define DISPLAY_MENU_HOTKEY GAMEPAD_MASK_A1 // Held with F1 to open the menu, no other hotkey uses it
+#endif
+
+#ifndef DISPLAY_MENU_HOLD_MS
+#define DISPLAY_MENU_HOLD_MS 1000 // Hold the menu hotkey on its own this long to open the menu
+#endif
+
+typedef enum
+{
+    DISPLAY_MENU_SOCD,
+    DISPLAY_MENU_DPAD,
+    DISPLAY_MENU_TURBO,
+    DISPLAY_MENU_LAYOUT,
+    DISPLAY_MENU_LAYOUT_RIGHT,
+    DISPLAY_MENU_COUNT,
+} DisplayMenuItemId;
+
+// Shared by both cores: core0 edits the values, core1 draws them
+struct DisplayMenuItem
+{
+    const char *label;
+    uint8_t min;
+    uint8_t max;
+    const char * const *names; // Value names from min, nullptr shows the number
+};
+
+extern const DisplayMenuItem displayMenuItems[DISPLAY_MENU_COUNT];
+
+// Published to core1 whenever the menu changes
+struct DisplayMenuState
+{
+    bool open;
+    bool modified; // Values differ from the stored options
+    uint8_t selected;
+    uint8_t values[DISPLAY_MENU_COUNT];
 };
 
+// Cursor and values, edits stay here until they're saved
 class DisplayMenu {
 public:
-    
+    void open(const uint8_t *values);
+    void close() { state.open = false; }
+    bool isOpen() const { return state.open; }
+    void select(int8_t step);
+    void change(int8_t step);
+    const DisplayMenuState &getState() const { return state; }
 private:
+    DisplayMenuState state = { };
 };
 
+// Runs on core0 next to the gamepad, the menu takes over the inputs while it's open
 class DisplayConfig : public GPConfig
 {
 public:
     virtual void setup();
     virtual void loop();
 private:
-    std::vector<char **> menu_data;
+    void open();
+    void save();
+    DisplayMenu menu;
+    uint32_t holdStart = 0;
+    uint32_t lastInputs = 0; // dpad << 16 | buttons, for press edges
+    bool releasing = false;
 };
 
-#endif
\ No newline at end of file
+#endif
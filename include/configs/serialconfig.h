@@ -3,12 +3,84 @@
 
 #include "gpconfig.h"
 
+#include <stdint.h>
+
+/* Framed binary protocol over USB CDC, see tools/gp2040-serial.py for the host side.
+   Frame: sync, command, sequence, payload length (LE16), payload, CRC32 (LE) of command through payload.
+   Replies echo the sequence with SERIAL_CMD_REPLY set on the command and start with a SerialStatus byte. */
+
+#define SERIAL_CONFIG_SYNC        0xA5
+#define SERIAL_CONFIG_VERSION     1
+#define SERIAL_CONFIG_HEADER_SIZE 5
+#define SERIAL_CONFIG_MAX_PAYLOAD 512
+#define SERIAL_CONFIG_TIMEOUT_MS  100 // A frame that stalls this long is dropped
+
+typedef enum
+{
+    SERIAL_CMD_PING      = 0x01, // -> version, max payload, block sizes, firmware version string
+    SERIAL_CMD_GET       = 0x02, // block ids -> a record per block
+    SERIAL_CMD_SET       = 0x03, // records -> nothing, every record is checked before any are stored
+    SERIAL_CMD_TELEMETRY = 0x04, // -> one SerialTelemetry
+    SERIAL_CMD_STREAM    = 0x05, // interval ms (LE16), 0 stops -> SerialTelemetry frames until stopped
+    SERIAL_CMD_REBOOT    = 0x06, // -> acknowledged before the board restarts
+    SERIAL_CMD_REPLY     = 0x80,
+} SerialCommand;
+
+typedef enum
+{
+    SERIAL_STATUS_OK,
+    SERIAL_STATUS_BAD_CRC,
+    SERIAL_STATUS_BAD_COMMAND,
+    SERIAL_STATUS_BAD_BLOCK,      // Unknown block, or a value the web config would not accept
+    SERIAL_STATUS_BAD_SIZE,
+} SerialStatus;
+
+// Record: block id, size (LE16), the stored struct as is. Ids match the ConfigBlock bit positions.
+typedef enum
+{
+    SERIAL_BLOCK_GAMEPAD,
+    SERIAL_BLOCK_BOARD,
+    SERIAL_BLOCK_LED,
+    SERIAL_BLOCK_ANIMATION,
+    SERIAL_BLOCK_COUNT,
+} SerialBlock;
+
+struct __attribute__ ((__packed__)) SerialTelemetry
+{
+    uint32_t uptime;       // Milliseconds since boot
+    uint8_t dpad;          // Raw inputs, nothing is reported to a host while configuring
+    uint16_t buttons;
+    uint16_t aux;
+    uint32_t pollRate;     // Serial config polls per second
+    uint32_t badFrames;    // Frames dropped for a bad CRC, size or timeout since boot
+    uint32_t flashCommits; // Flash commits since boot
+    uint32_t flashStall;   // Microseconds the longest commit held off both cores
+};
+
 class SerialConfig : public GPConfig
 {
 public:
     virtual void setup();
     virtual void loop();
 private:
+    void receive();
+    void handleFrame();
+    void reply(uint8_t command, uint8_t sequence, SerialStatus status, const uint8_t *payload = nullptr, uint16_t size = 0);
+    void write(const uint8_t *data, uint16_t size);
+    uint16_t getBlock(uint8_t block, uint8_t *data);
+    SerialStatus checkBlocks(const uint8_t *records, uint16_t size);
+    void setBlock(uint8_t block, const uint8_t *data);
+    SerialTelemetry getTelemetry();
+    uint8_t frame[SERIAL_CONFIG_HEADER_SIZE + SERIAL_CONFIG_MAX_PAYLOAD + 4];
+    uint16_t frameSize = 0;
+    uint32_t frameStart = 0;
+    uint32_t badFrames = 0;
+    uint16_t streamInterval = 0;
+    uint8_t streamSequence = 0;
+    uint32_t nextStream = 0;
+    uint32_t polls = 0;
+    uint32_t pollRate = 0;
+    uint32_t pollWindowStart = 0;
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,297 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: Copyright (c) 2021 Jason Skuby (mytechtoybox.com)
+ */
+
+#ifndef DISPLAYLAYOUTS_H_
+#define DISPLAYLAYOUTS_H_
+
+#include <stdint.h>
+#include "enums.h"
+#include "gamepad.h"
+
+#ifndef BUTTON_LAYOUT_RIGHT
+#define BUTTON_LAYOUT_RIGHT BUTTON_LAYOUT_ARCADE
+#endif
+
+#define DISPLAY_LAYOUT_MAX_ELEMENTS 32 // Elements in an uploaded layout
+
+typedef enum
+{
+	LAYOUT_SHAPE_ELLIPSE, // x, y is the center, width and height are the radii
+	LAYOUT_SHAPE_RECT,    // x, y is the top left corner, width and height in pixels
+	LAYOUT_SHAPE_DIAMOND, // x, y is the center, width is the distance to each corner
+	LAYOUT_SHAPE_STICK,   // x, y is the up-left end of the ball's travel, width is the ball radius, height the travel
+	LAYOUT_SHAPE_COUNT,
+} LayoutShape;
+
+// Sticks keep the bit numbers of their up, down, left and right buttons in the mask, one per byte
+#define LAYOUT_STICK_MASK(up, down, left, right) \
+	((uint32_t)__builtin_ctz(up) | ((uint32_t)__builtin_ctz(down) << 8) | \
+	((uint32_t)__builtin_ctz(left) << 16) | ((uint32_t)__builtin_ctz(right) << 24))
+
+/* One shape on the display. Layouts are plain tables of these, so built-in ones live in flash
+   and uploaded ones are stored as they are. The mask selects the button (dpad << 16 | buttons)
+   that fills the shape, 0 draws an outline that never changes. */
+struct LayoutElement
+{
+	uint8_t shape;
+	uint8_t x;
+	uint8_t y;
+	uint8_t width;
+	uint8_t height;
+	uint32_t mask;
+};
+
+struct LayoutTable
+{
+	const LayoutElement *elements;
+	uint8_t count;
+};
+
+// Uploaded elements are checked before they're stored, sprites are sized from these
+static inline bool isValidLayoutElement(const LayoutElement &element)
+{
+	switch (element.shape)
+	{
+		case LAYOUT_SHAPE_ELLIPSE:
+			return element.width <= 32 && element.height <= 32;
+		case LAYOUT_SHAPE_RECT:
+			return element.width <= 128 && element.height <= 64;
+		case LAYOUT_SHAPE_DIAMOND:
+			return element.width <= 32;
+		case LAYOUT_SHAPE_STICK:
+			return element.width <= 16 && element.height <= 64 && (element.mask & 0xE0E0E0E0) == 0;
+		default:
+			return false;
+	}
+}
+
+#define LAYOUT_TABLE(elements) { elements, sizeof(elements) / sizeof(*elements) }
+
+// Left side
+
+static constexpr LayoutElement layoutStick[] =
+{
+	{ LAYOUT_SHAPE_STICK, 8, 28, 8, 18, LAYOUT_STICK_MASK(GAMEPAD_MASK_DU, GAMEPAD_MASK_DD, GAMEPAD_MASK_DL, GAMEPAD_MASK_DR) },
+};
+
+static constexpr LayoutElement layoutStickless[] =
+{
+	{ LAYOUT_SHAPE_ELLIPSE, 8, 20, 8, 8, GAMEPAD_MASK_DL },
+	{ LAYOUT_SHAPE_ELLIPSE, 26, 20, 8, 8, GAMEPAD_MASK_DD },
+	{ LAYOUT_SHAPE_ELLIPSE, 41, 29, 8, 8, GAMEPAD_MASK_DR },
+	{ LAYOUT_SHAPE_ELLIPSE, 48, 53, 8, 8, GAMEPAD_MASK_DU },
+};
+
+static constexpr LayoutElement layoutButtonsAngled[] =
+{
+	{ LAYOUT_SHAPE_ELLIPSE, 8, 36, 7, 7, GAMEPAD_MASK_DL },
+	{ LAYOUT_SHAPE_ELLIPSE, 25, 42, 7, 7, GAMEPAD_MASK_DD },
+	{ LAYOUT_SHAPE_ELLIPSE, 33, 25, 7, 7, GAMEPAD_MASK_DU },
+	{ LAYOUT_SHAPE_ELLIPSE, 42, 49, 7, 7, GAMEPAD_MASK_DR },
+};
+
+static constexpr LayoutElement layoutButtonsBasic[] =
+{
+	{ LAYOUT_SHAPE_ELLIPSE, 8, 37, 8, 8, GAMEPAD_MASK_DL },
+	{ LAYOUT_SHAPE_ELLIPSE, 23, 24, 8, 8, GAMEPAD_MASK_DU },
+	{ LAYOUT_SHAPE_ELLIPSE, 23, 50, 8, 8, GAMEPAD_MASK_DD },
+	{ LAYOUT_SHAPE_ELLIPSE, 37, 37, 8, 8, GAMEPAD_MASK_DR },
+};
+
+static constexpr LayoutElement layoutKeyboardAngled[] =
+{
+	{ LAYOUT_SHAPE_DIAMOND, 18, 28, 5, 5, GAMEPAD_MASK_DL },
+	{ LAYOUT_SHAPE_DIAMOND, 24, 34, 5, 5, GAMEPAD_MASK_DD },
+	{ LAYOUT_SHAPE_DIAMOND, 30, 28, 5, 5, GAMEPAD_MASK_DU },
+	{ LAYOUT_SHAPE_DIAMOND, 30, 40, 5, 5, GAMEPAD_MASK_DR },
+};
+
+static constexpr LayoutElement layoutKeyboardA[] =
+{
+	{ LAYOUT_SHAPE_RECT, 8, 39, 11, 11, GAMEPAD_MASK_DL },
+	{ LAYOUT_SHAPE_RECT, 19, 39, 11, 11, GAMEPAD_MASK_DD },
+	{ LAYOUT_SHAPE_RECT, 19, 28, 11, 11, GAMEPAD_MASK_DU },
+	{ LAYOUT_SHAPE_RECT, 30, 39, 11, 11, GAMEPAD_MASK_DR },
+};
+
+static constexpr LayoutElement layoutDancepadA[] =
+{
+	{ LAYOUT_SHAPE_RECT, 39, 29, 16, 16, GAMEPAD_MASK_DL },
+	{ LAYOUT_SHAPE_RECT, 56, 46, 16, 16, GAMEPAD_MASK_DD },
+	{ LAYOUT_SHAPE_RECT, 56, 12, 16, 16, GAMEPAD_MASK_DU },
+	{ LAYOUT_SHAPE_RECT, 73, 29, 16, 16, GAMEPAD_MASK_DR },
+};
+
+static constexpr LayoutElement layoutTwinstickA[] =
+{
+	{ LAYOUT_SHAPE_STICK, 8, 28, 8, 18, LAYOUT_STICK_MASK(GAMEPAD_MASK_DU, GAMEPAD_MASK_DD, GAMEPAD_MASK_DL, GAMEPAD_MASK_DR) },
+};
+
+// Right side
+
+static constexpr LayoutElement layoutArcade[] =
+{
+	{ LAYOUT_SHAPE_ELLIPSE, 64, 28, 8, 8, GAMEPAD_MASK_B3 },
+	{ LAYOUT_SHAPE_ELLIPSE, 82, 24, 8, 8, GAMEPAD_MASK_B4 },
+	{ LAYOUT_SHAPE_ELLIPSE, 100, 24, 8, 8, GAMEPAD_MASK_R1 },
+	{ LAYOUT_SHAPE_ELLIPSE, 118, 28, 8, 8, GAMEPAD_MASK_L1 },
+	{ LAYOUT_SHAPE_ELLIPSE, 59, 46, 8, 8, GAMEPAD_MASK_B1 },
+	{ LAYOUT_SHAPE_ELLIPSE, 77, 42, 8, 8, GAMEPAD_MASK_B2 },
+	{ LAYOUT_SHAPE_ELLIPSE, 95, 42, 8, 8, GAMEPAD_MASK_R2 },
+	{ LAYOUT_SHAPE_ELLIPSE, 113, 46, 8, 8, GAMEPAD_MASK_L2 },
+};
+
+static constexpr LayoutElement layoutSticklessB[] =
+{
+	{ LAYOUT_SHAPE_ELLIPSE, 57, 20, 8, 8, GAMEPAD_MASK_B3 },
+	{ LAYOUT_SHAPE_ELLIPSE, 75, 16, 8, 8, GAMEPAD_MASK_B4 },
+	{ LAYOUT_SHAPE_ELLIPSE, 93, 16, 8, 8, GAMEPAD_MASK_R1 },
+	{ LAYOUT_SHAPE_ELLIPSE, 111, 20, 8, 8, GAMEPAD_MASK_L1 },
+	{ LAYOUT_SHAPE_ELLIPSE, 57, 38, 8, 8, GAMEPAD_MASK_B1 },
+	{ LAYOUT_SHAPE_ELLIPSE, 75, 34, 8, 8, GAMEPAD_MASK_B2 },
+	{ LAYOUT_SHAPE_ELLIPSE, 93, 34, 8, 8, GAMEPAD_MASK_R2 },
+	{ LAYOUT_SHAPE_ELLIPSE, 111, 38, 8, 8, GAMEPAD_MASK_L2 },
+};
+
+static constexpr LayoutElement layoutButtonsAngledB[] =
+{
+	{ LAYOUT_SHAPE_ELLIPSE, 69, 28, 7, 7, GAMEPAD_MASK_B3 },
+	{ LAYOUT_SHAPE_ELLIPSE, 86, 24, 7, 7, GAMEPAD_MASK_B4 },
+	{ LAYOUT_SHAPE_ELLIPSE, 103, 24, 7, 7, GAMEPAD_MASK_R1 },
+	{ LAYOUT_SHAPE_ELLIPSE, 120, 28, 7, 7, GAMEPAD_MASK_L1 },
+	{ LAYOUT_SHAPE_ELLIPSE, 63, 45, 7, 7, GAMEPAD_MASK_B1 },
+	{ LAYOUT_SHAPE_ELLIPSE, 80, 41, 7, 7, GAMEPAD_MASK_B2 },
+	{ LAYOUT_SHAPE_ELLIPSE, 97, 41, 7, 7, GAMEPAD_MASK_R2 },
+	{ LAYOUT_SHAPE_ELLIPSE, 114, 45, 7, 7, GAMEPAD_MASK_L2 },
+};
+
+static constexpr LayoutElement layoutVewlix[] =
+{
+	{ LAYOUT_SHAPE_ELLIPSE, 57, 31, 8, 8, GAMEPAD_MASK_B3 },
+	{ LAYOUT_SHAPE_ELLIPSE, 75, 24, 8, 8, GAMEPAD_MASK_B4 },
+	{ LAYOUT_SHAPE_ELLIPSE, 93, 24, 8, 8, GAMEPAD_MASK_R1 },
+	{ LAYOUT_SHAPE_ELLIPSE, 111, 24, 8, 8, GAMEPAD_MASK_L1 },
+	{ LAYOUT_SHAPE_ELLIPSE, 51, 49, 8, 8, GAMEPAD_MASK_B1 },
+	{ LAYOUT_SHAPE_ELLIPSE, 69, 42, 8, 8, GAMEPAD_MASK_B2 },
+	{ LAYOUT_SHAPE_ELLIPSE, 87, 42, 8, 8, GAMEPAD_MASK_R2 },
+	{ LAYOUT_SHAPE_ELLIPSE, 105, 42, 8, 8, GAMEPAD_MASK_L2 },
+};
+
+static constexpr LayoutElement layoutVewlix7[] =
+{
+	{ LAYOUT_SHAPE_ELLIPSE, 57, 31, 8, 8, GAMEPAD_MASK_B3 },
+	{ LAYOUT_SHAPE_ELLIPSE, 75, 24, 8, 8, GAMEPAD_MASK_B4 },
+	{ LAYOUT_SHAPE_ELLIPSE, 93, 24, 8, 8, GAMEPAD_MASK_R1 },
+	{ LAYOUT_SHAPE_ELLIPSE, 111, 24, 8, 8, GAMEPAD_MASK_L1 },
+	{ LAYOUT_SHAPE_ELLIPSE, 51, 49, 8, 8, GAMEPAD_MASK_B1 },
+	{ LAYOUT_SHAPE_ELLIPSE, 69, 42, 8, 8, GAMEPAD_MASK_B2 },
+	{ LAYOUT_SHAPE_ELLIPSE, 87, 42, 8, 8, GAMEPAD_MASK_R2 },
+};
+
+static constexpr LayoutElement layoutCapcom[] =
+{
+	{ LAYOUT_SHAPE_ELLIPSE, 64, 28, 8, 8, GAMEPAD_MASK_B3 },
+	{ LAYOUT_SHAPE_ELLIPSE, 82, 28, 8, 8, GAMEPAD_MASK_B4 },
+	{ LAYOUT_SHAPE_ELLIPSE, 100, 28, 8, 8, GAMEPAD_MASK_R1 },
+	{ LAYOUT_SHAPE_ELLIPSE, 118, 28, 8, 8, GAMEPAD_MASK_L1 },
+	{ LAYOUT_SHAPE_ELLIPSE, 64, 46, 8, 8, GAMEPAD_MASK_B1 },
+	{ LAYOUT_SHAPE_ELLIPSE, 82, 46, 8, 8, GAMEPAD_MASK_B2 },
+	{ LAYOUT_SHAPE_ELLIPSE, 100, 46, 8, 8, GAMEPAD_MASK_R2 },
+	{ LAYOUT_SHAPE_ELLIPSE, 118, 46, 8, 8, GAMEPAD_MASK_L2 },
+};
+
+static constexpr LayoutElement layoutCapcom6[] =
+{
+	{ LAYOUT_SHAPE_ELLIPSE, 74, 28, 8, 8, GAMEPAD_MASK_B3 },
+	{ LAYOUT_SHAPE_ELLIPSE, 92, 28, 8, 8, GAMEPAD_MASK_B4 },
+	{ LAYOUT_SHAPE_ELLIPSE, 110, 28, 8, 8, GAMEPAD_MASK_R1 },
+	{ LAYOUT_SHAPE_ELLIPSE, 74, 46, 8, 8, GAMEPAD_MASK_B1 },
+	{ LAYOUT_SHAPE_ELLIPSE, 92, 46, 8, 8, GAMEPAD_MASK_B2 },
+	{ LAYOUT_SHAPE_ELLIPSE, 110, 46, 8, 8, GAMEPAD_MASK_R2 },
+};
+
+static constexpr LayoutElement layoutSega2P[] =
+{
+	{ LAYOUT_SHAPE_ELLIPSE, 57, 34, 8, 8, GAMEPAD_MASK_B3 },
+	{ LAYOUT_SHAPE_ELLIPSE, 75, 24, 8, 8, GAMEPAD_MASK_B4 },
+	{ LAYOUT_SHAPE_ELLIPSE, 93, 24, 8, 8, GAMEPAD_MASK_R1 },
+	{ LAYOUT_SHAPE_ELLIPSE, 111, 28, 8, 8, GAMEPAD_MASK_L1 },
+	{ LAYOUT_SHAPE_ELLIPSE, 57, 52, 8, 8, GAMEPAD_MASK_B1 },
+	{ LAYOUT_SHAPE_ELLIPSE, 75, 42, 8, 8, GAMEPAD_MASK_B2 },
+	{ LAYOUT_SHAPE_ELLIPSE, 93, 42, 8, 8, GAMEPAD_MASK_R2 },
+	{ LAYOUT_SHAPE_ELLIPSE, 111, 46, 8, 8, GAMEPAD_MASK_L2 },
+};
+
+static constexpr LayoutElement layoutNoir8[] =
+{
+	{ LAYOUT_SHAPE_ELLIPSE, 57, 33, 8, 8, GAMEPAD_MASK_B3 },
+	{ LAYOUT_SHAPE_ELLIPSE, 75, 24, 8, 8, GAMEPAD_MASK_B4 },
+	{ LAYOUT_SHAPE_ELLIPSE, 93, 24, 8, 8, GAMEPAD_MASK_R1 },
+	{ LAYOUT_SHAPE_ELLIPSE, 111, 28, 8, 8, GAMEPAD_MASK_L1 },
+	{ LAYOUT_SHAPE_ELLIPSE, 57, 51, 8, 8, GAMEPAD_MASK_B1 },
+	{ LAYOUT_SHAPE_ELLIPSE, 75, 42, 8, 8, GAMEPAD_MASK_B2 },
+	{ LAYOUT_SHAPE_ELLIPSE, 93, 42, 8, 8, GAMEPAD_MASK_R2 },
+	{ LAYOUT_SHAPE_ELLIPSE, 111, 46, 8, 8, GAMEPAD_MASK_L2 },
+};
+
+static constexpr LayoutElement layoutKeyboardB[] =
+{
+	{ LAYOUT_SHAPE_RECT, 68, 28, 11, 11, GAMEPAD_MASK_B3 },
+	{ LAYOUT_SHAPE_RECT, 79, 28, 11, 11, GAMEPAD_MASK_B4 },
+	{ LAYOUT_SHAPE_RECT, 90, 28, 11, 11, GAMEPAD_MASK_R1 },
+	{ LAYOUT_SHAPE_RECT, 68, 39, 11, 11, GAMEPAD_MASK_B1 },
+	{ LAYOUT_SHAPE_RECT, 79, 39, 11, 11, GAMEPAD_MASK_B2 },
+	{ LAYOUT_SHAPE_RECT, 90, 39, 11, 11, GAMEPAD_MASK_R2 },
+};
+
+static constexpr LayoutElement layoutDancepadB[] =
+{
+	{ LAYOUT_SHAPE_RECT, 39, 12, 16, 16, GAMEPAD_MASK_B2 },
+	{ LAYOUT_SHAPE_RECT, 39, 46, 16, 16, GAMEPAD_MASK_B4 },
+	{ LAYOUT_SHAPE_RECT, 73, 12, 16, 16, GAMEPAD_MASK_B1 },
+	{ LAYOUT_SHAPE_RECT, 73, 46, 16, 16, GAMEPAD_MASK_B3 },
+};
+
+static constexpr LayoutElement layoutTwinstickB[] =
+{
+	{ LAYOUT_SHAPE_STICK, 100, 28, 8, 18, LAYOUT_STICK_MASK(GAMEPAD_MASK_B4, GAMEPAD_MASK_B1, GAMEPAD_MASK_B3, GAMEPAD_MASK_B2) },
+};
+
+// Indexed by ButtonLayout, BUTTON_LAYOUT_CUSTOMA is the uploaded layout and has no table
+static constexpr LayoutTable layoutsLeft[] =
+{
+	LAYOUT_TABLE(layoutStick),
+	LAYOUT_TABLE(layoutStickless),
+	LAYOUT_TABLE(layoutButtonsAngled),
+	LAYOUT_TABLE(layoutButtonsBasic),
+	LAYOUT_TABLE(layoutKeyboardAngled),
+	LAYOUT_TABLE(layoutKeyboardA),
+	LAYOUT_TABLE(layoutDancepadA),
+	LAYOUT_TABLE(layoutTwinstickA),
+	{ nullptr, 0 },
+};
+
+// Indexed by ButtonLayoutRight
+static constexpr LayoutTable layoutsRight[] =
+{
+	LAYOUT_TABLE(layoutArcade),
+	LAYOUT_TABLE(layoutSticklessB),
+	LAYOUT_TABLE(layoutButtonsAngledB),
+	LAYOUT_TABLE(layoutVewlix),
+	LAYOUT_TABLE(layoutVewlix7),
+	LAYOUT_TABLE(layoutCapcom),
+	LAYOUT_TABLE(layoutCapcom6),
+	LAYOUT_TABLE(layoutSega2P),
+	LAYOUT_TABLE(layoutNoir8),
+	LAYOUT_TABLE(layoutKeyboardB),
+	LAYOUT_TABLE(layoutDancepadB),
+	LAYOUT_TABLE(layoutTwinstickB),
+	{ nullptr, 0 },
+};
+
+static_assert(sizeof(layoutsLeft) / sizeof(*layoutsLeft) == BUTTON_LAYOUT_CUSTOMA, "Every built-in left layout needs a table");
+static_assert(sizeof(layoutsRight) / sizeof(*layoutsRight) == BUTTON_LAYOUT_BLANKB + 1, "Every right layout needs a table");
+
+#endif
@@ -12,6 +12,7 @@ typedef enum
 	BUTTON_LAYOUT_DANCEPADA,
 	BUTTON_LAYOUT_TWINSTICKA,
 	BUTTON_LAYOUT_BLANKA,
+	BUTTON_LAYOUT_CUSTOMA, // Display layout uploaded through the web config
 } ButtonLayout;
 
 typedef enum
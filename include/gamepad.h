@@ -70,4 +70,14 @@ public:
 	GamepadButtonMapping **gamepadMappings;
 };
 
+// Report packers, one per input mode so the mode is only resolved once at startup
+typedef void *(*ReportPacker)(Gamepad *gamepad);
+
+template<InputMode mode> void *packReport(Gamepad *gamepad);
+template<> inline void *packReport<INPUT_MODE_HID>(Gamepad *gamepad)    { return gamepad->getHIDReport(); }
+template<> inline void *packReport<INPUT_MODE_SWITCH>(Gamepad *gamepad) { return gamepad->getSwitchReport(); }
+template<> inline void *packReport<INPUT_MODE_XINPUT>(Gamepad *gamepad) { return gamepad->getXInputReport(); }
+
+ReportPacker getReportPacker(InputMode mode);
+
 #endif
@@ -9,6 +9,8 @@
 // GP2040 Classes
 #include "gamepad.h"
 #include "addonmanager.h"
+#include "messagebus.h"
+#include "usb_driver.h"
 
 class GP2040 {
 public:
@@ -17,9 +19,30 @@ public:
     void setup();           // setup core0
     void run();             // loop core0
 private:
+    void processLEDHotkeys(Gamepad * gamepad);
+    void processHUDHotkey(Gamepad * gamepad);
+    void updateStats(ReportResult result, uint32_t readTime);
+    void processOutReports();
+    void decodeOutReport(const uint8_t * report, uint32_t timestamp);
     uint64_t nextRuntime;
     Gamepad snapshot;
     AddonManager addons;
+    ReportPacker packReport = nullptr;                     // Selected once for the USB input mode
+    Message hostEvent = { };                               // Decoded host OUT report waiting for Core1
+    bool ledHotkeys = false;
+    AnimationHotkey lastHotkey = HOTKEY_LEDS_NONE;
+    uint32_t nextHotkeyRepeat = 0;
+    bool hudHotkey = false;
+    bool displayMenu = false;
+    bool displayPending = false;                           // Display configured, the menu and HUD wait for Core1 to load it
+    bool hudHotkeyHeld = false;
+    Core0Stats stats = { };                                // Published to Core1 once per window
+    LatencyHistogram latency;
+    uint32_t windowStart = 0;
+    uint32_t windowLoops = 0;
+    uint32_t windowReports = 0;                            // Reports sent before this window started
+    uint32_t changeTime = 0;                               // Read time of the oldest change the host hasn't seen
+    bool changePending = false;
 };
 
 #endif
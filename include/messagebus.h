@@ -0,0 +1,226 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: Copyright (c) 2021 Jason Skuby (mytechtoybox.com)
+ */
+
+#ifndef MESSAGEBUS_H_
+#define MESSAGEBUS_H_
+
+#include <stdint.h>
+#include <string.h>
+#include "hardware/sync.h"
+
+#include "gamepad.h"
+#include "AnimationStation.hpp"
+#include "PlayerLEDs.h"
+#include "perfcounters.h"
+#include "configs/displayconfig.h"
+
+/* The SIO inter-core FIFOs are owned by multicore_lockout (used for flash writes), so the bus
+	is built on shared SRAM instead: one single-producer/single-consumer queue per destination
+	core for events, plus a sequence-locked mailbox for the latest input frame. */
+
+#define MESSAGE_QUEUE_SIZE   16 // Messages waiting per core, must be a power of 2
+#define MESSAGE_MAX_HANDLERS 8  // Subscriptions per core
+#define MESSAGE_CORE_COUNT   2
+
+typedef enum
+{
+	MESSAGE_NONE = 0,
+	MESSAGE_PLAYER_LEDS,    // core0 -> core1 : player LED pattern from the host
+	MESSAGE_RUMBLE,         // core0 -> core1 : rumble levels from the host
+	MESSAGE_HOTKEY,         // core0 -> core1 : LED hotkey action
+	MESSAGE_CONFIG_CHANGED, // any -> any     : one or more storage blocks were changed
+	MESSAGE_FLASH_COMMIT,   // core1 -> core0 : commit storage, core0 owns the flash lockout
+	MESSAGE_PERF_HUD,       // core0 -> core1 : toggle the performance page on the display
+	MESSAGE_ANIMATION_OPTIONS, // core0 -> core1 : new animation options, core1 applies and stores them
+} MessageType;
+
+typedef enum
+{
+	CONFIG_BLOCK_GAMEPAD     = (1 << 0),
+	CONFIG_BLOCK_BOARD       = (1 << 1),
+	CONFIG_BLOCK_LED         = (1 << 2),
+	CONFIG_BLOCK_ANIMATION   = (1 << 3),
+	CONFIG_BLOCK_LED_PROGRAM = (1 << 4),
+	CONFIG_BLOCK_DISPLAY_LAYOUT = (1 << 5),
+} ConfigBlock;
+
+// Decoded host OUT reports, plain structs so they can live in the payload union
+struct PlayerLEDEvent
+{
+	uint8_t state;
+	PLEDAnimationType animation;
+	PLEDAnimationSpeed speed;
+};
+
+struct RumbleEvent
+{
+	uint8_t left;  // Low frequency motor
+	uint8_t right; // High frequency motor
+};
+
+struct Message
+{
+	MessageType type;
+	uint32_t timestamp; // Microseconds since boot, set when posted unless the sender already did
+	union
+	{
+		PlayerLEDEvent playerLEDs;
+		RumbleEvent rumble;
+		AnimationHotkey hotkey;
+		AnimationOptions animationOptions;
+		uint32_t configBlocks;
+	};
+};
+
+// Latest processed input, published by core0 every poll
+struct InputFrame
+{
+	GamepadState state;
+	uint32_t timestamp;
+};
+
+struct MessageQueueStats
+{
+	uint32_t posted;
+	uint32_t dropped;   // Rejected because the queue was full (back-pressure)
+	uint16_t highWater; // Most messages waiting at once
+};
+
+typedef void (*MessageHandler)(const Message &message, void *context);
+
+// Lock-free ring, only one core may push and only one core may pop
+template<typename T, uint16_t N>
+class MessageQueue
+{
+public:
+	bool push(const T &item)
+	{
+		uint16_t head = this->head;
+		uint16_t waiting = (head - tail) & (N - 1);
+		if (waiting == (N - 1))
+		{
+			stats.dropped++;
+			return false;
+		}
+
+		buffer[head] = item;
+		__dmb(); // Payload must land before the consumer sees the new head
+		this->head = (head + 1) & (N - 1);
+
+		stats.posted++;
+		if (waiting + 1 > stats.highWater)
+			stats.highWater = waiting + 1;
+
+		return true;
+	}
+
+	bool pop(T &item)
+	{
+		uint16_t tail = this->tail;
+		if (tail == head)
+			return false;
+
+		__dmb();
+		item = buffer[tail];
+		__dmb(); // Finish reading before handing the slot back to the producer
+		this->tail = (tail + 1) & (N - 1);
+		return true;
+	}
+
+	inline bool empty() const { return head == tail; }
+	inline MessageQueueStats getStats() const { return stats; }
+
+private:
+	static_assert((N & (N - 1)) == 0, "MessageQueue size must be a power of 2");
+	T buffer[N];
+	volatile uint16_t head = 0;
+	volatile uint16_t tail = 0;
+	MessageQueueStats stats = { };
+};
+
+// Single-writer latest-value slot, readers retry if they overlap a write
+template<typename T>
+class Mailbox
+{
+public:
+	void write(const T &value)
+	{
+		sequence = sequence + 1; // Odd while writing
+		__dmb();
+		data = value;
+		__dmb();
+		sequence = sequence + 1;
+	}
+
+	// Returns false if nothing was written since the last read
+	bool read(T &value)
+	{
+		uint32_t start;
+		do
+		{
+			start = sequence;
+			__dmb();
+			value = data;
+			__dmb();
+		} while ((start & 1) || start != sequence);
+
+		bool updated = (start != lastRead);
+		lastRead = start;
+		return updated;
+	}
+
+private:
+	T data;
+	volatile uint32_t sequence = 0;
+	uint32_t lastRead = 0;
+};
+
+// Message bus for core0 <-> core1 communication
+class MessageBus {
+public:
+	MessageBus(MessageBus const&) = delete;
+	void operator=(MessageBus const&)  = delete;
+	static MessageBus& getInstance() // Must be created on core0 before core1 is launched
+	{
+		static MessageBus instance;
+		return instance;
+	}
+
+	bool post(uint8_t core, Message &message);          // Queue for the given core, false if the queue is full
+	bool post(uint8_t core, MessageType type);          // Messages without a payload
+	bool subscribe(MessageType type, MessageHandler handler, void *context = nullptr); // Handler runs on the calling core
+	bool hasSubscriber(uint8_t core, MessageType type); // Lets senders skip messages nobody on that core would read
+	uint16_t dispatch();                                // Deliver everything waiting for the calling core
+
+	void publishInput(GamepadState &state);             // core0 : latest processed input
+	bool readInput(GamepadState &state);                // core1 : false if unchanged since last read
+
+	void publishStats(const Core0Stats &stats);         // core0 : once per PERF_WINDOW_US
+	bool readStats(Core0Stats &stats);                  // core1 : false if unchanged since last read
+
+	void publishMenu(const DisplayMenuState &state);    // core0 : display menu, whenever it changes
+	bool readMenu(DisplayMenuState &state);             // core1 : false if unchanged since last read
+
+	MessageQueueStats getStats(uint8_t core);
+
+private:
+	MessageBus() {}
+
+	struct Subscription
+	{
+		MessageType type;
+		MessageHandler handler;
+		void *context;
+	};
+
+	MessageQueue<Message, MESSAGE_QUEUE_SIZE> inbox[MESSAGE_CORE_COUNT];
+	Subscription subscriptions[MESSAGE_CORE_COUNT][MESSAGE_MAX_HANDLERS];
+	volatile uint8_t subscriptionCount[MESSAGE_CORE_COUNT] = { };
+	Mailbox<InputFrame> inputFrame;
+	Mailbox<Core0Stats> core0Stats;
+	Mailbox<DisplayMenuState> displayMenu;
+};
+
+#endif
@@ -0,0 +1,74 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: Copyright (c) 2021 Jason Skuby (mytechtoybox.com)
+ */
+
+#ifndef PERFCOUNTERS_H_
+#define PERFCOUNTERS_H_
+
+#include <stdint.h>
+#include <string.h>
+
+#define PERF_WINDOW_US         1000000 // Rates and percentiles are measured over one second
+#define PERF_LATENCY_BUCKET_US 50      // Histogram resolution
+#define PERF_LATENCY_BUCKETS   64      // The last bucket also holds everything slower
+
+// Core0 health, published once per window so the loop only ever bumps counters
+struct Core0Stats
+{
+	uint32_t loopRate;       // Gamepad polls per second
+	uint32_t reportRate;     // Reports the USB stack accepted per second
+	uint32_t dropped;        // Input transitions the host never saw, since boot
+	uint32_t latencyP99;     // Microseconds from reading a change to its report being accepted
+	uint32_t latencyMax;
+	uint32_t flashCommits;   // Flash commits since boot
+	uint32_t flashStall;     // Microseconds the longest commit held off both cores
+};
+
+// Fixed buckets, recording is a divide and an increment
+class LatencyHistogram
+{
+public:
+	void record(uint32_t us)
+	{
+		uint32_t bucket = us / PERF_LATENCY_BUCKET_US;
+		buckets[(bucket < PERF_LATENCY_BUCKETS) ? bucket : (PERF_LATENCY_BUCKETS - 1)]++;
+		count++;
+		if (us > max)
+			max = us;
+	}
+
+	// Upper edge of the bucket holding the percentile, 0 if nothing was recorded
+	uint32_t percentile(uint8_t pct) const
+	{
+		if (count == 0)
+			return 0;
+
+		uint32_t target = ((uint64_t)count * pct + 99) / 100;
+		uint32_t seen = 0;
+		for (uint16_t i = 0; i < PERF_LATENCY_BUCKETS - 1; i++)
+		{
+			seen += buckets[i];
+			if (seen >= target)
+				return (i + 1) * PERF_LATENCY_BUCKET_US;
+		}
+
+		return max;
+	}
+
+	uint32_t getMax() const { return max; }
+
+	void reset()
+	{
+		memset(buckets, 0, sizeof(buckets));
+		count = 0;
+		max = 0;
+	}
+
+private:
+	uint32_t buckets[PERF_LATENCY_BUCKETS] = { };
+	uint32_t count = 0;
+	uint32_t max = 0;
+};
+
+#endif
@@ -0,0 +1,72 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: Copyright (c) 2021 Jason Skuby (mytechtoybox.com)
+ */
+
+#ifndef RLEBITMAP_H_
+#define RLEBITMAP_H_
+
+#include <stdint.h>
+
+// Control byte of the encoding written by tools/compress-bitmaps.py, the low 6 bits are the count
+#define RLE_CODE_MASK   0xC0
+#define RLE_COUNT_MASK  0x3F
+#define RLE_LITERAL     0x00 // count + 1 bytes follow as is
+#define RLE_ZEROS       0x40 // count + 1 bytes of 0x00
+#define RLE_ONES        0x80 // count + 1 bytes of 0xFF
+#define RLE_REPEAT      0xC0 // count + 3 copies of the byte that follows
+
+// 1-bit image in display page order (a byte per column holding 8 rows, top row in bit 0), run-length encoded
+struct RLEBitmap
+{
+	uint16_t width;
+	uint16_t height;
+	uint16_t size; // Encoded bytes, 0 for an empty image
+	const uint8_t *data;
+};
+
+// Hands out the decoded bytes in order, nothing is ever decoded ahead
+class RLEBitmapDecoder
+{
+public:
+	RLEBitmapDecoder(const RLEBitmap &bitmap) : src(bitmap.data), end(bitmap.data + bitmap.size) { }
+
+	uint8_t next()
+	{
+		if (remaining == 0 && !load())
+			return 0;
+
+		remaining--;
+		return literal ? *src++ : value;
+	}
+
+	// Whole runs are stepped over, so skipping to a page doesn't cost a byte at a time
+	void skip(uint32_t count)
+	{
+		while (count > 0)
+		{
+			if (remaining == 0 && !load())
+				return;
+
+			uint32_t step = (count < remaining) ? count : remaining;
+			if (literal)
+				src += step;
+			remaining -= step;
+			count -= step;
+		}
+	}
+
+private:
+	bool load();
+
+	const uint8_t *src;
+	const uint8_t *end;
+	uint16_t remaining = 0;
+	uint8_t value = 0;
+	bool literal = false;
+};
+
+// ORs the bitmap into a page-ordered buffer with its top left corner at x, y, only touching pages firstPage to lastPage
+void drawRLEBitmap(uint8_t *buffer, int bufferWidth, int bufferPages, const RLEBitmap &bitmap, int x, int y, int firstPage, int lastPage);
+
+#endif
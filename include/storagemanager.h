@@ -8,19 +8,24 @@
 
 #include <stdint.h>
 #include "NeoPico.hpp"
+#include "LEDProgram.hpp"
 #include "FlashPROM.h"
 
 #include "enums.h"
 #include "helper.h"
 #include "gamepad.h"
+#include "displaylayouts.h"
 
 #define GAMEPAD_STORAGE_INDEX      0 // 1024 bytes for gamepad options
 #define BOARD_STORAGE_INDEX     1024 //  512 bytes for hardware options
 #define LED_STORAGE_INDEX       1536 //  512 bytes for LED configuration
-#define ANIMATION_STORAGE_INDEX 2048 // ???? bytes for LED animations
+#define ANIMATION_STORAGE_INDEX 2048 //  512 bytes for LED animations
+#define LED_PROGRAM_STORAGE_INDEX 2560 // 1024 bytes for the custom LED program
+#define DISPLAY_LAYOUT_STORAGE_INDEX 3584 // Rest of the EEPROM for the custom display layout
 
 #define CHECKSUM_MAGIC          0 	// Checksum CRC
 
+// Options saved by older firmware are migrated in initBoardOptions, only data matching no known layout is reset
 struct BoardOptions
 {
 	bool hasBoardOptions;
@@ -47,6 +52,7 @@ struct BoardOptions
 	uint8_t pinSliderLS;
 	uint8_t pinSliderRS;
 	ButtonLayout buttonLayout;
+	ButtonLayoutRight buttonLayoutRight;
 	int i2cSDAPin;
 	int i2cSCLPin;
 	int i2cBlock;
@@ -72,6 +78,18 @@ struct BoardOptions
 	uint32_t checksum;
 };
 
+#define LED_MAX_CHAINS 4 // One PIO state machine per chain
+#define LED_MAX_CHAIN_LEDS 256 // Across all chains, each LED costs 12 bytes of frame and DMA buffers
+
+// A chain drives the next ledCount entries of the LED frame
+struct LEDChain
+{
+	int dataPin;
+	LEDFormat ledFormat;
+	uint16_t ledCount;
+};
+
+// Fields are only ever added before boardVersion, older layouts are migrated in initLEDOptions
 struct LEDOptions
 {
 	bool useUserDefinedLEDs;
@@ -99,10 +117,32 @@ struct LEDOptions
 	int indexR3;
 	int indexA1;
 	int indexA2;
+	uint8_t chainCount;               // 0 uses a single chain on dataPin
+	LEDChain chains[LED_MAX_CHAINS];
+	uint8_t frameRate;                // LED frames per second, 0 uses LED_FRAME_RATE
 	char boardVersion[32]; // 32-char limit to board name
 	uint32_t checksum;
 };
 
+// Brings pins, formats and LED counts back in range, true if anything had to change
+bool clampLEDOptions(LEDOptions &options);
+
+// Bytecode for EFFECT_CUSTOM, checked with LEDProgram::Validate before it's stored
+struct LEDProgramOptions
+{
+	uint16_t size;                      // 0 if no program is stored
+	uint8_t code[LED_PROGRAM_MAX_SIZE];
+	uint32_t checksum;
+};
+
+// Elements for BUTTON_LAYOUT_CUSTOMA, stored as uploaded
+struct DisplayLayoutOptions
+{
+	uint8_t count;                      // 0 if no layout is stored
+	LayoutElement elements[DISPLAY_LAYOUT_MAX_ELEMENTS];
+	uint32_t checksum;
+};
+
 #define SI Storage::getInstance()
 
 // Storage manager for board, LED options, and thread-safe settings
@@ -124,6 +164,12 @@ public:
 	void setDefaultLEDOptions();
 	LEDOptions getLEDOptions();
 
+	void setLEDProgram(const uint8_t *code, uint16_t size); // LED Program
+	uint16_t getLEDProgram(uint8_t *code);                   // Copies out the stored program, returns its size
+
+	void setDisplayLayout(const LayoutElement *elements, uint8_t count); // Display Layout
+	uint8_t getDisplayLayout(LayoutElement *elements);                   // Copies out the stored layout, returns its element count
+
 	void SetConfigMode(bool); 			// Config Mode (on-boot)
 	bool GetConfigMode();
 
@@ -133,9 +179,6 @@ public:
 	void SetProcessedGamepad(Gamepad *); // MPGS Processed Gamepad Get/Set
 	Gamepad * GetProcessedGamepad();
 
-	void SetFeatureData(uint8_t *); 	// USB Feature Data Get/Set
-	void ClearFeatureData();
-	uint8_t * GetFeatureData();
 
 	void ResetSettings(); 				// EEPROM Reset Feature
 
@@ -146,13 +189,14 @@ private:
 		initLEDOptions();
 	}
 	void initBoardOptions();
+	bool migrateBoardOptions();
 	void initLEDOptions();
+	bool migrateLEDOptions();
 	bool CONFIG_MODE; 			// Config mode (boot)
 	Gamepad * gamepad;    		// Gamepad data
 	Gamepad * processedGamepad; // Gamepad with ONLY processed data
 	BoardOptions boardOptions;
 	LEDOptions ledOptions;
-	uint8_t featureData[32]; // USB X-Input Feature Data
 };
 
 #endif
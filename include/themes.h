@@ -14,7 +14,7 @@
 
 using namespace std;
 
-static map<uint32_t, RGB> themeStaticRainbow({
+static constexpr StaticThemeTable themeStaticRainbow = makeStaticTheme({
 	{ GAMEPAD_MASK_DL, ColorRed },
 	{ GAMEPAD_MASK_DD, ColorOrange },
 	{ GAMEPAD_MASK_DR, ColorYellow },
@@ -29,7 +29,23 @@ static map<uint32_t, RGB> themeStaticRainbow({
 	{ GAMEPAD_MASK_L2, ColorMagenta },
 });
 
-static map<uint32_t, RGB> themeGuiltyGearTypeA({
+// Rainbow theme on a Hitbox layout should use green for up button
+static constexpr StaticThemeTable themeStaticRainbowStickless = makeStaticTheme({
+	{ GAMEPAD_MASK_DL, ColorRed },
+	{ GAMEPAD_MASK_DD, ColorOrange },
+	{ GAMEPAD_MASK_DR, ColorYellow },
+	{ GAMEPAD_MASK_DU, ColorGreen },
+	{ GAMEPAD_MASK_B3, ColorGreen },
+	{ GAMEPAD_MASK_B1, ColorGreen },
+	{ GAMEPAD_MASK_B4, ColorAqua },
+	{ GAMEPAD_MASK_B2, ColorAqua },
+	{ GAMEPAD_MASK_R1, ColorBlue },
+	{ GAMEPAD_MASK_R2, ColorBlue },
+	{ GAMEPAD_MASK_L1, ColorMagenta },
+	{ GAMEPAD_MASK_L2, ColorMagenta },
+});
+
+static constexpr StaticThemeTable themeGuiltyGearTypeA = makeStaticTheme({
 	{ GAMEPAD_MASK_DU, ColorWhite },
 	{ GAMEPAD_MASK_DD, ColorWhite },
 	{ GAMEPAD_MASK_DL, ColorWhite },
@@ -41,7 +57,7 @@ static map<uint32_t, RGB> themeGuiltyGearTypeA({
 	{ GAMEPAD_MASK_R2, ColorOrange },
 });
 
-static map<uint32_t, RGB> themeGuiltyGearTypeB({
+static constexpr StaticThemeTable themeGuiltyGearTypeB = makeStaticTheme({
 	{ GAMEPAD_MASK_DU, ColorWhite },
 	{ GAMEPAD_MASK_DD, ColorWhite },
 	{ GAMEPAD_MASK_DL, ColorWhite },
@@ -53,7 +69,7 @@ static map<uint32_t, RGB> themeGuiltyGearTypeB({
 	{ GAMEPAD_MASK_R2, ColorOrange },
 });
 
-static map<uint32_t, RGB> themeGuiltyGearTypeC({
+static constexpr StaticThemeTable themeGuiltyGearTypeC = makeStaticTheme({
 	{ GAMEPAD_MASK_DU, ColorWhite },
 	{ GAMEPAD_MASK_DD, ColorWhite },
 	{ GAMEPAD_MASK_DL, ColorWhite },
@@ -65,7 +81,7 @@ static map<uint32_t, RGB> themeGuiltyGearTypeC({
 	{ GAMEPAD_MASK_R2, ColorRed },
 });
 
-static map<uint32_t, RGB> themeGuiltyGearTypeD({
+static constexpr StaticThemeTable themeGuiltyGearTypeD = makeStaticTheme({
 	{ GAMEPAD_MASK_DU, ColorWhite },
 	{ GAMEPAD_MASK_DD, ColorWhite },
 	{ GAMEPAD_MASK_DL, ColorWhite },
@@ -77,7 +93,7 @@ static map<uint32_t, RGB> themeGuiltyGearTypeD({
 	{ GAMEPAD_MASK_R1, ColorOrange },
 });
 
-static map<uint32_t, RGB> themeGuiltyGearTypeE({
+static constexpr StaticThemeTable themeGuiltyGearTypeE = makeStaticTheme({
 	{ GAMEPAD_MASK_DU, ColorWhite },
 	{ GAMEPAD_MASK_DD, ColorWhite },
 	{ GAMEPAD_MASK_DL, ColorWhite },
@@ -89,7 +105,7 @@ static map<uint32_t, RGB> themeGuiltyGearTypeE({
 	{ GAMEPAD_MASK_R1, ColorOrange },
 });
 
-static map<uint32_t, RGB> themeNeoGeo({
+static constexpr StaticThemeTable themeNeoGeo = makeStaticTheme({
 	{ GAMEPAD_MASK_DU, ColorWhite },
 	{ GAMEPAD_MASK_DD, ColorWhite },
 	{ GAMEPAD_MASK_DL, ColorWhite },
@@ -100,7 +116,7 @@ static map<uint32_t, RGB> themeNeoGeo({
 	{ GAMEPAD_MASK_L1, ColorBlue },
 });
 
-static map<uint32_t, RGB> themeNeoGeoCurved({
+static constexpr StaticThemeTable themeNeoGeoCurved = makeStaticTheme({
 	{ GAMEPAD_MASK_DU, ColorWhite },
 	{ GAMEPAD_MASK_DD, ColorWhite },
 	{ GAMEPAD_MASK_DL, ColorWhite },
@@ -111,7 +127,7 @@ static map<uint32_t, RGB> themeNeoGeoCurved({
 	{ GAMEPAD_MASK_R1, ColorBlue },
 });
 
-static map<uint32_t, RGB> themeNeoGeoModern({
+static constexpr StaticThemeTable themeNeoGeoModern = makeStaticTheme({
 	{ GAMEPAD_MASK_DU, ColorWhite },
 	{ GAMEPAD_MASK_DD, ColorWhite },
 	{ GAMEPAD_MASK_DL, ColorWhite },
@@ -122,7 +138,7 @@ static map<uint32_t, RGB> themeNeoGeoModern({
 	{ GAMEPAD_MASK_B2, ColorBlue },
 });
 
-static map<uint32_t, RGB> themeSixButtonFighter({
+static constexpr StaticThemeTable themeSixButtonFighter = makeStaticTheme({
 	{ GAMEPAD_MASK_DU, ColorWhite },
 	{ GAMEPAD_MASK_DD, ColorWhite },
 	{ GAMEPAD_MASK_DL, ColorWhite },
@@ -135,7 +151,7 @@ static map<uint32_t, RGB> themeSixButtonFighter({
 	{ GAMEPAD_MASK_R2, ColorRed },
 });
 
-static map<uint32_t, RGB> themeSixButtonFighterPlus({
+static constexpr StaticThemeTable themeSixButtonFighterPlus = makeStaticTheme({
 	{ GAMEPAD_MASK_DU, ColorWhite },
 	{ GAMEPAD_MASK_DD, ColorWhite },
 	{ GAMEPAD_MASK_DL, ColorWhite },
@@ -150,7 +166,7 @@ static map<uint32_t, RGB> themeSixButtonFighterPlus({
 	{ GAMEPAD_MASK_L2, ColorGreen },
 });
 
-static map<uint32_t, RGB> themeStreetFighter2({
+static constexpr StaticThemeTable themeStreetFighter2 = makeStaticTheme({
 	{ GAMEPAD_MASK_DU, ColorWhite },
 	{ GAMEPAD_MASK_DD, ColorWhite },
 	{ GAMEPAD_MASK_DL, ColorWhite },
@@ -165,7 +181,7 @@ static map<uint32_t, RGB> themeStreetFighter2({
 	{ GAMEPAD_MASK_L2, ColorBlack },
 });
 
-static map<uint32_t, RGB> themeTekken({
+static constexpr StaticThemeTable themeTekken = makeStaticTheme({
 	{ GAMEPAD_MASK_DL, ColorWhite },
 	{ GAMEPAD_MASK_DD, ColorWhite },
 	{ GAMEPAD_MASK_DR, ColorWhite },
@@ -177,7 +193,7 @@ static map<uint32_t, RGB> themeTekken({
 	{ GAMEPAD_MASK_R1, ColorRed },
 });
 
-static map<uint32_t, RGB> themePlayStation({
+static constexpr StaticThemeTable themePlayStation = makeStaticTheme({
 	{ GAMEPAD_MASK_DU, ColorWhite },
 	{ GAMEPAD_MASK_DD, ColorWhite },
 	{ GAMEPAD_MASK_DL, ColorWhite },
@@ -192,7 +208,7 @@ static map<uint32_t, RGB> themePlayStation({
 	{ GAMEPAD_MASK_L2, ColorBlack },
 });
 
-static map<uint32_t, RGB> themePlayStationAll({
+static constexpr StaticThemeTable themePlayStationAll = makeStaticTheme({
 	{ GAMEPAD_MASK_DU, ColorWhite },
 	{ GAMEPAD_MASK_DD, ColorWhite },
 	{ GAMEPAD_MASK_DL, ColorWhite },
@@ -207,7 +223,7 @@ static map<uint32_t, RGB> themePlayStationAll({
 	{ GAMEPAD_MASK_L2, ColorWhite },
 });
 
-static map<uint32_t, RGB> themeSuperFamicom({
+static constexpr StaticThemeTable themeSuperFamicom = makeStaticTheme({
 	{ GAMEPAD_MASK_DU, ColorWhite },
 	{ GAMEPAD_MASK_DD, ColorWhite },
 	{ GAMEPAD_MASK_DL, ColorWhite },
@@ -222,7 +238,7 @@ static map<uint32_t, RGB> themeSuperFamicom({
 	{ GAMEPAD_MASK_L2, ColorBlack },
 });
 
-static map<uint32_t, RGB> themeSuperFamicomAll({
+static constexpr StaticThemeTable themeSuperFamicomAll = makeStaticTheme({
 	{ GAMEPAD_MASK_DU, ColorWhite },
 	{ GAMEPAD_MASK_DD, ColorWhite },
 	{ GAMEPAD_MASK_DL, ColorWhite },
@@ -237,7 +253,7 @@ static map<uint32_t, RGB> themeSuperFamicomAll({
 	{ GAMEPAD_MASK_L2, ColorWhite },
 });
 
-static map<uint32_t, RGB> themeXbox({
+static constexpr StaticThemeTable themeXbox = makeStaticTheme({
 	{ GAMEPAD_MASK_DU, ColorWhite },
 	{ GAMEPAD_MASK_DD, ColorWhite },
 	{ GAMEPAD_MASK_DL, ColorWhite },
@@ -252,7 +268,7 @@ static map<uint32_t, RGB> themeXbox({
 	{ GAMEPAD_MASK_L2, ColorBlack },
 });
 
-static map<uint32_t, RGB> themeXboxAll({
+static constexpr StaticThemeTable themeXboxAll = makeStaticTheme({
 	{ GAMEPAD_MASK_DU, ColorWhite },
 	{ GAMEPAD_MASK_DD, ColorWhite },
 	{ GAMEPAD_MASK_DL, ColorWhite },
@@ -269,12 +285,9 @@ static map<uint32_t, RGB> themeXboxAll({
 
 void addStaticThemes(LEDOptions options)
 {
-	// Rainbow theme on a Hitbox layout should use green for up button
-	themeStaticRainbow[GAMEPAD_MASK_DU] = (options.ledLayout == BUTTON_LAYOUT_STICKLESS) ? ColorGreen : ColorOrange;
-
 	StaticTheme::ClearThemes();
 
-	StaticTheme::AddTheme(themeStaticRainbow);
+	StaticTheme::AddTheme((options.ledLayout == BUTTON_LAYOUT_STICKLESS) ? themeStaticRainbowStickless : themeStaticRainbow);
 
 	StaticTheme::AddTheme(themeXbox);
 	StaticTheme::AddTheme(themeXboxAll);
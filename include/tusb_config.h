@@ -95,7 +95,7 @@
 #endif
 
 //------------- CLASS -------------//
-#define CFG_TUD_CDC               0
+#define CFG_TUD_CDC               1
 #define CFG_TUD_MSC               0
 #define CFG_TUD_HID               2
 #define CFG_TUD_MIDI              0
@@ -105,6 +105,11 @@
 // HID buffer size Should be sufficient to hold ID (if any) + Data
 #define CFG_TUD_HID_EP_BUFSIZE    64
 
+// CDC FIFOs only need to hold a few serial config frames
+#define CFG_TUD_CDC_RX_BUFSIZE    256
+#define CFG_TUD_CDC_TX_BUFSIZE    256
+#define CFG_TUD_CDC_EP_BUFSIZE    64
+
 #ifdef __cplusplus
  }
 #endif
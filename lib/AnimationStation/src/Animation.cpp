@@ -1,30 +1,21 @@
 #include "Animation.hpp"
+#include "Compositor.hpp"
+#include <algorithm>
 
 LEDFormat Animation::format;
 
 Animation::Animation(PixelMatrix &matrix) : matrix(&matrix) {
 }
 
-void Animation::UpdatePixels(std::vector<Pixel> pixels) {
-  this->pixels = pixels;
-}
-
-void Animation::ClearPixels() {
-  this->pixels.clear();
-}
+void Animation::Render(Layer &layer, uint32_t timeMs) {
+  this->Animate(layer.pixels.data(), timeMs);
+  if (!this->filtered)
+    return;
 
-/* Some of these animations are filtered to specific pixels, such as button press animations.
-This somewhat backwards named method determines if a specific pixel is _not_ included in the filter */
-bool Animation::notInFilter(Pixel pixel) {
-  if (!this->filtered) {
-    return false;
+  // Only the LEDs of held buttons cover the layers below
+  std::fill(layer.alpha.begin(), layer.alpha.end(), 0);
+  for (uint16_t i = 0; i < matrix->size(); i++) {
+    if (matrix->masks[i] & this->pressedMask)
+      matrix->fill<uint8_t>(i, layer.alpha.data(), 255);
   }
-
-  for (size_t i = 0; i < this->pixels.size(); i++) {
-    if (pixel == this->pixels.at(i)) {
-      return false;
-    }
-  }
-
-  return true;
 }
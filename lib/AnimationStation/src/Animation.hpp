@@ -9,11 +9,11 @@
 #include "NeoPico.hpp"
 
 struct RGB {
-  RGB() : r(0), g(0), b(0) {}
+  constexpr RGB() : r(0), g(0), b(0), w(0) {}
 
-  RGB(uint8_t r, uint8_t g, uint8_t b) : r(r), g(g), b(b), w(0) {}
+  constexpr RGB(uint8_t r, uint8_t g, uint8_t b) : r(r), g(g), b(b), w(0) {}
 
-  RGB(uint8_t r, uint8_t g, uint8_t b, uint8_t w)
+  constexpr RGB(uint8_t r, uint8_t g, uint8_t b, uint8_t w)
     : r(r), g(g), b(b), w(w) { }
 
   uint8_t r;
@@ -34,6 +34,9 @@ struct RGB {
     }
   }
 
+  // All four channels unscaled, for comparing and hashing colors
+  inline uint32_t raw() const { return ((uint32_t)r << 24) | ((uint32_t)g << 16) | ((uint32_t)b << 8) | w; }
+
   inline uint32_t value(LEDFormat format, float brightnessX = 1.0F) {
     switch (format) {
       case LED_FORMAT_GRB:
@@ -71,46 +74,103 @@ struct RGB {
   }
 };
 
-static const RGB ColorBlack(0, 0, 0);
-static const RGB ColorWhite(255, 255, 255);
-static const RGB ColorRed(255, 0, 0);
-static const RGB ColorOrange(255, 128, 0);
-static const RGB ColorYellow(255, 255, 0);
-static const RGB ColorLimeGreen(128, 255, 0);
-static const RGB ColorGreen(0, 255, 0);
-static const RGB ColorSeafoam(0, 255, 128);
-static const RGB ColorAqua(0, 255, 255);
-static const RGB ColorSkyBlue(0, 128, 255);
-static const RGB ColorBlue(0, 0, 255);
-static const RGB ColorPurple(128, 0, 255);
-static const RGB ColorPink(255, 0, 255);
-static const RGB ColorMagenta(255, 0, 128);
+/* Integer packers, one per format. The lookup table applies brightness (and gamma), so a
+   pixel costs three or four table reads and some shifts. */
+typedef uint32_t (*PixelPacker)(const RGB &color, const uint8_t *lut);
+
+template<LEDFormat format> uint32_t packPixel(const RGB &color, const uint8_t *lut);
+
+template<> inline uint32_t packPixel<LED_FORMAT_GRB>(const RGB &color, const uint8_t *lut) {
+  return (lut[color.g] << 16) | (lut[color.r] << 8) | lut[color.b];
+}
+
+template<> inline uint32_t packPixel<LED_FORMAT_RGB>(const RGB &color, const uint8_t *lut) {
+  return (lut[color.r] << 16) | (lut[color.g] << 8) | lut[color.b];
+}
+
+template<> inline uint32_t packPixel<LED_FORMAT_GRBW>(const RGB &color, const uint8_t *lut) {
+  if ((color.r == color.g) && (color.r == color.b))
+    return lut[color.r];
+
+  return (lut[color.g] << 24) | (lut[color.r] << 16) | (lut[color.b] << 8) | lut[color.w];
+}
+
+template<> inline uint32_t packPixel<LED_FORMAT_RGBW>(const RGB &color, const uint8_t *lut) {
+  if ((color.r == color.g) && (color.r == color.b))
+    return lut[color.r];
+
+  return (lut[color.r] << 24) | (lut[color.g] << 16) | (lut[color.b] << 8) | lut[color.w];
+}
+
+inline PixelPacker getPixelPacker(LEDFormat format) {
+  switch (format) {
+    case LED_FORMAT_RGB:  return packPixel<LED_FORMAT_RGB>;
+    case LED_FORMAT_GRBW: return packPixel<LED_FORMAT_GRBW>;
+    case LED_FORMAT_RGBW: return packPixel<LED_FORMAT_RGBW>;
+    default:              return packPixel<LED_FORMAT_GRB>;
+  }
+}
+
+static constexpr RGB ColorBlack(0, 0, 0);
+static constexpr RGB ColorWhite(255, 255, 255);
+static constexpr RGB ColorRed(255, 0, 0);
+static constexpr RGB ColorOrange(255, 128, 0);
+static constexpr RGB ColorYellow(255, 255, 0);
+static constexpr RGB ColorLimeGreen(128, 255, 0);
+static constexpr RGB ColorGreen(0, 255, 0);
+static constexpr RGB ColorSeafoam(0, 255, 128);
+static constexpr RGB ColorAqua(0, 255, 255);
+static constexpr RGB ColorSkyBlue(0, 128, 255);
+static constexpr RGB ColorBlue(0, 0, 255);
+static constexpr RGB ColorPurple(128, 0, 255);
+static constexpr RGB ColorPink(255, 0, 255);
+static constexpr RGB ColorMagenta(255, 0, 128);
 
 static const std::vector<RGB> colors = {
     ColorBlack,     ColorWhite,  ColorRed,     ColorOrange, ColorYellow,
     ColorLimeGreen, ColorGreen,  ColorSeafoam, ColorAqua,   ColorSkyBlue,
     ColorBlue,      ColorPurple, ColorPink,    ColorMagenta};
 
+struct Layer;
+
 class Animation {
 public:
   Animation(PixelMatrix &matrix);
-  void UpdatePixels(std::vector<Pixel> pixels);
-  void ClearPixels();
+  void UpdatePressed(uint32_t pressedMask) { this->pressedMask = pressedMask; }
+  void ClearPressed() { this->pressedMask = 0; }
   virtual ~Animation(){};
 
   static LEDFormat format;
 
-  bool notInFilter(Pixel pixel);
-  virtual void Animate(RGB (&frame)[100]) = 0;
+  // Filtered animations (button presses) only draw pixels whose button is held
+  inline bool notInFilter(uint32_t mask) const { return this->filtered && !(mask & this->pressedMask); }
+  // Effects derive their state from the monotonic time, so speed doesn't depend on the frame rate
+  virtual void Animate(RGB *frame, uint32_t timeMs) = 0;
+  virtual bool HasChanged(uint32_t timeMs) { return true; } // False if Animate would draw the same frame again
+  virtual void Render(Layer &layer, uint32_t timeMs);       // Animate into a compositor layer and set its coverage
   virtual void ParameterUp() = 0;
   virtual void ParameterDown() = 0;
 
 protected:
-/* We track both the full matrix as well as individual pixels here to support
+  // Whole steps of stepMs elapsed since stepTime, stepTime moves forward by the steps taken
+  static inline uint32_t advanceSteps(uint32_t &stepTime, uint32_t timeMs, int16_t stepMs) {
+    uint32_t step = (stepMs > 0) ? stepMs : 1;
+    uint32_t steps = (timeMs - stepTime) / step;
+    stepTime += steps * step;
+    return steps;
+  }
+
+  // Wheel position that sweeps 0-255 and back, one full sweep is 510 steps
+  static inline uint8_t pingPong(uint32_t phase) {
+    phase %= 510;
+    return (phase <= 255) ? phase : (510 - phase);
+  }
+
+/* We track both the full matrix as well as the pressed buttons here to support
 button press changes. Rather than adjusting the matrix to represent a subset of pixels,
-we provide a subset of pixels to use as a filter. */
+we provide a button mask to use as a filter. */
   PixelMatrix *matrix;
-  std::vector<Pixel> pixels;
+  uint32_t pressedMask = 0;
   bool filtered = false;
 };
 
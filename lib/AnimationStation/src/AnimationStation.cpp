@@ -6,12 +6,18 @@
  */
 
 #include "AnimationStation.hpp"
+#include <math.h>
 
 uint8_t AnimationStation::brightnessMax = 100;
 uint8_t AnimationStation::brightnessSteps = 5;
 float AnimationStation::brightnessX = 0;
+uint8_t AnimationStation::brightnessLUT[256] = { };
+PixelPacker AnimationStation::pixelPacker = packPixel<LED_FORMAT_GRB>;
+LEDFormat AnimationStation::packerFormat = LED_FORMAT_GRB;
+uint32_t AnimationStation::lutVersion = 0;
 absolute_time_t AnimationStation::nextChange = 0;
 AnimationOptions AnimationStation::options = {};
+LEDProgram AnimationStation::program;
 
 
 AnimationStation::AnimationStation() {
@@ -60,11 +66,37 @@ void AnimationStation::HandleEvent(AnimationHotkey action) {
     this->buttonAnimation->ParameterDown();
   }
 
+  if (action == HOTKEY_LEDS_PRESS_EFFECT_UP) {
+    ChangePressEffect(1);
+  }
+
+  if (action == HOTKEY_LEDS_PRESS_EFFECT_DOWN) {
+    ChangePressEffect(-1);
+  }
+
   AnimationStation::nextChange = make_timeout_time_ms(250);
 }
 
 void AnimationStation::ChangeAnimation(int changeSize) {
-  this->SetMode(this->AdjustIndex(changeSize));
+  uint16_t newIndex = this->AdjustIndex(changeSize);
+
+  // Nothing to run without a program, so cycle past it
+  if (newIndex == EFFECT_CUSTOM && !program.IsLoaded()) {
+    this->options.baseAnimationIndex = newIndex;
+    newIndex = this->AdjustIndex(changeSize);
+  }
+
+  this->SetMode(newIndex);
+}
+
+void AnimationStation::ChangePressEffect(int changeSize) {
+  int newIndex = this->options.pressEffectIndex + changeSize;
+  if (newIndex >= TOTAL_PRESS_EFFECTS)
+    newIndex = 0;
+  else if (newIndex < 0)
+    newIndex = TOTAL_PRESS_EFFECTS - 1;
+
+  this->SetPressEffect(newIndex);
 }
 
 uint16_t AnimationStation::AdjustIndex(int changeSize) {
@@ -81,37 +113,53 @@ uint16_t AnimationStation::AdjustIndex(int changeSize) {
   return newIndex;
 }
 
-void AnimationStation::HandlePressed(std::vector<Pixel> pressed) {
-  if (pressed != this->lastPressed) {
-    this->lastPressed = pressed;
+void AnimationStation::HandlePressed(uint32_t pressedMask) {
+  if (pressedMask != this->lastPressed) {
+    this->lastPressed = pressedMask;
     if (this->buttonAnimation == nullptr)
-      this->buttonAnimation = new StaticColor(matrix, pressed);
+      this->SetPressEffect(this->options.pressEffectIndex);
 
-    this->buttonAnimation->UpdatePixels(pressed);
+    this->buttonAnimation->UpdatePressed(pressedMask);
+    if (this->baseAnimation != nullptr)
+      this->baseAnimation->UpdatePressed(pressedMask);
   }
 }
 
 void AnimationStation::ClearPressed() {
   if (this->buttonAnimation != nullptr) {
-    this->buttonAnimation->ClearPixels();
+    this->buttonAnimation->ClearPressed();
   }
-  this->lastPressed.clear();
+  if (this->baseAnimation != nullptr) {
+    this->baseAnimation->ClearPressed();
+  }
+  this->lastPressed = 0;
 }
 
-void AnimationStation::Animate() {
+// Redraws the layers whose effect changed and composites them, false if the frame to transmit is unchanged
+bool AnimationStation::Animate(uint32_t timeMs) {
   if (baseAnimation == nullptr) {
-    this->Clear();
-    return;
+    compositor.ClearLayer(LAYER_BASE);
+  } else if (this->layersDirty || baseAnimation->HasChanged(timeMs)) {
+    baseAnimation->Animate(compositor.GetLayer(LAYER_BASE).pixels.data(), timeMs);
+    compositor.MarkDirty(LAYER_BASE);
   }
 
-  baseAnimation->Animate(this->frame);
-
-  if (buttonAnimation != nullptr) {
-    buttonAnimation->Animate(this->frame);
+  if (buttonAnimation != nullptr && (this->layersDirty || this->lastPressed != this->renderedPressed
+      || buttonAnimation->HasChanged(timeMs))) {
+    buttonAnimation->Render(compositor.GetLayer(pressLayer), timeMs);
+    compositor.MarkDirty(pressLayer);
+    this->renderedPressed = this->lastPressed;
   }
+
+  this->layersDirty = false;
+
+  bool changed = compositor.Compose(this->frame);
+
+  // A new brightness or LED format needs a new packed frame even if the colors are the same
+  return changed || this->appliedLUT != lutVersion || packerFormat != Animation::format;
 }
 
-void AnimationStation::Clear() { memset(frame, 0, sizeof(frame)); }
+void AnimationStation::Clear() { std::fill(frame.begin(), frame.end(), ColorBlack); }
 
 float AnimationStation::GetBrightnessX() {
   return AnimationStation::brightnessX;
@@ -142,14 +190,81 @@ void AnimationStation::SetMode(uint8_t mode) {
   case AnimationEffects::EFFECT_STATIC_THEME:
     this->baseAnimation = new StaticTheme(matrix);
     break;
+  case AnimationEffects::EFFECT_CUSTOM:
+    if (program.IsLoaded()) {
+      this->baseAnimation = new Custom(matrix, program);
+      break;
+    }
+    // fall through
   default:
     this->baseAnimation = new StaticColor(matrix);
     break;
   }
+
+  this->baseAnimation->UpdatePressed(this->lastPressed);
+  this->layersDirty = true;
 }
 
-void AnimationStation::SetMatrix(PixelMatrix matrix) {
+void AnimationStation::SetPressEffect(uint8_t effect) {
+  this->options.pressEffectIndex = (effect < TOTAL_PRESS_EFFECTS) ? effect : PRESS_EFFECT_STATIC;
+
+  if (this->buttonAnimation != nullptr) {
+    delete this->buttonAnimation;
+  }
+
+  // The static color replaces what's below, reactive effects fade in and out over it
+  compositor.ClearLayer(this->pressLayer);
+  this->pressLayer = LAYER_PRESS;
+  BlendMode blend = BLEND_ALPHA;
+  switch (static_cast<PressEffects>(this->options.pressEffectIndex)) {
+  case PressEffects::PRESS_EFFECT_RIPPLE:
+    this->buttonAnimation = new Reactive(matrix, REACTIVE_RIPPLE);
+    break;
+  case PressEffects::PRESS_EFFECT_TRAIL:
+    this->buttonAnimation = new Reactive(matrix, REACTIVE_TRAIL);
+    this->pressLayer = LAYER_TRAIL;
+    break;
+  case PressEffects::PRESS_EFFECT_SWEEP:
+    this->buttonAnimation = new Reactive(matrix, REACTIVE_SWEEP);
+    break;
+  default:
+    this->buttonAnimation = new StaticColor(matrix, this->lastPressed);
+    blend = BLEND_REPLACE;
+    break;
+  }
+
+  this->buttonAnimation->UpdatePressed(this->lastPressed);
+  compositor.Configure(this->pressLayer, blend);
+  this->layersDirty = true;
+}
+
+void AnimationStation::SetMatrix(const PixelMatrix &matrix) {
   this->matrix = matrix;
+  this->layersDirty = true;
+}
+
+LEDProgramError AnimationStation::LoadProgram(const uint8_t *code, uint16_t size) {
+  LEDProgramError error = LED_PROGRAM_OK;
+  if (size == 0)
+    program.Unload();
+  else
+    error = program.Load(code, size);
+
+  // Restart the effect so it picks up the new program, or falls back if there is none
+  if (this->options.baseAnimationIndex == EFFECT_CUSTOM)
+    this->SetMode(EFFECT_CUSTOM);
+
+  return error;
+}
+
+void AnimationStation::SetFrameSize(uint16_t size) {
+  this->frame.assign(size, ColorBlack);
+  compositor.Resize(size);
+
+  // The base layer always covers the whole frame, LEDs outside the matrix stay black
+  Layer &base = compositor.GetLayer(LAYER_BASE);
+  std::fill(base.alpha.begin(), base.alpha.end(), 255);
+  this->layersDirty = true;
 }
 
 void AnimationStation::SetOptions(AnimationOptions options) {
@@ -157,21 +272,57 @@ void AnimationStation::SetOptions(AnimationOptions options) {
   AnimationStation::SetBrightness(options.brightness);
 }
 
+void AnimationStation::selectPacker() {
+  packerFormat = Animation::format;
+  pixelPacker = getPixelPacker(packerFormat);
+}
+
 void AnimationStation::ApplyBrightness(uint32_t *frameValue) {
-  for (int i = 0; i < 100; i++)
-    frameValue[i] = this->frame[i].value(Animation::format, brightnessX);
+  if (packerFormat != Animation::format)
+    selectPacker();
+
+  PixelPacker packer = pixelPacker;
+  const uint8_t *lut = brightnessLUT;
+  const RGB *pixels = this->frame.data();
+  size_t count = this->frame.size();
+  for (size_t i = 0; i < count; i++)
+    frameValue[i] = packer(pixels[i], lut);
+
+  this->appliedLUT = lutVersion;
+}
+
+uint32_t AnimationStation::PackColor(const RGB &color) {
+  if (packerFormat != Animation::format)
+    selectPacker();
+
+  return pixelPacker(color, brightnessLUT);
+}
+
+// Only runs when the brightness changes, so the float math here stays off the frame path
+void AnimationStation::buildBrightnessLUT() {
+  for (int i = 0; i < 256; i++) {
+    float level = (ANIMATION_GAMMA == 1.0F) ? i : (powf(i / 255.0F, ANIMATION_GAMMA) * 255.0F);
+    brightnessLUT[i] = (uint8_t)(level * brightnessX);
+  }
+
+  lutVersion++;
 }
 
 void AnimationStation::SetBrightness(uint8_t brightness) {
   AnimationStation::options.brightness =
       (brightness > brightnessSteps) ? brightnessSteps : options.brightness;
-  AnimationStation::brightnessX =
+  float newBrightnessX =
       (AnimationStation::options.brightness * getBrightnessStepSize()) / 255.0F;
 
-  if (AnimationStation::brightnessX > 1)
-    AnimationStation::brightnessX = 1;
-  else if (AnimationStation::brightnessX < 0)
-    AnimationStation::brightnessX = 0;
+  if (newBrightnessX > 1)
+    newBrightnessX = 1;
+  else if (newBrightnessX < 0)
+    newBrightnessX = 0;
+
+  if (newBrightnessX != AnimationStation::brightnessX || brightnessLUT[255] == 0) {
+    AnimationStation::brightnessX = newBrightnessX;
+    buildBrightnessLUT();
+  }
 }
 
 void AnimationStation::DecreaseBrightness() {
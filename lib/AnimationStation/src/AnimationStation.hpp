@@ -10,8 +10,13 @@
 
 #include "NeoPico.hpp"
 #include "Animation.hpp"
+#include "Compositor.hpp"
+#include "FrameScheduler.hpp"
+#include "LEDProgram.hpp"
 #include "Effects/Chase.hpp"
+#include "Effects/Custom.hpp"
 #include "Effects/Rainbow.hpp"
+#include "Effects/Reactive.hpp"
 #include "Effects/StaticColor.hpp"
 #include "Effects/StaticTheme.hpp"
 
@@ -20,11 +25,26 @@ typedef enum
   EFFECT_STATIC_COLOR,
   EFFECT_RAINBOW,
   EFFECT_CHASE,
-  EFFECT_STATIC_THEME
+  EFFECT_STATIC_THEME,
+  EFFECT_CUSTOM
 } AnimationEffects;
 
 // We can't programmatically determine how many elements are in an enum. Yes, that's dumb.
-const int TOTAL_EFFECTS = 4;
+const int TOTAL_EFFECTS = 5;
+
+typedef enum
+{
+  PRESS_EFFECT_STATIC,
+  PRESS_EFFECT_RIPPLE,
+  PRESS_EFFECT_TRAIL,
+  PRESS_EFFECT_SWEEP
+} PressEffects;
+
+const int TOTAL_PRESS_EFFECTS = 4;
+
+#ifndef ANIMATION_GAMMA
+#define ANIMATION_GAMMA 1.0F // 1.0 leaves colors linear, ~2.2 matches perceived brightness
+#endif
 
 typedef enum
 {
@@ -36,9 +56,12 @@ typedef enum
   HOTKEY_LEDS_PRESS_PARAMETER_DOWN,
 	HOTKEY_LEDS_PARAMETER_DOWN,
 	HOTKEY_LEDS_BRIGHTNESS_UP,
-	HOTKEY_LEDS_BRIGHTNESS_DOWN
+	HOTKEY_LEDS_BRIGHTNESS_DOWN,
+	HOTKEY_LEDS_PRESS_EFFECT_UP,
+	HOTKEY_LEDS_PRESS_EFFECT_DOWN
 } AnimationHotkey;
 
+// Stored as is, new fields go at the end so AnimationStorage can migrate older layouts
 struct __attribute__ ((__packed__)) AnimationOptions
 {
   uint32_t checksum;
@@ -49,6 +72,7 @@ struct __attribute__ ((__packed__)) AnimationOptions
   int16_t chaseCycleTime;
   int16_t rainbowCycleTime;
   uint8_t themeIndex;
+  uint8_t pressEffectIndex;
 };
 
 class AnimationStation
@@ -56,18 +80,23 @@ class AnimationStation
 public:
   AnimationStation();
 
-  void Animate();
+  bool Animate(uint32_t timeMs); // True if the frame changed and should be transmitted
   void HandleEvent(AnimationHotkey action);
   void Clear();
   void ChangeAnimation(int changeSize);
+  void ChangePressEffect(int changeSize);
   void ApplyBrightness(uint32_t *frameValue);
+  static uint32_t PackColor(const RGB &color); // Brightness applied, packed for Animation::format
   uint16_t AdjustIndex(int changeSize);
-  void HandlePressed(std::vector<Pixel> pressed);
+  void HandlePressed(uint32_t pressedMask); // Buttons held, same layout as Pixel::mask
   void ClearPressed();
 
   uint8_t GetMode();
   void SetMode(uint8_t mode);
-  void SetMatrix(PixelMatrix matrix);
+  void SetPressEffect(uint8_t effect);
+  void SetMatrix(const PixelMatrix &matrix);
+  LEDProgramError LoadProgram(const uint8_t *code, uint16_t size); // Empty code unloads the program
+  void SetFrameSize(uint16_t size);
   static void ConfigureBrightness(uint8_t max, uint8_t steps);
   static float GetBrightnessX();
   static uint8_t GetBrightness();
@@ -76,18 +105,30 @@ public:
   static void IncreaseBrightness();
   static void SetOptions(AnimationOptions options);
 
-  Animation* baseAnimation;
-  Animation* buttonAnimation;
-  std::vector<Pixel> lastPressed;
+  Animation* baseAnimation = nullptr;
+  Animation* buttonAnimation = nullptr;
+  uint32_t lastPressed = 0;
+  uint32_t renderedPressed = 0; // Pressed mask the press layer was drawn with
+  bool layersDirty = true;      // Effects must redraw their layers even if they report no change
   static AnimationOptions options;
+  static LEDProgram program; // Runs as EFFECT_CUSTOM
   static absolute_time_t nextChange;
-  RGB frame[100];
+  std::vector<RGB> frame; // One entry per LED across all chains, composited from the layers
+  Compositor compositor;
+  LayerSlot pressLayer = LAYER_PRESS; // Layer the press effect draws into
 
 protected:
   inline static uint8_t getBrightnessStepSize() { return (brightnessMax / brightnessSteps); }
   static uint8_t brightnessMax;
   static uint8_t brightnessSteps;
   static float brightnessX;
+  static void buildBrightnessLUT();
+  static void selectPacker();
+  static uint8_t brightnessLUT[256];
+  static PixelPacker pixelPacker;
+  static LEDFormat packerFormat;
+  static uint32_t lutVersion; // Bumped on every LUT rebuild
+  uint32_t appliedLUT = UINT32_MAX;
   PixelMatrix matrix;
 };
 
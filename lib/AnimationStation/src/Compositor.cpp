@@ -0,0 +1,128 @@
+#include "Compositor.hpp"
+#include <algorithm>
+
+void Compositor::Resize(uint16_t size) {
+  for (Layer &layer : layers) {
+    layer.pixels.assign(size, ColorBlack);
+    layer.alpha.assign(size, 0);
+    layer.dirty = true;
+  }
+
+  this->forced = true;
+}
+
+void Compositor::Configure(LayerSlot slot, BlendMode blend, uint8_t opacity) {
+  Layer &layer = layers[slot];
+  if (layer.blend != blend || layer.opacity != opacity) {
+    layer.blend = blend;
+    layer.opacity = opacity;
+    layer.dirty = true;
+  }
+}
+
+void Compositor::SetPixel(LayerSlot slot, uint16_t index, const RGB &color, uint8_t alpha) {
+  Layer &layer = layers[slot];
+  if (index >= layer.pixels.size())
+    return;
+
+  RGB &pixel = layer.pixels[index];
+  if (layer.alpha[index] != alpha || pixel.raw() != color.raw()) {
+    pixel = color;
+    layer.alpha[index] = alpha;
+    layer.dirty = true;
+  }
+}
+
+void Compositor::ClearLayer(LayerSlot slot) {
+  Layer &layer = layers[slot];
+  for (uint8_t &a : layer.alpha) {
+    if (a != 0) {
+      a = 0;
+      layer.dirty = true;
+    }
+  }
+}
+
+bool Compositor::IsDirty() const {
+  for (const Layer &layer : layers) {
+    if (layer.dirty)
+      return true;
+  }
+
+  return false;
+}
+
+bool Compositor::Compose(std::vector<RGB> &frame) {
+  if (!this->forced && !this->IsDirty())
+    return false;
+
+  uint16_t count = frame.size();
+  std::fill(frame.begin(), frame.end(), ColorBlack);
+  for (Layer &layer : layers) {
+    if (layer.opacity > 0 && layer.pixels.size() >= count)
+      blendLayer(layer, frame.data(), count);
+
+    layer.dirty = false;
+  }
+
+  // Layers can change and still produce the same frame, e.g. a press on an LED that is already that color
+  uint32_t hash = hashFrame(frame.data(), count);
+  if (!this->forced && hash == this->lastHash)
+    return false;
+
+  this->lastHash = hash;
+  this->forced = false;
+  return true;
+}
+
+static inline uint8_t mixChannel(uint8_t dst, uint8_t src, uint16_t weight) {
+  return dst + (((int)src - (int)dst) * weight >> 8);
+}
+
+static inline uint8_t addChannel(uint8_t dst, uint8_t src, uint16_t weight) {
+  uint16_t sum = dst + ((src * weight) >> 8);
+  return (sum > 255) ? 255 : sum;
+}
+
+void Compositor::blendLayer(const Layer &layer, RGB *frame, uint16_t count) {
+  const RGB *pixels = layer.pixels.data();
+  const uint8_t *alpha = layer.alpha.data();
+  for (uint16_t i = 0; i < count; i++) {
+    if (alpha[i] == 0)
+      continue;
+
+    // Coverage scaled by opacity, 0-256 so full coverage is an exact copy
+    uint16_t weight = (alpha[i] * (layer.opacity + 1)) >> 8;
+    weight += weight >> 7;
+
+    const RGB &src = pixels[i];
+    RGB &dst = frame[i];
+    switch (layer.blend) {
+      case BLEND_REPLACE:
+        dst = src;
+        break;
+      case BLEND_ALPHA:
+        dst = RGB(mixChannel(dst.r, src.r, weight), mixChannel(dst.g, src.g, weight),
+          mixChannel(dst.b, src.b, weight), mixChannel(dst.w, src.w, weight));
+        break;
+      case BLEND_ADD:
+        dst = RGB(addChannel(dst.r, src.r, weight), addChannel(dst.g, src.g, weight),
+          addChannel(dst.b, src.b, weight), addChannel(dst.w, src.w, weight));
+        break;
+      case BLEND_MAX:
+        dst = RGB(std::max(dst.r, src.r), std::max(dst.g, src.g), std::max(dst.b, src.b), std::max(dst.w, src.w));
+        break;
+    }
+  }
+}
+
+// FNV-1a over the packed pixels, one multiply per LED
+uint32_t Compositor::hashFrame(const RGB *frame, uint16_t count) {
+  uint32_t hash = 2166136261UL;
+  for (uint16_t i = 0; i < count; i++) {
+    hash ^= frame[i].raw();
+    hash *= 16777619UL;
+  }
+
+  return hash;
+}
@@ -0,0 +1,60 @@
+#ifndef _COMPOSITOR_H_
+#define _COMPOSITOR_H_
+
+#include <stdint.h>
+#include <vector>
+#include "Animation.hpp"
+
+// Layers are composited bottom to top in this order
+typedef enum
+{
+  LAYER_BASE,         // Base effect, covers every LED
+  LAYER_PRESS,        // Press effect on held buttons
+  LAYER_TRAIL,        // Fade-out after a button is released
+  LAYER_PLAYER_LEDS,  // Player LEDs driven by the host
+  LAYER_COUNT
+} LayerSlot;
+
+typedef enum
+{
+  BLEND_REPLACE, // Covered LEDs take the layer color
+  BLEND_ALPHA,   // Mix by coverage and opacity
+  BLEND_ADD,     // Saturating add, scaled by coverage and opacity
+  BLEND_MAX,     // Brightest channel wins
+} BlendMode;
+
+struct Layer
+{
+  std::vector<RGB> pixels;
+  std::vector<uint8_t> alpha; // Per-LED coverage, 0 leaves the LEDs below untouched
+  BlendMode blend = BLEND_REPLACE;
+  uint8_t opacity = 255;
+  bool dirty = true;          // Set whenever pixels, coverage or settings change
+};
+
+class Compositor
+{
+public:
+  void Resize(uint16_t size);
+  void Configure(LayerSlot slot, BlendMode blend, uint8_t opacity = 255);
+  void SetPixel(LayerSlot slot, uint16_t index, const RGB &color, uint8_t alpha = 255); // Marks dirty only on change
+  void ClearLayer(LayerSlot slot);
+
+  Layer &GetLayer(LayerSlot slot) { return layers[slot]; }
+  inline void MarkDirty(LayerSlot slot) { layers[slot].dirty = true; }
+  bool IsDirty() const;
+
+  // Flattens the stack into frame, false if the result matches the last composited frame
+  bool Compose(std::vector<RGB> &frame);
+  inline uint32_t GetHash() const { return lastHash; }
+
+protected:
+  static void blendLayer(const Layer &layer, RGB *frame, uint16_t count);
+  static uint32_t hashFrame(const RGB *frame, uint16_t count);
+
+  Layer layers[LAYER_COUNT];
+  uint32_t lastHash = 0;
+  bool forced = true;
+};
+
+#endif
@@ -3,51 +3,27 @@
 Chase::Chase(PixelMatrix &matrix) : Animation(matrix) {
 }
 
-void Chase::Animate(RGB (&frame)[100]) {
-  if (!time_reached(this->nextRunTime)) {
-    return;
-  }
-
-  for (auto &col : matrix->pixels) {
-    for (auto &pixel : col) {
-      if (pixel.index == NO_PIXEL.index)
-        continue;
-
-      if (this->IsChasePixel(pixel.index)) {
-        RGB color = RGB::wheel(this->WheelFrame(pixel.index));
-        for (auto &pos : pixel.positions)
-          frame[pos] = color;
-      }
-      else {
-        for (auto &pos : pixel.positions)
-          frame[pos] = ColorBlack;
-      }
-    }
-  }
-
-  currentPixel++;
-
-  if (currentPixel > matrix->getPixelCount() - 1) {
-    currentPixel = 0;
-  }
-
-  if (reverse) {
-    currentFrame--;
-
-    if (currentFrame < 0) {
-      currentFrame = 1;
-      reverse = false;
-    }
-  } else {
-    currentFrame++;
-
-    if (currentFrame > 255) {
-      currentFrame = 254;
-      reverse = true;
-    }
+void Chase::Animate(RGB *frame, uint32_t timeMs) {
+  uint32_t steps = advanceSteps(stepTime, timeMs, AnimationStation::options.chaseCycleTime);
+  if (matrix->getPixelCount() > 0)
+    currentPixel = (currentPixel + steps) % matrix->getPixelCount();
+
+  phase = (phase + steps) % 510;
+  currentFrame = pingPong(phase);
+  reverse = (phase > 255);
+
+  for (uint16_t i = 0; i < matrix->size(); i++) {
+    int index = matrix->indexes[i];
+    if (this->IsChasePixel(index))
+      matrix->fill(i, frame, RGB::wheel(this->WheelFrame(index)));
+    else
+      matrix->fill(i, frame, ColorBlack);
   }
+}
 
-  this->nextRunTime = make_timeout_time_ms(AnimationStation::options.chaseCycleTime);
+bool Chase::HasChanged(uint32_t timeMs) {
+  int16_t cycleTime = AnimationStation::options.chaseCycleTime;
+  return (timeMs - stepTime) >= (uint32_t)((cycleTime > 0) ? cycleTime : 1);
 }
 
 bool Chase::IsChasePixel(int i) {
@@ -13,7 +13,8 @@ public:
   Chase(PixelMatrix &matrix);
   ~Chase() {};
 
-  void Animate(RGB (&frame)[100]);
+  void Animate(RGB *frame, uint32_t timeMs);
+  bool HasChanged(uint32_t timeMs);
   void ParameterUp();
   void ParameterDown();
 
@@ -23,7 +24,8 @@ protected:
   int currentFrame = 0;
   int currentPixel = 0;
   bool reverse = false;
-  absolute_time_t nextRunTime = 0;
+  uint32_t phase = 0;
+  uint32_t stepTime = 0;
 };
 
 #endif
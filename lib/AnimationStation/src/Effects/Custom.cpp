@@ -0,0 +1,46 @@
+#include "Custom.hpp"
+
+Custom::Custom(PixelMatrix &matrix, LEDProgram &program) : Animation(matrix), program(&program) {
+}
+
+void Custom::Animate(RGB *frame, uint32_t timeMs) {
+  if (!program->IsLoaded())
+    return;
+
+  if (preparedGeneration != program->GetGeneration() || preparedSize != matrix->size()) {
+    program->Prepare(*matrix);
+    preparedGeneration = program->GetGeneration();
+    preparedSize = matrix->size();
+
+    uint8_t maxPosition = 0;
+    for (uint8_t pos : matrix->positions)
+      maxPosition = std::max(maxPosition, pos);
+    pending.assign(maxPosition + 1, ColorBlack);
+  }
+
+  renderedPressed = this->pressedMask;
+  complete = program->Run(*matrix, pending.data(), timeMs, renderedPressed);
+  if (!complete)
+    return;
+
+  for (uint8_t pos : matrix->positions)
+    frame[pos] = pending[pos];
+
+  rendered = true;
+}
+
+bool Custom::HasChanged(uint32_t timeMs) {
+  if (!program->IsLoaded())
+    return false;
+
+  return !rendered || !complete || program->UsesTime()
+    || preparedGeneration != program->GetGeneration()
+    || (program->UsesPressed() && renderedPressed != this->pressedMask);
+}
+
+// Everything about the effect comes from the program itself
+void Custom::ParameterUp() {
+}
+
+void Custom::ParameterDown() {
+}
@@ -0,0 +1,33 @@
+#ifndef _CUSTOM_H_
+#define _CUSTOM_H_
+
+#include <vector>
+#include <stdio.h>
+#include <stdlib.h>
+#include "../Animation.hpp"
+#include "../AnimationStation.hpp"
+#include "../LEDProgram.hpp"
+
+/* Runs the uploaded LED program. A frame that needs more than the program budget is rendered
+   over several calls into a buffer of its own and shown once complete, so it never tears. */
+class Custom : public Animation {
+public:
+  Custom(PixelMatrix &matrix, LEDProgram &program);
+  ~Custom() {};
+
+  void Animate(RGB *frame, uint32_t timeMs);
+  bool HasChanged(uint32_t timeMs);
+  void ParameterUp();
+  void ParameterDown();
+
+protected:
+  LEDProgram *program;
+  std::vector<RGB> pending;        // Frame being rendered, indexed like the LED frame
+  uint32_t preparedGeneration = 0; // Program the per-pixel cache was built for
+  uint16_t preparedSize = 0;
+  uint32_t renderedPressed = 0;
+  bool rendered = false;           // At least one complete frame shown
+  bool complete = true;            // False while a frame spans several calls
+};
+
+#endif
@@ -3,39 +3,18 @@
 Rainbow::Rainbow(PixelMatrix &matrix) : Animation(matrix) {
 }
 
-void Rainbow::Animate(RGB (&frame)[100]) {
-  if (!time_reached(this->nextRunTime)) {
-    return;
-  }
-
-  for (auto &col : matrix->pixels) {
-    for (auto &pixel : col) {
-      if (pixel.index == NO_PIXEL.index)
-        continue;
-
-      RGB color = RGB::wheel(this->currentFrame);
-      for (auto &pos : pixel.positions)
-        frame[pos] = color;
-    }
-  }
+void Rainbow::Animate(RGB *frame, uint32_t timeMs) {
+  phase = (phase + advanceSteps(stepTime, timeMs, AnimationStation::options.rainbowCycleTime)) % 510;
 
-  if (reverse) {
-    currentFrame--;
-
-    if (currentFrame < 0) {
-      currentFrame = 1;
-      reverse = false;
-    }
-  } else {
-    currentFrame++;
-
-    if (currentFrame > 255) {
-      currentFrame = 254;
-      reverse = true;
-    }
-  }
+  // Every pixel shares the color, so skip the pixels and fill the LEDs directly
+  RGB color = RGB::wheel(pingPong(phase));
+  for (uint8_t pos : matrix->positions)
+    frame[pos] = color;
+}
 
-  this->nextRunTime = make_timeout_time_ms(AnimationStation::options.rainbowCycleTime);
+bool Rainbow::HasChanged(uint32_t timeMs) {
+  int16_t cycleTime = AnimationStation::options.rainbowCycleTime;
+  return (timeMs - stepTime) >= (uint32_t)((cycleTime > 0) ? cycleTime : 1);
 }
 
 void Rainbow::ParameterUp() {
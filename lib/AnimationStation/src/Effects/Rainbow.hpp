@@ -13,14 +13,14 @@ public:
   Rainbow(PixelMatrix &matrix);
   ~Rainbow() {};
 
-  void Animate(RGB (&frame)[100]);
+  void Animate(RGB *frame, uint32_t timeMs);
+  bool HasChanged(uint32_t timeMs);
   void ParameterUp();
   void ParameterDown();
 
 protected:
-  int currentFrame = 0;
-  bool reverse = false;
-  absolute_time_t nextRunTime = 0;
+  uint32_t phase = 0;
+  uint32_t stepTime = 0;
 };
 
 #endif
@@ -0,0 +1,136 @@
+#include "Reactive.hpp"
+
+Reactive::Reactive(PixelMatrix &matrix, ReactiveMode mode) : Animation(matrix), mode(mode) {
+  this->filtered = true;
+}
+
+// Every lit pixel gets the button color, Render decides how much of it shows
+void Reactive::Animate(RGB *frame, uint32_t timeMs) {
+  renderedColor = AnimationStation::options.buttonColorIndex;
+  RGB color = colors[renderedColor];
+  for (uint8_t pos : matrix->positions)
+    frame[pos] = color;
+}
+
+void Reactive::Render(Layer &layer, uint32_t timeMs) {
+  uint16_t count = matrix->size();
+  if (releaseTimes.size() != count) {
+    releaseTimes.assign(count, 0);
+    waveCount = 0;
+  }
+
+  levels.assign(count, 0);
+
+  uint32_t pressed = this->pressedMask;
+  uint32_t presses = pressed & ~renderedPressed;
+  uint32_t released = renderedPressed & ~pressed;
+  renderedPressed = pressed;
+
+  // Held buttons are lit in every mode
+  for (uint16_t i = 0; i < count; i++) {
+    if (matrix->masks[i] & pressed)
+      levels[i] = 255;
+  }
+
+  if (mode == REACTIVE_TRAIL) {
+    renderTrails(released, timeMs);
+  } else {
+    startWaves(presses, timeMs);
+    renderWaves(timeMs);
+  }
+
+  this->Animate(layer.pixels.data(), timeMs);
+  for (uint16_t i = 0; i < count; i++)
+    matrix->fill(i, layer.alpha.data(), levels[i]);
+}
+
+bool Reactive::HasChanged(uint32_t timeMs) {
+  return active || (renderedColor != AnimationStation::options.buttonColorIndex);
+}
+
+void Reactive::startWaves(uint32_t presses, uint32_t timeMs) {
+  if (presses == 0)
+    return;
+
+  for (uint16_t i = 0; i < matrix->size(); i++) {
+    if (!(matrix->masks[i] & presses))
+      continue;
+
+    waves[nextWave] = { i, timeMs };
+    nextWave = (nextWave + 1) % REACTIVE_MAX_WAVES;
+    if (waveCount < REACTIVE_MAX_WAVES)
+      waveCount++;
+  }
+}
+
+void Reactive::renderWaves(uint32_t timeMs) {
+  uint16_t count = matrix->size();
+  active = false;
+
+  for (uint8_t w = 0; w < waveCount; w++) {
+    const Wave &wave = waves[w];
+    uint32_t elapsed = timeMs - wave.startTime;
+    if (elapsed >= REACTIVE_WAVE_MS || wave.origin >= count)
+      continue;
+
+    active = true;
+
+    // The front moves out at a fixed speed while the whole wave fades over its lifetime
+    int32_t radius = (elapsed * REACTIVE_WAVE_SPEED) / 1000;
+    uint32_t fade = (255 * (REACTIVE_WAVE_MS - elapsed)) / REACTIVE_WAVE_MS;
+    const uint8_t *distances = &matrix->distances[wave.origin * count];
+    for (uint16_t p = 0; p < count; p++) {
+      if (mode == REACTIVE_SWEEP && !onLine(wave.origin, p))
+        continue;
+
+      int32_t offset = abs((int32_t)distances[p] - radius);
+      if (offset >= REACTIVE_WAVE_WIDTH)
+        continue;
+
+      uint8_t level = ((REACTIVE_WAVE_WIDTH - offset) * fade) / REACTIVE_WAVE_WIDTH;
+      if (level > levels[p])
+        levels[p] = level;
+    }
+  }
+}
+
+void Reactive::renderTrails(uint32_t released, uint32_t timeMs) {
+  active = false;
+
+  for (uint16_t i = 0; i < matrix->size(); i++) {
+    if (matrix->masks[i] & renderedPressed) {
+      releaseTimes[i] = 0;
+      continue;
+    }
+
+    if (matrix->masks[i] & released)
+      releaseTimes[i] = (timeMs != 0) ? timeMs : 1;
+
+    if (releaseTimes[i] == 0)
+      continue;
+
+    uint32_t elapsed = timeMs - releaseTimes[i];
+    if (elapsed >= REACTIVE_TRAIL_MS) {
+      releaseTimes[i] = 0;
+      continue;
+    }
+
+    active = true;
+    levels[i] = (255 * (REACTIVE_TRAIL_MS - elapsed)) / REACTIVE_TRAIL_MS;
+  }
+}
+
+bool Reactive::onLine(uint16_t a, uint16_t b) const {
+  return abs(matrix->xs[a] - matrix->xs[b]) < (PIXEL_GRID_SIZE / 2)
+    || abs(matrix->ys[a] - matrix->ys[b]) < (PIXEL_GRID_SIZE / 2);
+}
+
+void Reactive::ParameterUp() {
+  uint8_t colorIndex = AnimationStation::options.buttonColorIndex;
+  AnimationStation::options.buttonColorIndex = (colorIndex < colors.size() - 1) ? (colorIndex + 1) : 0;
+}
+
+void Reactive::ParameterDown() {
+  uint8_t colorIndex = AnimationStation::options.buttonColorIndex;
+  AnimationStation::options.buttonColorIndex = (colorIndex > 0) ? (colorIndex - 1) : (colors.size() - 1);
+}
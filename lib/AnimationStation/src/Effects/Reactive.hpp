@@ -0,0 +1,73 @@
+#ifndef _REACTIVE_H_
+#define _REACTIVE_H_
+
+#include <vector>
+#include <stdio.h>
+#include <stdlib.h>
+#include "../Animation.hpp"
+#include "../AnimationStation.hpp"
+
+#ifndef REACTIVE_MAX_WAVES
+#define REACTIVE_MAX_WAVES 8   // Waves running at once, the oldest is replaced
+#endif
+
+#ifndef REACTIVE_WAVE_SPEED
+#define REACTIVE_WAVE_SPEED 96 // Grid units per second, PIXEL_GRID_SIZE per layout cell
+#endif
+
+#ifndef REACTIVE_WAVE_WIDTH
+#define REACTIVE_WAVE_WIDTH 16 // Grid units lit on either side of the wave front
+#endif
+
+#ifndef REACTIVE_WAVE_MS
+#define REACTIVE_WAVE_MS 800
+#endif
+
+#ifndef REACTIVE_TRAIL_MS
+#define REACTIVE_TRAIL_MS 400
+#endif
+
+typedef enum
+{
+  REACTIVE_RIPPLE, // Rings spread out from each press
+  REACTIVE_TRAIL,  // Buttons fade out after release
+  REACTIVE_SWEEP,  // Waves run along the row and column of each press
+} ReactiveMode;
+
+/* Press effects driven by the pixel geometry. Distances come from the table PixelMatrix builds
+   at setup, so a frame costs waves x pixels lookups and integer math. The effect draws the
+   button color everywhere and shapes it through the layer coverage. */
+class Reactive : public Animation {
+public:
+  Reactive(PixelMatrix &matrix, ReactiveMode mode);
+  ~Reactive() {};
+
+  void Animate(RGB *frame, uint32_t timeMs);
+  void Render(Layer &layer, uint32_t timeMs);
+  bool HasChanged(uint32_t timeMs);
+  void ParameterUp();
+  void ParameterDown();
+
+protected:
+  struct Wave {
+    uint16_t origin; // Pixel the wave starts from
+    uint32_t startTime;
+  };
+
+  void startWaves(uint32_t presses, uint32_t timeMs);
+  void renderWaves(uint32_t timeMs);
+  void renderTrails(uint32_t released, uint32_t timeMs);
+  bool onLine(uint16_t a, uint16_t b) const; // Same row or column
+
+  ReactiveMode mode;
+  Wave waves[REACTIVE_MAX_WAVES];
+  uint8_t waveCount = 0;
+  uint8_t nextWave = 0;
+  uint32_t renderedPressed = 0;       // Held buttons at the last render, to find presses and releases
+  int renderedColor = -1;
+  bool active = false;                // Waves or trails still running
+  std::vector<uint8_t> levels;        // Coverage per pixel
+  std::vector<uint32_t> releaseTimes; // Trail start per pixel, 0 if not fading
+};
+
+#endif
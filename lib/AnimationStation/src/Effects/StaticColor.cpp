@@ -3,23 +3,29 @@
 StaticColor::StaticColor(PixelMatrix &matrix) : Animation(matrix) {
 }
 
-StaticColor::StaticColor(PixelMatrix &matrix, std::vector<Pixel> &pixels) : Animation(matrix), pixels(&pixels) {
+StaticColor::StaticColor(PixelMatrix &matrix, uint32_t pressedMask) : Animation(matrix) {
   this->filtered = true;
+  this->pressedMask = pressedMask;
 }
 
-void StaticColor::Animate(RGB (&frame)[100]) {
-  for (size_t r = 0; r != matrix->pixels.size(); r++) {
-    for (size_t c = 0; c != matrix->pixels[r].size(); c++) {
-      if (matrix->pixels[r][c].index == NO_PIXEL.index || this->notInFilter(matrix->pixels[r][c]))
-        continue;
+void StaticColor::Animate(RGB *frame, uint32_t timeMs) {
+  renderedColor = this->GetColor();
+  if (this->filtered && this->pressedMask == 0)
+    return;
 
-      for (size_t p = 0; p != matrix->pixels[r][c].positions.size(); p++) {
-        frame[matrix->pixels[r][c].positions[p]] = colors[this->GetColor()];
-      }
-    }
+  RGB color = colors[renderedColor];
+  for (uint16_t i = 0; i < matrix->size(); i++) {
+    if (this->notInFilter(matrix->masks[i]))
+      continue;
+
+    matrix->fill(i, frame, color);
   }
 }
 
+bool StaticColor::HasChanged(uint32_t timeMs) {
+  return renderedColor != this->GetColor();
+}
+
 uint8_t StaticColor::GetColor() {
   if (this->filtered) {
     return AnimationStation::options.buttonColorIndex;
@@ -10,16 +10,17 @@
 class StaticColor : public Animation {
 public:
   StaticColor(PixelMatrix &matrix);
-  StaticColor(PixelMatrix &matrix, std::vector<Pixel> &pixels);
+  StaticColor(PixelMatrix &matrix, uint32_t pressedMask);
   ~StaticColor() {};
 
-  void Animate(RGB (&frame)[100]);
+  void Animate(RGB *frame, uint32_t timeMs);
+  bool HasChanged(uint32_t timeMs);
   void SaveIndexOptions(uint8_t colorIndex);
   uint8_t GetColor();
   void ParameterUp();
   void ParameterDown();
 protected:
-  std::vector<Pixel> *pixels;
+  int renderedColor = -1;
 };
 
 #endif
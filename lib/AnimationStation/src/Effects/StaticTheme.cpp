@@ -1,6 +1,6 @@
 #include "StaticTheme.hpp"
 
-std::vector<std::map<uint32_t, RGB>> StaticTheme::themes = {};
+std::vector<const StaticThemeTable *> StaticTheme::themes = {};
 
 StaticTheme::StaticTheme(PixelMatrix &matrix) : Animation(matrix) {
   if (AnimationStation::options.themeIndex >= StaticTheme::themes.size()) {
@@ -8,32 +8,24 @@ StaticTheme::StaticTheme(PixelMatrix &matrix) : Animation(matrix) {
   }
 }
 
-void StaticTheme::Animate(RGB (&frame)[100]) {
+void StaticTheme::Animate(RGB *frame, uint32_t timeMs) {
   if (StaticTheme::themes.size() > 0) {
-    for (size_t r = 0; r != matrix->pixels.size(); r++) {
-      for (size_t c = 0; c != matrix->pixels[r].size(); c++) {
-        if (matrix->pixels[r][c].index == NO_PIXEL.index)
-          continue;
-
-        std::map<uint32_t, RGB> theme =
-            StaticTheme::themes.at(AnimationStation::options.themeIndex);
-        auto itr = theme.find(matrix->pixels[r][c].mask);
-        if (itr != theme.end()) {
-          for (size_t p = 0; p != matrix->pixels[r][c].positions.size(); p++) {
-            frame[matrix->pixels[r][c].positions[p]] = itr->second;
-          }
-        } else {
-          for (size_t p = 0; p != matrix->pixels[r][c].positions.size(); p++) {
-            frame[matrix->pixels[r][c].positions[p]] = defaultColor;
-          }
-        }
-      }
+    const RGB *colors = StaticTheme::themes.at(AnimationStation::options.themeIndex)->colors;
+    for (uint16_t i = 0; i < matrix->size(); i++) {
+      uint8_t bit = matrix->buttonBits[i];
+      matrix->fill(i, frame, (bit < STATIC_THEME_BUTTONS) ? colors[bit] : defaultColor);
     }
   }
+
+  renderedTheme = AnimationStation::options.themeIndex;
+}
+
+bool StaticTheme::HasChanged(uint32_t timeMs) {
+  return renderedTheme != AnimationStation::options.themeIndex;
 }
 
-void StaticTheme::AddTheme(std::map<uint32_t, RGB> theme) {
-  themes.push_back(theme);
+void StaticTheme::AddTheme(const StaticThemeTable &theme) {
+  themes.push_back(&theme);
 }
 
 void StaticTheme::ClearThemes() {
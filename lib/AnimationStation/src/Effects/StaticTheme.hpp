@@ -1,8 +1,6 @@
 #ifndef STATIC_THEME_H_
 #define STATIC_THEME_H_
 
-#include <iterator>
-#include <map>
 #include <vector>
 #include <string.h>
 #include <stdio.h>
@@ -10,19 +8,48 @@
 #include "../Animation.hpp"
 #include "../AnimationStation.hpp"
 
+#define STATIC_THEME_BUTTONS 32 // One color per bit of Pixel::mask
+
+struct StaticThemeColor {
+  uint32_t mask;
+  RGB color;
+};
+
+// Flat theme, indexed by the button bit of each pixel. Buttons without a color stay black.
+struct StaticThemeTable {
+  RGB colors[STATIC_THEME_BUTTONS];
+};
+
+// Builds a theme table at compile time from mask/color pairs, the first entry for a button wins
+template<size_t N>
+constexpr StaticThemeTable makeStaticTheme(const StaticThemeColor (&colors)[N]) {
+  StaticThemeTable table = { };
+  uint32_t assigned = 0;
+  for (size_t i = 0; i < N; i++) {
+    uint8_t bit = buttonBit(colors[i].mask);
+    if (bit < STATIC_THEME_BUTTONS && !(assigned & (1UL << bit))) {
+      table.colors[bit] = colors[i].color;
+      assigned |= (1UL << bit);
+    }
+  }
+  return table;
+}
+
 class StaticTheme : public Animation {
 public:
   StaticTheme(PixelMatrix &matrix);
   ~StaticTheme() {};
 
-  static void AddTheme(std::map<uint32_t, RGB> theme);
+  static void AddTheme(const StaticThemeTable &theme); // Theme must outlive the animation, normally a constexpr table
   static void ClearThemes();
-  void Animate(RGB (&frame)[100]);
+  void Animate(RGB *frame, uint32_t timeMs);
+  bool HasChanged(uint32_t timeMs);
   void ParameterUp();
   void ParameterDown();
 protected:
   RGB defaultColor = ColorBlack;
-  static std::vector<std::map<uint32_t, RGB>> themes;
+  int renderedTheme = -1;
+  static std::vector<const StaticThemeTable *> themes;
 };
 
 #endif
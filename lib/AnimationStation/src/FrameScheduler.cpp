@@ -0,0 +1,44 @@
+#include "FrameScheduler.hpp"
+
+void FrameScheduler::SetFrameRate(uint16_t fps) {
+  if (fps == 0)
+    fps = 1;
+
+  stats.targetFPS = fps;
+  framePeriod = 1000000 / fps;
+}
+
+bool FrameScheduler::FrameDue(uint64_t timeUs) {
+  if (timeUs < nextFrame)
+    return false;
+
+  // Stay on the slot grid, but drop the slots we were too late for
+  uint64_t late = timeUs - nextFrame;
+  if (nextFrame != 0 && late >= framePeriod)
+    windowSkipped += late / framePeriod;
+
+  nextFrame = (nextFrame == 0 || late >= framePeriod) ? (timeUs + framePeriod) : (nextFrame + framePeriod);
+
+  if (windowStart == 0)
+    windowStart = timeUs;
+
+  uint64_t elapsed = timeUs - windowStart;
+  if (elapsed >= FRAME_STATS_WINDOW_US) {
+    stats.fps = ((uint64_t)windowFrames * 1000000) / elapsed;
+    stats.transmitFPS = ((uint64_t)windowTransmits * 1000000) / elapsed;
+    stats.skipped = windowSkipped;
+    windowStart = timeUs;
+    windowFrames = 0;
+    windowTransmits = 0;
+    windowSkipped = 0;
+  }
+
+  return true;
+}
+
+void FrameScheduler::RecordRender(uint32_t renderTime, bool transmitted) {
+  stats.renderTime = renderTime;
+  windowFrames++;
+  if (transmitted)
+    windowTransmits++;
+}
@@ -0,0 +1,40 @@
+#ifndef _FRAME_SCHEDULER_H_
+#define _FRAME_SCHEDULER_H_
+
+#include <stdint.h>
+
+#define FRAME_STATS_WINDOW_US 1000000 // Achieved rates are measured over one second
+
+struct FrameStats
+{
+  uint16_t targetFPS;
+  uint16_t fps;          // Frames rendered per second
+  uint16_t transmitFPS;  // Frames that changed and were sent to the LEDs
+  uint16_t skipped;      // Frame slots missed in the last window because core1 was busy
+  uint32_t renderTime;   // Microseconds spent in the last render (effects, compositing, packing)
+  uint32_t transmitTime; // Microseconds from starting the last transmit to the end of the latch
+};
+
+/* Paces rendering at a fixed rate on the hardware timer. Slots that were missed are dropped
+   rather than rendered back to back, and effects are time-based, so a slow frame only lowers
+   the frame rate and never the animation speed. */
+class FrameScheduler
+{
+public:
+  void SetFrameRate(uint16_t fps);
+  bool FrameDue(uint64_t timeUs); // True once per frame slot
+  void RecordRender(uint32_t renderTime, bool transmitted);
+  void RecordTransmit(uint32_t transmitTime) { stats.transmitTime = transmitTime; }
+  const FrameStats &GetStats() const { return stats; }
+
+protected:
+  uint32_t framePeriod = 10000;
+  uint64_t nextFrame = 0;
+  uint64_t windowStart = 0;
+  uint16_t windowFrames = 0;
+  uint16_t windowTransmits = 0;
+  uint16_t windowSkipped = 0;
+  FrameStats stats = { };
+};
+
+#endif
@@ -0,0 +1,428 @@
+#include "LEDProgram.hpp"
+#include <stdlib.h>
+#include <string.h>
+
+#define DEP_TIME    (1 << 0)
+#define DEP_PIXEL   (1 << 1)
+#define DEP_PRESSED (1 << 2)
+
+// Quarter sine wave, 127 * sin(2 * pi * i / 256)
+static const uint8_t sineTable[65] = {
+  0, 3, 6, 9, 12, 16, 19, 22, 25, 28, 31, 34, 37, 40, 43, 46, 49, 51, 54, 57, 60, 63, 65, 68, 71, 73, 76, 78, 81, 83, 85, 88,
+  90, 92, 94, 96, 98, 100, 102, 104, 106, 107, 109, 111, 112, 113, 115, 116, 117, 118, 120, 121, 122, 122, 123, 124, 125, 125,
+  126, 126, 126, 127, 127, 127, 127,
+};
+
+// Operands popped by each public opcode, the stack ops are handled while parsing
+static uint8_t operandCount(uint8_t op) {
+  switch (op) {
+    case LED_OP_NEG:
+    case LED_OP_ABS:
+    case LED_OP_NOT:
+    case LED_OP_SIN8:
+      return 1;
+    case LED_OP_SELECT:
+      return 3;
+    default:
+      return (op >= LED_OP_ADD && op <= LED_OP_EQ) ? 2 : 0;
+  }
+}
+
+// Stack needed to run compiled code, reordering by DUP, OVER and SWAP can make it deeper than the bytecode's
+uint16_t LEDProgram::stackDepth(const std::vector<Instruction> &code) {
+  int16_t depth = 0;
+  int16_t deepest = 0;
+  for (const Instruction &instruction : code) {
+    uint8_t argc = operandCount(instruction.op);
+    depth += 1 - argc;
+    if (argc == 0 && depth > deepest)
+      deepest = depth;
+  }
+
+  return deepest;
+}
+
+// A program can parse fine and still compile past the limits, so only a trial compile tells
+LEDProgramError LEDProgram::Validate(const uint8_t *code, uint16_t size) {
+  LEDProgramError error = parse(code, size, nullptr, nullptr);
+  if (error != LED_PROGRAM_OK)
+    return error;
+
+  LEDProgram program;
+  return program.Load(code, size);
+}
+
+const char *LEDProgram::ErrorName(LEDProgramError error) {
+  switch (error) {
+    case LED_PROGRAM_OK:              return "ok";
+    case LED_PROGRAM_EMPTY:           return "empty program";
+    case LED_PROGRAM_TOO_LARGE:       return "program too large";
+    case LED_PROGRAM_BAD_OPCODE:      return "invalid opcode";
+    case LED_PROGRAM_TRUNCATED:       return "truncated instruction";
+    case LED_PROGRAM_STACK_UNDERFLOW: return "stack underflow";
+    case LED_PROGRAM_STACK_OVERFLOW:  return "stack overflow";
+    case LED_PROGRAM_NO_END:          return "missing END";
+    case LED_PROGRAM_BAD_RESULT:      return "program must end with r, g, b on the stack";
+    case LED_PROGRAM_TOO_COMPLEX:     return "program too complex";
+  }
+
+  return "unknown error";
+}
+
+// Walks the bytecode once, checking it and (when nodes is set) building the expression graph
+LEDProgramError LEDProgram::parse(const uint8_t *code, uint16_t size, std::vector<Node> *nodes, uint16_t *outputs) {
+  if (code == nullptr || size == 0)
+    return LED_PROGRAM_EMPTY;
+
+  if (size > LED_PROGRAM_MAX_SIZE)
+    return LED_PROGRAM_TOO_LARGE;
+
+  uint16_t stack[LED_PROGRAM_MAX_STACK];
+  uint8_t heights[LED_PROGRAM_MAX_STACK]; // Nesting of each stack entry, bounds the recursion in emit()
+  uint8_t depth = 0;
+  uint16_t pc = 0;
+  while (pc < size) {
+    uint8_t op = code[pc++];
+    if (op >= LED_OP_PUBLIC_COUNT)
+      return LED_PROGRAM_BAD_OPCODE;
+
+    if (op == LED_OP_END) {
+      if (depth != 3)
+        return LED_PROGRAM_BAD_RESULT;
+
+      if (outputs != nullptr)
+        memcpy(outputs, stack, sizeof(uint16_t) * 3);
+
+      return LED_PROGRAM_OK;
+    }
+
+    Node node = { op, 0, 0, { 0, 0, 0 }, 0, -1, -1 };
+    uint8_t height = 1;
+    switch (op) {
+      case LED_OP_PUSH8:
+        if (pc + 1 > size)
+          return LED_PROGRAM_TRUNCATED;
+        node.imm = (int8_t)code[pc];
+        pc += 1;
+        break;
+      case LED_OP_PUSH16:
+        if (pc + 2 > size)
+          return LED_PROGRAM_TRUNCATED;
+        node.imm = (int16_t)(code[pc] | (code[pc + 1] << 8));
+        pc += 2;
+        break;
+      case LED_OP_TIME:
+        node.deps = DEP_TIME;
+        break;
+      case LED_OP_X:
+      case LED_OP_Y:
+      case LED_OP_INDEX:
+        node.deps = DEP_PIXEL;
+        break;
+      case LED_OP_PRESSED:
+        node.deps = DEP_PIXEL | DEP_PRESSED;
+        break;
+      case LED_OP_DUP:
+      case LED_OP_OVER:
+        if (depth < ((op == LED_OP_DUP) ? 1 : 2))
+          return LED_PROGRAM_STACK_UNDERFLOW;
+        if (depth == LED_PROGRAM_MAX_STACK)
+          return LED_PROGRAM_STACK_OVERFLOW;
+        stack[depth] = stack[depth - ((op == LED_OP_DUP) ? 1 : 2)];
+        heights[depth] = heights[depth - ((op == LED_OP_DUP) ? 1 : 2)];
+        depth++;
+        continue;
+      case LED_OP_DROP:
+        if (depth < 1)
+          return LED_PROGRAM_STACK_UNDERFLOW;
+        depth--;
+        continue;
+      case LED_OP_SWAP:
+      {
+        if (depth < 2)
+          return LED_PROGRAM_STACK_UNDERFLOW;
+        uint16_t top = stack[depth - 1];
+        stack[depth - 1] = stack[depth - 2];
+        stack[depth - 2] = top;
+        uint8_t topHeight = heights[depth - 1];
+        heights[depth - 1] = heights[depth - 2];
+        heights[depth - 2] = topHeight;
+        continue;
+      }
+      default:
+        node.argc = operandCount(op);
+        if (depth < node.argc)
+          return LED_PROGRAM_STACK_UNDERFLOW;
+        depth -= node.argc;
+        for (uint8_t a = 0; a < node.argc; a++) {
+          node.args[a] = stack[depth + a];
+          if (heights[depth + a] >= height)
+            height = heights[depth + a] + 1;
+          if (nodes != nullptr)
+            node.deps |= (*nodes)[node.args[a]].deps;
+        }
+        if (height > LED_PROGRAM_MAX_DEPTH)
+          return LED_PROGRAM_TOO_COMPLEX;
+        break;
+    }
+
+    if (depth == LED_PROGRAM_MAX_STACK)
+      return LED_PROGRAM_STACK_OVERFLOW;
+
+    heights[depth] = height;
+
+    // Without a graph the stack only tracks the depth
+    if (nodes != nullptr) {
+      stack[depth++] = nodes->size();
+      nodes->push_back(node);
+    } else {
+      stack[depth++] = 0;
+    }
+  }
+
+  return LED_PROGRAM_NO_END;
+}
+
+LEDProgramError LEDProgram::Load(const uint8_t *code, uint16_t size) {
+  Unload();
+
+  std::vector<Node> nodes;
+  uint16_t outputs[3];
+  LEDProgramError error = parse(code, size, &nodes, outputs);
+  if (error != LED_PROGRAM_OK)
+    return error;
+
+  for (uint8_t c = 0; c < 3; c++) {
+    if (!emit(nodes, outputs[c], pixelCode[c], true)) {
+      Unload();
+      return LED_PROGRAM_TOO_COMPLEX;
+    }
+  }
+
+  bool fits = true;
+  for (std::vector<Instruction> &code : pixelCode)
+    fits &= stackDepth(code) <= LED_PROGRAM_MAX_STACK;
+  for (std::vector<Instruction> &code : staticCode)
+    fits &= stackDepth(code) <= LED_PROGRAM_MAX_STACK;
+  for (std::vector<Instruction> &code : frameCode)
+    fits &= stackDepth(code) <= LED_PROGRAM_MAX_STACK;
+
+  if (!fits) {
+    Unload();
+    return LED_PROGRAM_TOO_COMPLEX;
+  }
+
+  pixelCost = pixelCode[0].size() + pixelCode[1].size() + pixelCode[2].size();
+  frameCost = 0;
+  for (std::vector<Instruction> &slot : frameCode)
+    frameCost += slot.size();
+
+  for (uint8_t c = 0; c < 3; c++) {
+    usesTime |= (nodes[outputs[c]].deps & DEP_TIME) != 0;
+    usesPressed |= (nodes[outputs[c]].deps & DEP_PRESSED) != 0;
+  }
+
+  loaded = true;
+  generation++;
+  return LED_PROGRAM_OK;
+}
+
+void LEDProgram::Unload() {
+  loaded = false;
+  usesTime = false;
+  usesPressed = false;
+  pixelCost = 0;
+  frameCost = 0;
+  nextPixel = 0;
+  for (std::vector<Instruction> &code : pixelCode)
+    code.clear();
+  staticCode.clear();
+  frameCode.clear();
+  statics.clear();
+}
+
+// Appends the code for node n. Invariant sub-expressions become cache loads when cache is set.
+bool LEDProgram::emit(std::vector<Node> &nodes, uint16_t n, std::vector<Instruction> &code, bool cache) {
+  if (code.size() >= LED_PROGRAM_MAX_COMPILED)
+    return false;
+
+  Node &node = nodes[n];
+  switch (node.op) {
+    case LED_OP_PUSH8:
+    case LED_OP_PUSH16:
+      code.push_back({ LED_OP_CONST, node.imm });
+      return true;
+    case LED_OP_TIME:
+    case LED_OP_X:
+    case LED_OP_Y:
+    case LED_OP_INDEX:
+    case LED_OP_PRESSED:
+      code.push_back({ node.op, 0 });
+      return true;
+  }
+
+  // Nothing varies, fold it now
+  if (node.deps == 0) {
+    std::vector<Instruction> folded;
+    for (uint8_t a = 0; a < node.argc; a++) {
+      if (!emit(nodes, node.args[a], folded, false))
+        return false;
+    }
+    folded.push_back({ node.op, 0 });
+    Context context = { };
+    node.op = LED_OP_PUSH16; // Later references reuse the value
+    node.imm = execute(folded.data(), folded.size(), context);
+    code.push_back({ LED_OP_CONST, node.imm });
+    return true;
+  }
+
+  if (cache && node.deps == DEP_PIXEL && (node.staticSlot >= 0 || staticCode.size() < LED_PROGRAM_MAX_CACHE)) {
+    if (node.staticSlot < 0) {
+      node.staticSlot = staticCode.size();
+      staticCode.emplace_back();
+      if (!emit(nodes, n, staticCode.back(), false))
+        return false;
+    }
+    code.push_back({ LED_OP_STATIC, node.staticSlot });
+    return true;
+  }
+
+  if (cache && node.deps == DEP_TIME && (node.frameSlot >= 0 || frameCode.size() < LED_PROGRAM_MAX_CACHE)) {
+    if (node.frameSlot < 0) {
+      node.frameSlot = frameCode.size();
+      frameCode.emplace_back();
+      if (!emit(nodes, n, frameCode.back(), false))
+        return false;
+    }
+    code.push_back({ LED_OP_FRAME, node.frameSlot });
+    return true;
+  }
+
+  for (uint8_t a = 0; a < node.argc; a++) {
+    if (!emit(nodes, node.args[a], code, cache))
+      return false;
+  }
+
+  code.push_back({ node.op, 0 });
+  return code.size() <= LED_PROGRAM_MAX_COMPILED;
+}
+
+void LEDProgram::Prepare(const PixelMatrix &matrix) {
+  uint16_t count = matrix.size();
+  uint8_t slots = staticCode.size();
+  statics.assign(count * slots, 0);
+  nextPixel = 0;
+
+  Context context = { };
+  for (uint16_t i = 0; i < count; i++) {
+    context.x = matrix.xs[i];
+    context.y = matrix.ys[i];
+    context.index = matrix.indexes[i];
+    for (uint8_t s = 0; s < slots; s++)
+      statics[(i * slots) + s] = execute(staticCode[s].data(), staticCode[s].size(), context);
+  }
+}
+
+bool LEDProgram::Run(const PixelMatrix &matrix, RGB *frame, uint32_t timeMs, uint32_t pressedMask) {
+  uint16_t count = matrix.size();
+  uint8_t slots = staticCode.size();
+  if (!loaded || count == 0 || statics.size() != (size_t)(count * slots))
+    return true;
+
+  Context context = { };
+  if (nextPixel == 0) {
+    frameTime = timeMs;
+    context.time = frameTime;
+    for (uint8_t f = 0; f < frameCode.size(); f++)
+      frames[f] = execute(frameCode[f].data(), frameCode[f].size(), context);
+  }
+
+  // Whole pixels only, at least one per call so a frame always finishes
+  uint32_t budget = (LED_PROGRAM_BUDGET > frameCost) ? (LED_PROGRAM_BUDGET - frameCost) : 0;
+  uint16_t pixels = (pixelCost > 0) ? (budget / pixelCost) : count;
+  if (pixels == 0)
+    pixels = 1;
+
+  context.time = frameTime;
+  context.frames = frames;
+  uint16_t end = (nextPixel + pixels < count) ? (nextPixel + pixels) : count;
+  for (uint16_t i = nextPixel; i < end; i++) {
+    context.x = matrix.xs[i];
+    context.y = matrix.ys[i];
+    context.index = matrix.indexes[i];
+    context.pressed = (matrix.masks[i] & pressedMask) ? 1 : 0;
+    context.statics = &statics[i * slots];
+
+    uint8_t channels[3];
+    for (uint8_t c = 0; c < 3; c++) {
+      int32_t value = execute(pixelCode[c].data(), pixelCode[c].size(), context);
+      channels[c] = (value < 0) ? 0 : ((value > 255) ? 255 : value);
+    }
+    matrix.fill(i, frame, RGB(channels[0], channels[1], channels[2]));
+  }
+
+  nextPixel = (end < count) ? end : 0;
+  return nextPixel == 0;
+}
+
+int32_t LEDProgram::sin8(int32_t x) {
+  uint8_t phase = x & 0xFF;
+  uint8_t i = phase & 0x3F;
+  switch (phase >> 6) {
+    case 0:  return 128 + sineTable[i];
+    case 1:  return 128 + sineTable[64 - i];
+    case 2:  return 128 - sineTable[i];
+    default: return 128 - sineTable[64 - i];
+  }
+}
+
+int32_t LEDProgram::execute(const Instruction *code, uint16_t count, const Context &context) {
+  int32_t stack[LED_PROGRAM_MAX_STACK];
+  int8_t top = -1;
+  for (uint16_t pc = 0; pc < count; pc++) {
+    const Instruction &instruction = code[pc];
+    int32_t a, b;
+    switch (instruction.op) {
+      case LED_OP_CONST:   stack[++top] = instruction.imm; continue;
+      case LED_OP_STATIC:  stack[++top] = context.statics[instruction.imm]; continue;
+      case LED_OP_FRAME:   stack[++top] = context.frames[instruction.imm]; continue;
+      case LED_OP_TIME:    stack[++top] = context.time; continue;
+      case LED_OP_X:       stack[++top] = context.x; continue;
+      case LED_OP_Y:       stack[++top] = context.y; continue;
+      case LED_OP_INDEX:   stack[++top] = context.index; continue;
+      case LED_OP_PRESSED: stack[++top] = context.pressed; continue;
+      case LED_OP_NEG:     stack[top] = -(uint32_t)stack[top]; continue;
+      case LED_OP_ABS:     stack[top] = (stack[top] < 0) ? -(uint32_t)stack[top] : stack[top]; continue;
+      case LED_OP_NOT:     stack[top] = (stack[top] == 0); continue;
+      case LED_OP_SIN8:    stack[top] = sin8(stack[top]); continue;
+      case LED_OP_SELECT:
+        b = stack[top--];
+        a = stack[top--];
+        stack[top] = stack[top] ? a : b;
+        continue;
+    }
+
+    b = stack[top--];
+    a = stack[top];
+    switch (instruction.op) {
+      case LED_OP_ADD: a = (uint32_t)a + (uint32_t)b; break;
+      case LED_OP_SUB: a = (uint32_t)a - (uint32_t)b; break;
+      case LED_OP_MUL: a = (uint32_t)a * (uint32_t)b; break;
+      case LED_OP_DIV: a = (b == 0) ? 0 : ((b == -1) ? -(uint32_t)a : a / b); break;
+      case LED_OP_MOD: a = (b == 0 || b == -1) ? 0 : a % b; break;
+      case LED_OP_MIN: a = (a < b) ? a : b; break;
+      case LED_OP_MAX: a = (a > b) ? a : b; break;
+      case LED_OP_AND: a &= b; break;
+      case LED_OP_OR:  a |= b; break;
+      case LED_OP_XOR: a ^= b; break;
+      case LED_OP_SHL: a = (uint32_t)a << (b & 31); break;
+      case LED_OP_SHR: a >>= (b & 31); break;
+      case LED_OP_LT:  a = (a < b); break;
+      case LED_OP_GT:  a = (a > b); break;
+      case LED_OP_EQ:  a = (a == b); break;
+    }
+    stack[top] = a;
+  }
+
+  return (top >= 0) ? stack[top] : 0;
+}
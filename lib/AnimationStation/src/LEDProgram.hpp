@@ -0,0 +1,149 @@
+#ifndef _LED_PROGRAM_H_
+#define _LED_PROGRAM_H_
+
+#include <stdint.h>
+#include <vector>
+#include "Animation.hpp"
+#include "Pixel.hpp"
+
+#define LED_PROGRAM_MAX_SIZE     512  // Bytecode bytes, fits a hex upload in one web config POST
+#define LED_PROGRAM_MAX_STACK    16
+#define LED_PROGRAM_MAX_COMPILED 1024 // Instructions after compiling, DUP-heavy programs can grow
+#define LED_PROGRAM_MAX_CACHE    8    // Cached sub-expressions per kind (per pixel, per frame)
+#define LED_PROGRAM_MAX_DEPTH    32   // Expression nesting, compiling recurses once per level
+
+#ifndef LED_PROGRAM_BUDGET
+#define LED_PROGRAM_BUDGET 8192 // Instructions per frame, larger programs spread a frame over several renders
+#endif
+
+/* Bytecode for user-defined effects. A program runs once per pixel and leaves r, g, b (clamped to
+   0-255) on the stack at END. Values are 32-bit signed; binary ops pop b, then a, and push a op b. */
+typedef enum
+{
+  LED_OP_END = 0,
+  LED_OP_PUSH8,   // imm8, signed
+  LED_OP_PUSH16,  // imm16, signed, little endian
+  LED_OP_TIME,    // Milliseconds since boot
+  LED_OP_X,       // Pixel position, PIXEL_GRID_SIZE units per layout cell
+  LED_OP_Y,
+  LED_OP_INDEX,   // Pixel index
+  LED_OP_PRESSED, // 1 while the pixel's button is held
+  LED_OP_DUP,
+  LED_OP_DROP,
+  LED_OP_SWAP,
+  LED_OP_OVER,
+  LED_OP_ADD,
+  LED_OP_SUB,
+  LED_OP_MUL,
+  LED_OP_DIV,     // Division by zero gives 0
+  LED_OP_MOD,
+  LED_OP_MIN,
+  LED_OP_MAX,
+  LED_OP_AND,
+  LED_OP_OR,
+  LED_OP_XOR,
+  LED_OP_SHL,
+  LED_OP_SHR,     // Arithmetic shift
+  LED_OP_LT,      // 1 or 0
+  LED_OP_GT,
+  LED_OP_EQ,
+  LED_OP_NEG,
+  LED_OP_ABS,
+  LED_OP_NOT,     // 1 if zero, else 0
+  LED_OP_SIN8,    // 0-255 sine, one period per 256
+  LED_OP_SELECT,  // c a b -> c ? a : b
+  LED_OP_PUBLIC_COUNT,
+
+  // Produced by the compiler, never valid in uploaded bytecode
+  LED_OP_CONST = LED_OP_PUBLIC_COUNT, // Folded constant
+  LED_OP_STATIC,  // Per-pixel cached value
+  LED_OP_FRAME,   // Per-frame cached value
+} LEDOpcode;
+
+typedef enum
+{
+  LED_PROGRAM_OK,
+  LED_PROGRAM_EMPTY,
+  LED_PROGRAM_TOO_LARGE,
+  LED_PROGRAM_BAD_OPCODE,
+  LED_PROGRAM_TRUNCATED,       // Immediate runs past the end
+  LED_PROGRAM_STACK_UNDERFLOW,
+  LED_PROGRAM_STACK_OVERFLOW,
+  LED_PROGRAM_NO_END,
+  LED_PROGRAM_BAD_RESULT,      // END without exactly r, g, b on the stack
+  LED_PROGRAM_TOO_COMPLEX,     // Compiled code, stack or nesting too big
+} LEDProgramError;
+
+/* Uploaded bytecode is validated and compiled into an expression graph once. Constant
+   sub-expressions are folded, sub-expressions of only the pixel inputs are cached per pixel
+   at Prepare(), and those of only the time are evaluated once per frame. The per-pixel code
+   that remains only covers what really changes between pixels and frames. */
+class LEDProgram
+{
+public:
+  static LEDProgramError Validate(const uint8_t *code, uint16_t size);
+  static const char *ErrorName(LEDProgramError error);
+
+  LEDProgramError Load(const uint8_t *code, uint16_t size);
+  void Unload();
+  inline bool IsLoaded() const { return loaded; }
+  inline bool UsesTime() const { return usesTime; }
+  inline bool UsesPressed() const { return usesPressed; }
+  inline uint16_t GetPixelCost() const { return pixelCost; } // Instructions per pixel after compiling
+  inline uint32_t GetGeneration() const { return generation; }
+
+  void Prepare(const PixelMatrix &matrix); // Per-pixel cache, after loading or a layout change
+  // Renders up to the instruction budget, continuing where the last call stopped. True once the frame is complete.
+  bool Run(const PixelMatrix &matrix, RGB *frame, uint32_t timeMs, uint32_t pressedMask);
+
+protected:
+  struct Instruction
+  {
+    uint8_t op;
+    int32_t imm;
+  };
+
+  struct Node
+  {
+    uint8_t op;
+    uint8_t deps;
+    uint8_t argc;
+    uint16_t args[3];
+    int32_t imm;
+    int16_t staticSlot;
+    int16_t frameSlot;
+  };
+
+  struct Context
+  {
+    int32_t time;
+    int32_t x;
+    int32_t y;
+    int32_t index;
+    int32_t pressed;
+    const int32_t *statics;
+    const int32_t *frames;
+  };
+
+  static LEDProgramError parse(const uint8_t *code, uint16_t size, std::vector<Node> *nodes, uint16_t *outputs);
+  bool emit(std::vector<Node> &nodes, uint16_t n, std::vector<Instruction> &code, bool cache);
+  static int32_t execute(const Instruction *code, uint16_t count, const Context &context);
+  static int32_t sin8(int32_t x);
+  static uint16_t stackDepth(const std::vector<Instruction> &code);
+
+  bool loaded = false;
+  bool usesTime = false;
+  bool usesPressed = false;
+  uint32_t generation = 0;
+  uint16_t pixelCost = 0;
+  uint16_t frameCost = 0;
+  std::vector<Instruction> pixelCode[3];                      // One expression per channel
+  std::vector<std::vector<Instruction>> staticCode;
+  std::vector<std::vector<Instruction>> frameCode;
+  std::vector<int32_t> statics;                               // Pixel-major, staticCode.size() per pixel
+  int32_t frames[LED_PROGRAM_MAX_CACHE];
+  uint16_t nextPixel = 0;                                     // Resume point when a frame spans several renders
+  uint32_t frameTime = 0;
+};
+
+#endif
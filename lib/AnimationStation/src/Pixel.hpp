@@ -6,48 +6,140 @@
 #include <stdlib.h>
 #include <vector>
 
+#define PIXEL_GRID_SIZE 16 // Fixed-point scale of Pixel x/y, one layout cell = 16 units
+#define PIXEL_NO_BUTTON 0xFF
+#define PIXEL_NO_POSITION INT16_MIN // Pixel x/y taken from its place in the layout grid
+#define PIXEL_MAX_DISTANCE 0xFF
+
+// Bit number of the lowest bit set in a button mask
+constexpr uint8_t buttonBit(uint32_t mask) {
+  uint8_t bit = 0;
+  while (bit < 32 && !(mask & (1UL << bit)))
+    bit++;
+  return (bit < 32) ? bit : PIXEL_NO_BUTTON;
+}
+
+// Integer square root, only used while building the matrix
+inline uint16_t pixelSqrt(uint32_t value) {
+  uint32_t root = 0;
+  uint32_t bit = 1UL << 30;
+  while (bit > value)
+    bit >>= 2;
+
+  while (bit != 0) {
+    if (value >= root + bit) {
+      value -= root + bit;
+      root = (root >> 1) + bit;
+    } else {
+      root >>= 1;
+    }
+    bit >>= 2;
+  }
+
+  return root;
+}
+
 struct Pixel {
   Pixel(int index, uint32_t mask = 0) : index(index), mask(mask) { }
   Pixel(int index, std::vector<uint8_t> positions) : index(index), positions(positions) { }
   Pixel(int index, uint32_t mask, std::vector<uint8_t> positions) : index(index), mask(mask), positions(positions) { }
+  Pixel(int index, uint32_t mask, std::vector<uint8_t> positions, int16_t x, int16_t y)
+    : index(index), mask(mask), positions(positions), x(x), y(y) { }
 
   int index;                      // The pixel index
   uint32_t mask;                  // Used to detect per-pixel lighting
   std::vector<uint8_t> positions; // The actual LED indexes on the chain
+  int16_t x = PIXEL_NO_POSITION;  // Physical position, PIXEL_GRID_SIZE units per layout cell
+  int16_t y = PIXEL_NO_POSITION;
 };
 
 const Pixel NO_PIXEL(-1);
 
+/* The layout is described as columns of Pixels, but stored flat: one entry per lit pixel in
+   each array, and the LED positions of every pixel back to back. Built once by setup(), so
+   effects walk linear memory and the counts never have to be rescanned. */
 struct PixelMatrix {
   PixelMatrix() { }
 
-  std::vector<std::vector<Pixel>> pixels;
-  uint8_t ledsPerPixel;
-  void setup(std::vector<std::vector<Pixel>> pixels, int ledsPerPixel = -1) {
-    this->pixels = pixels;
+  std::vector<int16_t> indexes;        // Pixel index
+  std::vector<uint32_t> masks;         // Button mask
+  std::vector<uint8_t> buttonBits;     // Bit set in the mask, PIXEL_NO_BUTTON if none
+  std::vector<uint16_t> positionStart; // First entry in positions, plus one extra entry for the end
+  std::vector<uint8_t> positions;      // LED indexes on the chain
+  std::vector<uint8_t> cols;           // Column in the layout
+  std::vector<uint8_t> rows;           // Row within the column
+  std::vector<int16_t> xs;             // Pixel center, PIXEL_GRID_SIZE units per cell
+  std::vector<int16_t> ys;
+  std::vector<uint8_t> distances;      // size() x size() table of pixel distances, saturates at PIXEL_MAX_DISTANCE
+  uint8_t ledsPerPixel = 0;
+  uint16_t pixelCount = 0;             // Layout cells, including empty ones
+  uint16_t ledCount = 0;
+
+  void setup(const std::vector<std::vector<Pixel>> &layout, int ledsPerPixel = -1) {
     this->ledsPerPixel = ledsPerPixel;
-  }
+    indexes.clear();
+    masks.clear();
+    buttonBits.clear();
+    positionStart.clear();
+    positions.clear();
+    cols.clear();
+    rows.clear();
+    xs.clear();
+    ys.clear();
+    distances.clear();
+    pixelCount = 0;
 
-  inline int getLedCount() {
-    int count = 0;
-    for (auto &col : pixels)
-      for (auto &pixel : col)
+    for (size_t c = 0; c < layout.size(); c++) {
+      pixelCount += layout[c].size();
+      for (size_t r = 0; r < layout[c].size(); r++) {
+        const Pixel &pixel = layout[c][r];
         if (pixel.index == NO_PIXEL.index)
           continue;
-        else
-          count += pixel.positions.size();
 
-    return count;
-  }
+        indexes.push_back(pixel.index);
+        masks.push_back(pixel.mask);
+        buttonBits.push_back(buttonBit(pixel.mask));
+        positionStart.push_back(positions.size());
+        positions.insert(positions.end(), pixel.positions.begin(), pixel.positions.end());
+        cols.push_back(c);
+        rows.push_back(r);
+        xs.push_back((pixel.x != PIXEL_NO_POSITION) ? pixel.x : (c * PIXEL_GRID_SIZE) + (PIXEL_GRID_SIZE / 2));
+        ys.push_back((pixel.y != PIXEL_NO_POSITION) ? pixel.y : (r * PIXEL_GRID_SIZE) + (PIXEL_GRID_SIZE / 2));
+      }
+    }
+
+    positionStart.push_back(positions.size());
+    ledCount = positions.size();
 
-  inline uint16_t getPixelCount() const {
-    uint16_t count = 0;
-    for (auto &col : pixels)
-      count += col.size();
+    // Reactive effects look distances up instead of doing any per-frame geometry
+    uint16_t count = size();
+    distances.assign(count * count, 0);
+    for (uint16_t a = 0; a < count; a++) {
+      for (uint16_t b = a + 1; b < count; b++) {
+        int32_t dx = xs[a] - xs[b];
+        int32_t dy = ys[a] - ys[b];
+        uint16_t distance = pixelSqrt((dx * dx) + (dy * dy));
+        if (distance > PIXEL_MAX_DISTANCE)
+          distance = PIXEL_MAX_DISTANCE;
 
-    return count;
+        distances[(a * count) + b] = distance;
+        distances[(b * count) + a] = distance;
+      }
+    }
   }
 
+  inline uint8_t distance(uint16_t a, uint16_t b) const { return distances[(a * size()) + b]; }
+
+  inline uint16_t size() const { return indexes.size(); } // Lit pixels stored
+  inline int getLedCount() const { return ledCount; }
+  inline uint16_t getPixelCount() const { return pixelCount; }
+
+  // Fill every LED of one pixel
+  template<typename T>
+  inline void fill(uint16_t i, T *frame, const T &value) const {
+    for (uint16_t p = positionStart[i]; p != positionStart[i + 1]; p++)
+      frame[positions[p]] = value;
+  }
 };
 
 inline bool operator==(const Pixel &lhs, const Pixel &rhs) {
@@ -13,8 +13,32 @@
 #include <hardware/flash.h>
 #include <hardware/timer.h>
 
-#define EEPROM_SIZE_BYTES    4096           // Reserve 4k of flash memory (ensure this value is divisible by 256)
-#define EEPROM_ADDRESS_START _u(0x101FF000) // The arduino-pico EEPROM lib starts here, so we'll do the same
+/* Storage is split into two flash sectors (slots) used in a ping-pong fashion. Each slot ends
+	with a header, so the header is the last thing programmed and a slot interrupted by a power
+	loss never looks valid. Commits always target the inactive slot, so the live copy survives. */
+struct FlashPROMHeader
+{
+	uint32_t magic;
+	uint16_t version;
+	uint16_t size;
+	uint32_t generation;
+	uint32_t checksum;
+};
+
+struct FlashPROMStats
+{
+	uint32_t commits;   // Writes to flash since boot
+	uint32_t lastStall; // Microseconds the last write held off both cores
+	uint32_t maxStall;
+};
+
+#define EEPROM_SLOT_SIZE      FLASH_SECTOR_SIZE  // One flash sector per slot (4k)
+#define EEPROM_SLOT_COUNT     2
+#define EEPROM_SIZE_BYTES     (EEPROM_SLOT_SIZE - sizeof(FlashPROMHeader)) // Usable bytes, header lives at the end of the slot
+#define EEPROM_ADDRESS_START  _u(0x101FE000) // Slot A, slot B follows directly after
+#define EEPROM_LEGACY_ADDRESS _u(0x101FF000) // Old single-sector location (arduino-pico EEPROM), also slot B
+#define EEPROM_HEADER_MAGIC   0x4D525046     // "FPRM"
+#define EEPROM_HEADER_VERSION 1
 // Warning: If the write wait is too long it can stall other processes
 #define EEPROM_WRITE_WAIT    50             // Amount of time in ms to wait before blocking core1 and committing to flash
 
@@ -24,6 +48,7 @@ class FlashPROM
 		void start();
 		void commit();
 		void reset();
+		static FlashPROMStats getStats();
 
 		template<typename T>
 		T &get(uint16_t const index, T &value)
@@ -44,7 +69,7 @@ class FlashPROM
 		}
 
 	private:
-		static uint8_t cache[EEPROM_SIZE_BYTES];
+		static uint8_t cache[EEPROM_SLOT_SIZE];
 };
 
 static FlashPROM EEPROM;
@@ -4,25 +4,84 @@
  */
 
 #include "FlashPROM.h"
+#include "CRC32.h"
 
-uint8_t FlashPROM::cache[EEPROM_SIZE_BYTES] = { };
+uint8_t FlashPROM::cache[EEPROM_SLOT_SIZE] = { };
 volatile static alarm_id_t flashWriteAlarm = 0;
 volatile static spin_lock_t *flashLock = nullptr;
+volatile static int activeSlot = -1;        // Slot holding the live copy, -1 if none (new or legacy flash)
+volatile static uint32_t activeGeneration = 0;
+static bool loaded = false;
+static FlashPROMStats stats = { };
+
+static inline uint8_t *slotAddress(int slot)
+{
+	return reinterpret_cast<uint8_t *>(EEPROM_ADDRESS_START + (slot * EEPROM_SLOT_SIZE));
+}
+
+static inline FlashPROMHeader *slotHeader(uint8_t *slot)
+{
+	return reinterpret_cast<FlashPROMHeader *>(slot + EEPROM_SIZE_BYTES);
+}
+
+static bool isValidSlot(int slot)
+{
+	FlashPROMHeader *header = slotHeader(slotAddress(slot));
+	return header->magic == EEPROM_HEADER_MAGIC
+		&& header->version == EEPROM_HEADER_VERSION
+		&& header->size == EEPROM_SIZE_BYTES
+		&& header->checksum == CRC32::calculate(slotAddress(slot), EEPROM_SIZE_BYTES);
+}
+
+// Pick the newest slot from the headers alone, only falling back to the other slot if its data fails the CRC
+static int findActiveSlot()
+{
+	FlashPROMHeader *a = slotHeader(slotAddress(0));
+	FlashPROMHeader *b = slotHeader(slotAddress(1));
+	int newest = ((int32_t)(b->generation - a->generation) > 0) ? 1 : 0;
+
+	if (isValidSlot(newest))
+		return newest;
+	else if (isValidSlot(newest ^ 1))
+		return newest ^ 1;
+
+	return -1;
+}
 
 int64_t writeToFlash(alarm_id_t id, void *flashCache)
 {
 	while (is_spin_locked(flashLock));
 
+	uint32_t stallStart = time_us_32();
 	multicore_lockout_start_blocking();
 	uint32_t interrupts = spin_lock_blocking(flashLock);
 
-	flash_range_erase((intptr_t)EEPROM_ADDRESS_START - (intptr_t)XIP_BASE, EEPROM_SIZE_BYTES);
-	flash_range_program((intptr_t)EEPROM_ADDRESS_START - (intptr_t)XIP_BASE, reinterpret_cast<uint8_t *>(flashCache), EEPROM_SIZE_BYTES);
+	// Always write the inactive slot, the live copy stays intact until the new header is programmed
+	int targetSlot = (activeSlot == 0) ? 1 : 0;
+	uint8_t *data = reinterpret_cast<uint8_t *>(flashCache);
+	FlashPROMHeader *header = slotHeader(data);
+	header->magic = EEPROM_HEADER_MAGIC;
+	header->version = EEPROM_HEADER_VERSION;
+	header->size = EEPROM_SIZE_BYTES;
+	header->generation = activeGeneration + 1;
+	header->checksum = CRC32::calculate(data, EEPROM_SIZE_BYTES);
+
+	intptr_t offset = (intptr_t)slotAddress(targetSlot) - (intptr_t)XIP_BASE;
+	flash_range_erase(offset, EEPROM_SLOT_SIZE);
+	flash_range_program(offset, data, EEPROM_SLOT_SIZE);
+
+	activeSlot = targetSlot;
+	activeGeneration = header->generation;
 
 	flashWriteAlarm = 0;
 	multicore_lockout_end_blocking();
 	spin_unlock(flashLock, interrupts);
 
+	stats.commits++;
+	stats.lastStall = time_us_32() - stallStart;
+	if (stats.lastStall > stats.maxStall)
+		stats.maxStall = stats.lastStall;
+
 	return 0;
 }
 
@@ -31,12 +90,32 @@ void FlashPROM::start()
 	if (flashLock == nullptr)
 		flashLock = spin_lock_instance(spin_lock_claim_unused(true));
 
-	memcpy(cache, reinterpret_cast<uint8_t *>(EEPROM_ADDRESS_START), EEPROM_SIZE_BYTES);
+	// Storage and GamepadStorage both start the EEPROM, only read flash once so pending changes aren't dropped
+	if (loaded)
+		return;
+
+	loaded = true;
+
+	int slot = findActiveSlot();
+	if (slot != -1)
+	{
+		memcpy(cache, slotAddress(slot), EEPROM_SLOT_SIZE);
+		activeSlot = slot;
+		activeGeneration = slotHeader(cache)->generation;
+		return;
+	}
+
+	// No valid slot, so this is either new flash or the old single-sector layout. Load the legacy
+	// data; the next commit goes to slot A, so the legacy copy survives until a newer one exists.
+	activeSlot = -1;
+	activeGeneration = 0;
+	memcpy(cache, reinterpret_cast<uint8_t *>(EEPROM_LEGACY_ADDRESS), EEPROM_SIZE_BYTES);
+	memset(slotHeader(cache), 0, sizeof(FlashPROMHeader));
 
 	// When flash is new/reset, all bits are set to 1.
 	// If all bits from the FlashPROM section are 1's then set to 0's.
 	bool reset = true;
-	for (int i = 0; i < EEPROM_SIZE_BYTES; i++)
+	for (uint16_t i = 0; i < EEPROM_SIZE_BYTES; i++)
 	{
 		if (cache[i] != 0xFF)
 		{
@@ -59,6 +138,11 @@ void FlashPROM::commit()
 	flashWriteAlarm = add_alarm_in_ms(EEPROM_WRITE_WAIT, writeToFlash, cache, true);
 }
 
+FlashPROMStats FlashPROM::getStats()
+{
+	return stats;
+}
+
 void FlashPROM::reset()
 {
 	memset(cache, 0, EEPROM_SIZE_BYTES);
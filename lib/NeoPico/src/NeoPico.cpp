@@ -12,54 +12,166 @@
 #include "pico/stdlib.h"
 #include "hardware/pio.h"
 #include "hardware/clocks.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "hardware/timer.h"
 #include "NeoPico.hpp"
 
-LEDFormat NeoPico::GetFormat() {
-  return format;
+// DMA channel -> instance, for the shared completion IRQ
+static NeoPico *dmaOwners[NUM_DMA_CHANNELS] = { };
+
+static inline bool isRGBW(LEDFormat format) {
+  return (format == LED_FORMAT_GRBW) || (format == LED_FORMAT_RGBW);
 }
 
-void NeoPico::PutPixel(uint32_t pixelData) {
-  switch (format) {
-    case LED_FORMAT_GRB:
-    case LED_FORMAT_RGB:
-      pio_sm_put_blocking(pio0, 0, pixelData << 8u);
-      break;
+// Repack a pixel for a chain that uses a different format than the frame
+static uint32_t convertPixel(uint32_t value, LEDFormat from, LEDFormat to) {
+  uint8_t r, g, b, w = 0;
+  switch (from) {
+    case LED_FORMAT_GRB:  g = value >> 16; r = value >> 8; b = value; break;
+    case LED_FORMAT_RGB:  r = value >> 16; g = value >> 8; b = value; break;
     case LED_FORMAT_GRBW:
     case LED_FORMAT_RGBW:
-      pio_sm_put_blocking(pio0, 0, pixelData);
+      if (value <= 0xFF) { // White only
+        r = g = b = value;
+      } else if (from == LED_FORMAT_GRBW) {
+        g = value >> 24; r = value >> 16; b = value >> 8; w = value;
+      } else {
+        r = value >> 24; g = value >> 16; b = value >> 8; w = value;
+      }
       break;
   }
+
+  switch (to) {
+    case LED_FORMAT_GRB:  return (g << 16) | (r << 8) | b;
+    case LED_FORMAT_RGB:  return (r << 16) | (g << 8) | b;
+    case LED_FORMAT_GRBW: return (r == g && r == b) ? r : ((g << 24) | (r << 16) | (b << 8) | w);
+    case LED_FORMAT_RGBW: return (r == g && r == b) ? r : ((r << 24) | (g << 16) | (b << 8) | w);
+  }
+
+  return 0;
 }
 
-NeoPico::NeoPico(int ledPin, int numPixels, LEDFormat format) : format(format), numPixels(numPixels) {
-  PIO pio = pio0;
-  int sm = 0;
-  uint offset = pio_add_program(pio, &ws2812_program);
-  bool rgbw = (format == LED_FORMAT_GRBW) || (format == LED_FORMAT_RGBW);
-  ws2812_program_init(pio, sm, offset, ledPin, 800000, rgbw);
-  this->Clear();
-  sleep_ms(10);
+LEDFormat NeoPico::GetFormat() {
+  return format;
 }
 
-void NeoPico::Clear() {
-  memset(frame, 0, sizeof(frame));
+NeoPico::NeoPico(int ledPin, int numPixels, LEDFormat format, PIO pio) : format(format), numPixels(numPixels) {
+  if (ledPin < 0 || numPixels <= 0) {
+    this->numPixels = 0;
+    return;
+  }
+
+  // Chains share one copy of the program per PIO block
+  ResourceManager &resources = ResourceManager::getInstance();
+  if (!resources.ClaimStateMachine(&ws2812_program, "NeoPico", claim, pio)) {
+    this->numPixels = 0;
+    return;
+  }
+
+  dmaChannel = resources.ClaimDMA("NeoPico");
+  if (dmaChannel < 0) {
+    resources.ReleaseStateMachine(claim);
+    this->numPixels = 0;
+    return;
+  }
+
+  ws2812_program_init(claim.pio, claim.sm, claim.offset, ledPin, 800000, isRGBW(format));
+
+  buffers[0] = new uint32_t[numPixels * 2]();
+  buffers[1] = buffers[0] + numPixels;
+
+  dmaOwners[dmaChannel] = this;
+
+  dma_channel_config config = dma_channel_get_default_config(dmaChannel);
+  channel_config_set_transfer_data_size(&config, DMA_SIZE_32);
+  channel_config_set_read_increment(&config, true);
+  channel_config_set_write_increment(&config, false);
+  channel_config_set_dreq(&config, pio_get_dreq(claim.pio, claim.sm, true));
+  dma_channel_configure(dmaChannel, &config, &claim.pio->txf[claim.sm], nullptr, numPixels, false);
+
+  resources.AddIRQHandler(DMA_IRQ_0, NeoPico::dmaHandler);
+  dma_channel_set_irq0_enabled(dmaChannel, true);
+
+  // Hold the line low long enough to latch before the first frame
+  latchTime = time_us_64() + NEO_PICO_RESET_US;
 }
 
-void NeoPico::SetFrame(uint32_t newFrame[100]) {
-  memcpy(frame, newFrame, sizeof(frame));
+NeoPico::~NeoPico() {
+  ResourceManager &resources = ResourceManager::getInstance();
+  if (dmaChannel >= 0) {
+    dma_channel_set_irq0_enabled(dmaChannel, false);
+    dma_channel_abort(dmaChannel);
+    dma_channel_acknowledge_irq0(dmaChannel);
+    dmaOwners[dmaChannel] = nullptr;
+    resources.ReleaseDMA(dmaChannel);
+    resources.RemoveIRQHandler(DMA_IRQ_0, NeoPico::dmaHandler);
+  }
+
+  resources.ReleaseStateMachine(claim);
+
+  delete[] buffers[0];
+}
+
+void NeoPico::dmaHandler() {
+  for (int channel = 0; channel < NUM_DMA_CHANNELS; channel++) {
+    if (dmaOwners[channel] != nullptr && dma_channel_get_irq0_status(channel)) {
+      dma_channel_acknowledge_irq0(channel);
+      dmaOwners[channel]->transferComplete();
+    }
+  }
+}
+
+void NeoPico::transferComplete() {
+  // The FIFO still has words to shift out, the latch starts once it is empty
+  latchTime = time_us_64() + (NEO_PICO_FIFO_WORDS * NEO_PICO_WORD_US) + NEO_PICO_RESET_US;
+  transmitTime = (uint32_t)(latchTime - transmitStart);
+  transferring = false;
+}
+
+bool NeoPico::IsBusy() {
+  return transferring || (time_us_64() < latchTime);
 }
 
-void NeoPico::Show() {
-  for (int i = 0; i < this->numPixels; ++i) {
-     this->PutPixel(this->frame[i]);
+void NeoPico::Clear() {
+  if (numPixels > 0)
+    memset(buffers[backBuffer], 0, numPixels * sizeof(uint32_t));
+}
+
+void NeoPico::SetFrame(const uint32_t *newFrame, LEDFormat frameFormat) {
+  // The PIO shifts out MSB first, 24-bit formats sit in the top of the word
+  uint32_t *buffer = buffers[backBuffer];
+  uint8_t shift = isRGBW(format) ? 0 : 8;
+  if (frameFormat == format) {
+    for (int i = 0; i < numPixels; ++i)
+      buffer[i] = newFrame[i] << shift;
+  } else {
+    for (int i = 0; i < numPixels; ++i)
+      buffer[i] = convertPixel(newFrame[i], frameFormat, format) << shift;
   }
-  sleep_ms(10);
+}
+
+bool NeoPico::Show() {
+  if (dmaChannel < 0 || IsBusy())
+    return false;
+
+  // Send the finished frame and render the next one into the other buffer
+  uint8_t frontBuffer = backBuffer;
+  backBuffer ^= 1;
+
+  transferring = true;
+  transmitStart = time_us_64();
+  dma_channel_transfer_from_buffer_now(dmaChannel, buffers[frontBuffer], numPixels);
+  return true;
 }
 
 void NeoPico::Off() {
+  if (dmaChannel < 0)
+    return;
+
+  while (IsBusy())
+    tight_loop_contents();
+
   Clear();
-  for (int i = 0; i < this->numPixels; ++i) {
-     this->PutPixel(this->frame[i]);
-  }
-  sleep_ms(10);
+  Show();
 }
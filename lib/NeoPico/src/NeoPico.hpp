@@ -2,8 +2,14 @@
 #define _NEO_PICO_H_
 
 #include "ws2812.pio.h"
+#include "pico/types.h"
+#include "ResourceManager.hpp"
 #include <vector>
 
+#define NEO_PICO_RESET_US   300 // Low time that latches a frame (WS2812B datasheet asks for > 280us)
+#define NEO_PICO_WORD_US    40  // Wire time of one FIFO word (32 bits at 800kHz)
+#define NEO_PICO_FIFO_WORDS 8   // Joined TX FIFO depth, still shifting out after DMA completes
+
 typedef enum
 {
   LED_FORMAT_GRB = 0,
@@ -12,22 +18,39 @@ typedef enum
   LED_FORMAT_RGBW = 3,
 } LEDFormat;
 
+/* One LED chain on its own PIO state machine. Frames are formatted into a back buffer while
+   the front buffer is streamed to the PIO TX FIFO by DMA. The DMA completion IRQ starts the
+   reset latch, which is tracked against the hardware timer so nothing sleeps. Chains on
+   separate state machines transmit concurrently. A chain that can't get a state machine or
+   DMA channel from the ResourceManager stays inert with no pixels. */
 class NeoPico
 {
 public:
-  NeoPico(int ledPin, int numPixels, LEDFormat format = LED_FORMAT_GRB);
-  void Show();
+  NeoPico(int ledPin, int numPixels, LEDFormat format = LED_FORMAT_GRB, PIO pio = pio0); // pio is preferred, not required
+  ~NeoPico();
+  bool Show();   // Starts sending the back buffer, false if the previous frame is still going out
   void Clear();
   void Off();
+  bool IsBusy(); // Transfer or reset latch in progress
   LEDFormat GetFormat();
+  int GetPixelCount() { return numPixels; }
+  uint32_t GetTransmitTime() { return transmitTime; } // Microseconds from Show() to the end of the latch for the last frame
   // void SetPixel(int pixel, uint32_t color);
-  void SetFrame(uint32_t newFrame[100]);
+  void SetFrame(const uint32_t *newFrame, LEDFormat frameFormat); // numPixels values packed as frameFormat
+  void SetFrame(const uint32_t *newFrame) { SetFrame(newFrame, format); }
 private:
-  void PutPixel(uint32_t pixel_grb);
+  static void dmaHandler();
+  void transferComplete();
   LEDFormat format;
-  PIO pio = pio0;
+  PIOClaim claim = { pio0, -1, -1, nullptr };
+  int dmaChannel = -1;
   int numPixels = 0;
-  uint32_t frame[100];
+  uint32_t *buffers[2] = { nullptr, nullptr }; // Pre-formatted FIFO words
+  uint8_t backBuffer = 0;
+  volatile bool transferring = false;
+  volatile uint64_t latchTime = 0; // Timer value when the line has been low long enough
+  uint64_t transmitStart = 0;
+  volatile uint32_t transmitTime = 0;
 };
 
 #endif
@@ -21,6 +21,9 @@
 #include <stdio.h>
 #include <string.h>
 #include "pico/stdlib.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "ResourceManager.hpp"
 
 #include "BitBang_I2C.h"
 #include "OneBitDisplay.h"
@@ -237,6 +240,9 @@ void obdSPIInit(OBDISP *pOBD, int iType, int iDC, int iCS, int iReset, int iMOSI
 	pOBD->invert = bInvert;
 	pOBD->wrap = 0;           // default - disable text wrap
 	pOBD->com_mode = COM_SPI; // communication mode
+	pOBD->iDMAChannel = -1; // asynchronous flushes are I2C only
+	pOBD->bFlushing = pOBD->bDraining = 0;
+	pOBD->pfnFlushDone = NULL;
 
 	gpio_set_dir(pOBD->iCSPin, true);
 	gpio_put(pOBD->iCSPin, 0); //(pOBD->type < SHARP_144x168)); // set to not-active
@@ -442,6 +448,9 @@ int obdI2CInit(OBDISP *pOBD, int iType, int iAddr, int bFlip, int bInvert, int b
 	pOBD->bbi2c.picoI2C = picoI2C;
 	pOBD->bbi2c.bWire = bWire;
 	pOBD->com_mode = COM_I2C; // communication mode
+	pOBD->iDMAChannel = -1; // claimed on the first asynchronous flush
+	pOBD->bFlushing = pOBD->bDraining = 0;
+	pOBD->pfnFlushDone = NULL;
 
 	I2CInit(&pOBD->bbi2c, iSpeed); // on Linux, SDA = bus number, SCL = device address
 
@@ -807,6 +816,159 @@ void obdDumpBuffer(OBDISP *pOBD, uint8_t *pBuffer)
 	obdCachedFlush(pOBD, 1);
 } /* obdDumpBuffer() */
 
+static void obdDMAHandler(void)
+{
+	OBDISP *pOBD = pFlushOBD;
+
+	if (pOBD == NULL || pOBD->iDMAChannel < 0 || !dma_channel_get_irq1_status(pOBD->iDMAChannel))
+		return;
+
+	dma_channel_acknowledge_irq1(pOBD->iDMAChannel);
+	pOBD->bFlushing = 0;
+	if (pOBD->pfnFlushDone)
+		(*pOBD->pfnFlushDone)(pOBD);
+} /* obdDMAHandler() */
+
+//
+// Wait for a running flush, including the words still in the I2C FIFO
+//
+static void obdFlushWait(OBDISP *pOBD)
+{
+	i2c_hw_t *hw;
+
+	if (pOBD->iDMAChannel < 0 || !pOBD->bDraining)
+		return;
+
+	while (pOBD->bFlushing)
+		tight_loop_contents();
+
+	hw = i2c_get_hw(pOBD->bbi2c.picoI2C);
+	while (!(hw->status & I2C_IC_STATUS_TFE_BITS) || (hw->status & I2C_IC_STATUS_MST_ACTIVITY_BITS))
+		tight_loop_contents();
+	pOBD->bDraining = 0;
+} /* obdFlushWait() */
+
+static int obdClaimFlushDMA(OBDISP *pOBD)
+{
+	dma_channel_config c;
+	i2c_inst_t *pI2C = pOBD->bbi2c.picoI2C;
+
+	if (pFlushOBD != NULL && pFlushOBD != pOBD)
+		return 0; // only one display can flush asynchronously
+
+	pOBD->iDMAChannel = ResourceManager::getInstance().ClaimDMA("OLED");
+	if (pOBD->iDMAChannel < 0)
+		return 0;
+
+	c = dma_channel_get_default_config(pOBD->iDMAChannel);
+	channel_config_set_transfer_data_size(&c, DMA_SIZE_16);
+	channel_config_set_read_increment(&c, true);
+	channel_config_set_write_increment(&c, false);
+	channel_config_set_dreq(&c, (i2c_hw_index(pI2C) == 0) ? DREQ_I2C0_TX : DREQ_I2C1_TX);
+	dma_channel_configure(pOBD->iDMAChannel, &c, &i2c_get_hw(pI2C)->data_cmd, u16Stream, 0, false);
+
+	pFlushOBD = pOBD;
+	pOBD->bFlushing = 0;
+	pOBD->bDraining = 0;
+	ResourceManager::getInstance().AddIRQHandler(DMA_IRQ_1, obdDMAHandler);
+	dma_channel_set_irq1_enabled(pOBD->iDMAChannel, true);
+	return 1;
+} /* obdClaimFlushDMA() */
+
+int obdDumpBufferAsync(OBDISP *pOBD, uint8_t *pBuffer)
+{
+	int y, x, iPage, iLines, iPitch;
+	uint16_t *d, *pStart;
+	uint8_t *s, *pShown;
+	i2c_inst_t *pI2C = pOBD->bbi2c.picoI2C;
+	i2c_hw_t *hw;
+
+	if (pOBD->type == LCD_VIRTUAL) // wrong function for this type of display
+		return 0;
+	if (pBuffer == NULL) // dump the internal buffer if none is given
+		pBuffer = pOBD->ucScreen;
+	if (pBuffer == NULL)
+		return 0; // no backbuffer and no provided buffer
+
+	iPitch = pOBD->width;
+	iLines = pOBD->height >> 3;
+	if (pOBD->com_mode != COM_I2C || pOBD->type >= SHARP_144x168 || iLines > OBD_ASYNC_MAX_PAGES || iPitch > OBD_ASYNC_MAX_WIDTH
+		|| (pOBD->iDMAChannel < 0 && !obdClaimFlushDMA(pOBD)))
+	{
+		obdDumpBuffer(pOBD, pBuffer); // no DMA for this display, send it the blocking way
+		return 0;
+	}
+	if (pOBD->bFlushing)
+		return -1; // still sending the last one, keep drawing and try again later
+
+	// A NACK aborts the transfer and flushes the FIFO, send everything again
+	hw = i2c_get_hw(pI2C);
+	if (hw->raw_intr_stat & I2C_IC_RAW_INTR_STAT_TX_ABRT_BITS)
+	{
+		(void)hw->clr_tx_abrt;
+		pShownOBD = NULL;
+		obdFlushWait(pOBD);
+	}
+
+	// Every changed page becomes one transaction ending in a STOP: the page and column
+	// commands, each behind a 0x80 control byte (Co = 1), then 0x40 and the page data
+	d = u16Stream;
+	s = pBuffer;
+	pShown = u8Shown;
+	for (y = 0; y < iLines; y++, s += iPitch, pShown += iPitch)
+	{
+		if (pShownOBD == pOBD && memcmp(s, pShown, iPitch) == 0)
+			continue; // the panel already shows this page
+		memcpy(pShown, s, iPitch);
+
+		x = 0;
+		iPage = y;
+		obdPanelPosition(pOBD, &x, &iPage);
+		pStart = d;
+		*d++ = 0x80;
+		*d++ = 0xb0 | iPage;
+		*d++ = 0x80;
+		*d++ = x & 0xf;
+		*d++ = 0x80;
+		*d++ = 0x10 | (x >> 4);
+		*d++ = 0x40;
+		for (x = 0; x < iPitch; x++)
+			*d++ = s[x];
+		d[-1] |= I2C_IC_DATA_CMD_STOP_BITS;
+		if (pStart == u16Stream && pI2C->restart_on_next)
+			pStart[0] |= I2C_IC_DATA_CMD_RESTART_BITS; // the last blocking write kept the bus
+	}
+	pShownOBD = pOBD;
+
+	if (d == u16Stream)
+		return 0; // nothing changed
+
+	// The address can only be set while the block is idle, a previous flush leaves it set up
+	if (!pOBD->bDraining)
+	{
+		hw->enable = 0;
+		hw->tar = pOBD->oled_addr;
+		hw->dma_cr = I2C_IC_DMA_CR_TDMAE_BITS;
+		hw->enable = 1;
+	}
+	pI2C->restart_on_next = false;
+
+	pOBD->bFlushing = 1;
+	pOBD->bDraining = 1;
+	dma_channel_transfer_from_buffer_now(pOBD->iDMAChannel, u16Stream, d - u16Stream);
+	return 1;
+} /* obdDumpBufferAsync() */
+
+int obdFlushBusy(OBDISP *pOBD)
+{
+	return pOBD->bFlushing;
+} /* obdFlushBusy() */
+
+void obdSetFlushCallback(OBDISP *pOBD, void (*pfnFlushDone)(OBDISP *pOBD))
+{
+	pOBD->pfnFlushDone = pfnFlushDone;
+} /* obdSetFlushCallback() */
+
 // A valid CW or CCW move returns 1 or -1, invalid returns 0.
 static int obdMenuReadRotary(SIMPLEMENU *sm)
 {
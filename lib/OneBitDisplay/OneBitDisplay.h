@@ -38,6 +38,10 @@ uint8_t mode; // data/command mode for 9-bit SPI
 uint8_t iDCPin, iMOSIPin, iCLKPin, iCSPin;
 uint8_t iLEDPin; // backlight
 uint8_t bBitBang;
+int iDMAChannel; // claimed by the first asynchronous flush, -1 until then
+volatile uint8_t bFlushing; // DMA transfer of a flush running
+uint8_t bDraining; // last I2C traffic was an asynchronous flush, the FIFO may still be sending it
+void (*pfnFlushDone)(struct obdstruct *pOBD);
 } OBDISP;
 
 typedef char * (*SIMPLECALLBACK)(int iMenuItem);
@@ -281,6 +285,23 @@ int obdSetPixel(OBDISP *pOBD, int x, int y, unsigned char ucColor, int bRender);
 //
 void obdDumpBuffer(OBDISP *pOBD, uint8_t *pBuffer);
 //
+// Start sending the pages that changed since the last asynchronous flush with I2C DMA
+// and return without waiting. The data is copied into a transfer buffer first, so drawing
+// into the back buffer can carry on while it is sent.
+// Returns 1 when a transfer was started, 0 when nothing changed (or the display can't be
+// flushed asynchronously and was written the blocking way) and -1 if the previous flush is
+// still running, in which case the caller should try again later
+//
+int obdDumpBufferAsync(OBDISP *pOBD, uint8_t *pBuffer);
+//
+// Returns 1 while an asynchronous flush is being transferred
+//
+int obdFlushBusy(OBDISP *pOBD);
+//
+// Called from the DMA interrupt once a flush has been handed to the I2C block
+//
+void obdSetFlushCallback(OBDISP *pOBD, void (*pfnFlushDone)(OBDISP *pOBD));
+//
 // Render a window of pixels from a provided buffer or the library's internal buffer
 // to the display. The row values refer to byte rows, not pixel rows due to the memory
 // layout of OLEDs. Pass a src pointer of NULL to use the internal backing buffer
@@ -566,6 +566,16 @@ const uint8_t ucSmallFont[] = {
 static uint8_t u8Cache[MAX_CACHE]; // for faster character drawing
 static volatile uint8_t u8End = 0;
 
+// Asynchronous flushes go out as 16-bit I2C data/command words, 7 for the page
+// and column commands plus one per column, for every page that changed
+#define OBD_ASYNC_MAX_PAGES 8
+#define OBD_ASYNC_MAX_WIDTH 128
+#define OBD_ASYNC_PAGE_HEADER 7
+static uint16_t u16Stream[OBD_ASYNC_MAX_PAGES * (OBD_ASYNC_PAGE_HEADER + OBD_ASYNC_MAX_WIDTH)];
+static uint8_t u8Shown[OBD_ASYNC_MAX_PAGES * OBD_ASYNC_MAX_WIDTH]; // what the panel shows after the last flush
+static OBDISP *pShownOBD = NULL; // display u8Shown belongs to, NULL when unknown
+static OBDISP *pFlushOBD = NULL; // display that owns the DMA interrupt
+
 static void obdCachedFlush(OBDISP *pOBD, int bRender)
 {
 	if (u8End > 0)
@@ -586,8 +596,14 @@ static void obdCachedWrite(OBDISP *pOBD, uint8_t *pData, uint8_t u8Len, int bRen
 
 } /* obdCachedWrite() */
 
+static void obdFlushWait(OBDISP *pOBD);
+
 static void _I2CWrite(OBDISP *pOBD, unsigned char *pData, int iLen)
 {
+	obdFlushWait(pOBD); // blocking writes can't be mixed into a running flush
+	if (pShownOBD == pOBD)
+		pShownOBD = NULL; // the panel no longer matches the last flush
+
 	if (pOBD->com_mode == COM_SPI) // we're writing to SPI, treat it differently
 	{
 		if (pOBD->iDCPin != 0xff)
@@ -697,6 +713,8 @@ void obdCreateVirtualDisplay(OBDISP *pOBD, int width, int height, uint8_t *buffe
 		pOBD->ucScreen = buffer;
 		pOBD->iCursorX = pOBD->iCursorY = 0;
 		pOBD->iScreenOffset = 0;
+		pOBD->iDMAChannel = -1;
+		pOBD->bFlushing = pOBD->bDraining = 0;
 	}
 } /* obdCreateVirtualDisplay() */
 //
@@ -747,28 +765,13 @@ int obdScrollBuffer(OBDISP *pOBD, int iStartCol, int iEndCol, int iStartRow, int
 	return 0;
 } /* obdScrollBuffer() */
 //
-// Send commands to position the "cursor" (aka memory write address)
-// to the given row and column
+// Translate a buffer position into controller RAM coordinates
+// for displays that only show part of the controller's memory
 //
-void obdSetPosition(OBDISP *pOBD, int x, int y, int bRender)
+static void obdPanelPosition(OBDISP *pOBD, int *px, int *py)
 {
-	unsigned char buf[4];
-	int iPitch = pOBD->width;
-
-	obdCachedFlush(pOBD, bRender); // flush any cached data first
-
-	pOBD->iScreenOffset = (y * iPitch) + x;
+	int x = *px, y = *py;
 
-	if (pOBD->type == LCD_VIRTUAL || pOBD->type >= SHARP_144x168)
-		return; // nothing to do
-	if (!bRender)
-		return; // don't send the commands to the OLED if we're not rendering the graphics now
-	if (pOBD->type == LCD_NOKIA5110)
-	{
-		obdWriteCommand(pOBD, 0x40 | y);
-		obdWriteCommand(pOBD, 0x80 | x);
-		return;
-	}
 	if (pOBD->type == OLED_64x32) // visible display starts at column 32, row 4
 	{
 		x += 32;             // display is centered in VRAM, so this is always true
@@ -794,6 +797,33 @@ void obdSetPosition(OBDISP *pOBD, int x, int y, int bRender)
 			y += 3;
 		}
 	}
+	*px = x;
+	*py = y;
+} /* obdPanelPosition() */
+//
+// Send commands to position the "cursor" (aka memory write address)
+// to the given row and column
+//
+void obdSetPosition(OBDISP *pOBD, int x, int y, int bRender)
+{
+	unsigned char buf[4];
+	int iPitch = pOBD->width;
+
+	obdCachedFlush(pOBD, bRender); // flush any cached data first
+
+	pOBD->iScreenOffset = (y * iPitch) + x;
+
+	if (pOBD->type == LCD_VIRTUAL || pOBD->type >= SHARP_144x168)
+		return; // nothing to do
+	if (!bRender)
+		return; // don't send the commands to the OLED if we're not rendering the graphics now
+	if (pOBD->type == LCD_NOKIA5110)
+	{
+		obdWriteCommand(pOBD, 0x40 | y);
+		obdWriteCommand(pOBD, 0x80 | x);
+		return;
+	}
+	obdPanelPosition(pOBD, &x, &y);
 	if (pOBD->com_mode == COM_I2C)
 	{                           // I2C device
 		buf[0] = 0x00;            // command introducer
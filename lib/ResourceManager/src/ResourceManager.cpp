@@ -0,0 +1,185 @@
+#include "ResourceManager.hpp"
+#include "hardware/dma.h"
+
+ResourceManager::ResourceManager() {
+  spinLock = spin_lock_init(spin_lock_claim_unused(true));
+}
+
+uint32_t ResourceManager::lock() {
+  return spin_lock_blocking(spinLock);
+}
+
+void ResourceManager::unlock(uint32_t save) {
+  spin_unlock(spinLock, save);
+}
+
+ResourceManager::LoadedProgram *ResourceManager::findProgram(uint pioIndex, const pio_program_t *program) {
+  for (LoadedProgram &loaded : programs[pioIndex]) {
+    if (loaded.program == program)
+      return &loaded;
+  }
+
+  return nullptr;
+}
+
+bool ResourceManager::hasFreeSM(PIO pio) {
+  for (uint sm = 0; sm < 4; sm++) {
+    if (!pio_sm_is_claimed(pio, sm))
+      return true;
+  }
+
+  return false;
+}
+
+bool ResourceManager::CanClaim(const ResourceRequest &request) {
+  uint32_t save = lock();
+
+  uint8_t freeSMs = 0;
+  if (request.stateMachines > 0) {
+    for (uint pioIndex = 0; pioIndex < NUM_PIOS; pioIndex++) {
+      PIO pio = (pioIndex == 0) ? pio0 : pio1;
+      if (request.program != nullptr && findProgram(pioIndex, request.program) == nullptr
+          && (!pio_can_add_program(pio, request.program) || findProgram(pioIndex, nullptr) == nullptr))
+        continue;
+
+      for (uint sm = 0; sm < 4; sm++) {
+        if (!pio_sm_is_claimed(pio, sm))
+          freeSMs++;
+      }
+    }
+  }
+
+  uint8_t freeDMA = 0;
+  for (uint channel = 0; channel < NUM_DMA_CHANNELS; channel++) {
+    if (!dma_channel_is_claimed(channel))
+      freeDMA++;
+  }
+
+  unlock(save);
+
+  return freeSMs >= request.stateMachines && freeDMA >= request.dmaChannels;
+}
+
+bool ResourceManager::ClaimStateMachine(const pio_program_t *program, const char *owner, PIOClaim &claim, PIO preferred) {
+  uint32_t save = lock();
+
+  PIO blocks[NUM_PIOS] = { preferred, (preferred == pio0) ? pio1 : pio0 };
+  for (PIO pio : blocks) {
+    uint pioIndex = pio_get_index(pio);
+    if (!hasFreeSM(pio))
+      continue;
+
+    LoadedProgram *loaded = findProgram(pioIndex, program);
+    if (loaded == nullptr) {
+      loaded = findProgram(pioIndex, nullptr);
+      if (loaded == nullptr || !pio_can_add_program(pio, program))
+        continue;
+
+      loaded->program = program;
+      loaded->offset = pio_add_program(pio, program);
+      loaded->users = 0;
+    }
+
+    int sm = pio_claim_unused_sm(pio, false);
+    loaded->users++;
+    smOwners[pioIndex][sm] = owner;
+    claim = { pio, sm, loaded->offset, program };
+
+    unlock(save);
+    return true;
+  }
+
+  unlock(save);
+  claim = { preferred, -1, -1, nullptr };
+  return false;
+}
+
+void ResourceManager::ReleaseStateMachine(PIOClaim &claim) {
+  if (claim.sm < 0)
+    return;
+
+  uint32_t save = lock();
+
+  uint pioIndex = pio_get_index(claim.pio);
+  pio_sm_set_enabled(claim.pio, claim.sm, false);
+  pio_sm_unclaim(claim.pio, claim.sm);
+  smOwners[pioIndex][claim.sm] = nullptr;
+
+  // The last state machine running a program frees its instruction memory
+  LoadedProgram *loaded = findProgram(pioIndex, claim.program);
+  if (loaded != nullptr && --loaded->users == 0) {
+    pio_remove_program(claim.pio, loaded->program, loaded->offset);
+    *loaded = { };
+  }
+
+  unlock(save);
+  claim.sm = -1;
+}
+
+int ResourceManager::ClaimDMA(const char *owner) {
+  uint32_t save = lock();
+  int channel = dma_claim_unused_channel(false);
+  if (channel >= 0)
+    dmaOwners[channel] = owner;
+  unlock(save);
+
+  return channel;
+}
+
+void ResourceManager::ReleaseDMA(int channel) {
+  if (channel < 0)
+    return;
+
+  uint32_t save = lock();
+  dma_channel_abort(channel);
+  dma_channel_unclaim(channel);
+  dmaOwners[channel] = nullptr;
+  unlock(save);
+}
+
+void ResourceManager::AddIRQHandler(uint irq, irq_handler_t handler) {
+  uint32_t save = lock();
+
+  SharedHandler *slot = nullptr;
+  for (SharedHandler &shared : handlers) {
+    if (shared.users > 0 && shared.irq == irq && shared.handler == handler) {
+      shared.users++;
+      unlock(save);
+      return;
+    }
+
+    if (shared.users == 0 && slot == nullptr)
+      slot = &shared;
+  }
+
+  if (slot != nullptr) {
+    *slot = { irq, handler, 1 };
+    irq_add_shared_handler(irq, handler, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    irq_set_enabled(irq, true);
+  }
+
+  unlock(save);
+}
+
+void ResourceManager::RemoveIRQHandler(uint irq, irq_handler_t handler) {
+  uint32_t save = lock();
+
+  for (SharedHandler &shared : handlers) {
+    if (shared.users > 0 && shared.irq == irq && shared.handler == handler) {
+      if (--shared.users == 0)
+        irq_remove_handler(irq, handler);
+      break;
+    }
+  }
+
+  unlock(save);
+}
+
+const char *ResourceManager::GetOwner(ResourceType type, uint index) const {
+  switch (type) {
+    case RESOURCE_PIO_SM: return (index < NUM_PIOS * 4) ? smOwners[index / 4][index % 4] : nullptr;
+    case RESOURCE_DMA:    return (index < NUM_DMA_CHANNELS) ? dmaOwners[index] : nullptr;
+  }
+
+  return nullptr;
+}
@@ -0,0 +1,94 @@
+#ifndef _RESOURCE_MANAGER_H_
+#define _RESOURCE_MANAGER_H_
+
+#include <stdint.h>
+#include "pico/types.h"
+#include "hardware/irq.h"
+#include "hardware/pio.h"
+#include "hardware/sync.h"
+
+#define RESOURCE_MAX_PROGRAMS     4 // Distinct programs loaded per PIO block
+#define RESOURCE_MAX_IRQ_HANDLERS 8 // Distinct shared handlers across all IRQs
+
+typedef enum
+{
+  RESOURCE_PIO_SM,
+  RESOURCE_DMA,
+} ResourceType;
+
+// What an addon needs, checked by CanClaim() from available() before anything is set up
+struct ResourceRequest
+{
+  const pio_program_t *program; // Program the state machines run, nullptr if none
+  uint8_t stateMachines;
+  uint8_t dmaChannels;
+};
+
+// A state machine with its program loaded
+struct PIOClaim
+{
+  PIO pio;
+  int sm;
+  int offset;
+  const pio_program_t *program;
+};
+
+/* Central owner of the claimable RP2040 resources. PIO programs are loaded once per block and
+   reference counted, so chains that come and go don't leak instruction memory. Nothing here
+   panics on exhaustion: a failed claim returns -1 (or false) and the caller decides. The
+   bookkeeping is shared by both cores and guarded by a hardware spin lock. */
+class ResourceManager
+{
+public:
+  ResourceManager(ResourceManager const&) = delete;
+  void operator=(ResourceManager const&) = delete;
+  static ResourceManager& getInstance()
+  {
+    static ResourceManager instance;
+    return instance;
+  }
+
+  bool CanClaim(const ResourceRequest &request);
+
+  // Prefers the given block, falls back to the other one if it has no room
+  bool ClaimStateMachine(const pio_program_t *program, const char *owner, PIOClaim &claim, PIO preferred = pio0);
+  void ReleaseStateMachine(PIOClaim &claim);
+
+  int ClaimDMA(const char *owner);
+  void ReleaseDMA(int channel);
+
+  // Shared handlers are installed on first use and removed after the last user releases them
+  void AddIRQHandler(uint irq, irq_handler_t handler);
+  void RemoveIRQHandler(uint irq, irq_handler_t handler);
+
+  const char *GetOwner(ResourceType type, uint index) const; // nullptr if free or claimed outside the manager
+
+private:
+  struct LoadedProgram
+  {
+    const pio_program_t *program;
+    int offset;
+    uint8_t users;
+  };
+
+  struct SharedHandler
+  {
+    uint irq;
+    irq_handler_t handler;
+    uint8_t users;
+  };
+
+  ResourceManager();
+  LoadedProgram *findProgram(uint pioIndex, const pio_program_t *program);
+  bool hasFreeSM(PIO pio);
+  uint32_t lock();
+  void unlock(uint32_t save);
+
+  spin_lock_t *spinLock;
+  LoadedProgram programs[NUM_PIOS][RESOURCE_MAX_PROGRAMS] = { };
+  SharedHandler handlers[RESOURCE_MAX_IRQ_HANDLERS] = { };
+  const char *smOwners[NUM_PIOS][4] = { };
+  const char *dmaOwners[NUM_DMA_CHANNELS] = { };
+};
+
+#endif
@@ -0,0 +1,11 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: Copyright (c) 2021 Jason Skuby (mytechtoybox.com)
+ */
+
+#pragma once
+
+#include "device/usbd_pvt.h"
+#include "class/cdc/cdc_device.h"
+
+extern const usbd_class_driver_t cdc_driver;
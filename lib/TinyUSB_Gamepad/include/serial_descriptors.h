@@ -0,0 +1,65 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: Copyright (c) 2021 Jason Skuby (mytechtoybox.com)
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include "tusb.h"
+
+#define SERIAL_STRING_MAX_LENGTH 32
+
+static const char serial_string_manufacturer[] = "GP2040";
+static const char serial_string_product[]      = "GP2040 Serial Config";
+static const char serial_string_version[]      = "1.0";
+static const char serial_string_interface[]    = "Serial Config";
+
+// Index 0 is the language ID, the rest are converted to UTF-16 on request
+static const char *serial_string_descriptors[] =
+{
+	nullptr,
+	serial_string_manufacturer,
+	serial_string_product,
+	serial_string_version,
+	serial_string_interface,
+};
+
+static const tusb_desc_device_t serial_device_descriptor =
+{
+	.bLength            = sizeof(tusb_desc_device_t),
+	.bDescriptorType    = TUSB_DESC_DEVICE,
+	.bcdUSB             = 0x0200,
+
+	// Use Interface Association Descriptor (IAD) for CDC
+	.bDeviceClass       = TUSB_CLASS_MISC,
+	.bDeviceSubClass    = MISC_SUBCLASS_COMMON,
+	.bDeviceProtocol    = MISC_PROTOCOL_IAD,
+
+	.bMaxPacketSize0    = CFG_TUD_ENDPOINT0_SIZE,
+
+	.idVendor           = 0xCAFE,
+	.idProduct          = 0x4002,
+	.bcdDevice          = 0x0100,
+
+	.iManufacturer      = 0x01,
+	.iProduct           = 0x02,
+	.iSerialNumber      = 0x03,
+
+	.bNumConfigurations = 0x01
+};
+
+#define SERIAL_CONFIG_TOTAL_LEN  (TUD_CONFIG_DESC_LEN + TUD_CDC_DESC_LEN)
+
+#define EPNUM_CDC_NOTIF   0x81
+#define EPNUM_CDC_OUT     0x02
+#define EPNUM_CDC_IN      0x82
+
+static uint8_t const serial_configuration_descriptor[] =
+{
+	// Config number, interface count, string index, total length, attribute, power in mA
+	TUD_CONFIG_DESCRIPTOR(1, 2, 0, SERIAL_CONFIG_TOTAL_LEN, 0, 100),
+
+	// Interface number, string index, EP notification address and size, EP data address (out, in) and size.
+	TUD_CDC_DESCRIPTOR(0, 4, EPNUM_CDC_NOTIF, 8, EPNUM_CDC_OUT, EPNUM_CDC_IN, CFG_TUD_CDC_EP_BUFSIZE),
+};
@@ -5,16 +5,42 @@
 
 #pragma once
 
+#include <stdint.h>
 #include "GamepadDescriptors.h"
+#include "descriptors/HIDDescriptors.h"
+#include "descriptors/SwitchDescriptors.h"
+#include "descriptors/XInputDescriptors.h"
 
 typedef enum
 {
 	USB_MODE_HID,
 	USB_MODE_NET,
+	USB_MODE_SERIAL,
 } UsbMode;
 
+// Report type sent for each input mode, used to specialize the send path at compile time
+template<InputMode mode> struct GamepadReport;
+template<> struct GamepadReport<INPUT_MODE_HID>    { typedef HIDReport Type; };
+template<> struct GamepadReport<INPUT_MODE_SWITCH> { typedef SwitchReport Type; };
+template<> struct GamepadReport<INPUT_MODE_XINPUT> { typedef XInputReport Type; };
+
+typedef enum
+{
+	REPORT_UNCHANGED, // Same as the last report the host accepted, nothing was sent
+	REPORT_SENT,
+	REPORT_BUSY,      // Changed, but the endpoint was still busy with the last one
+} ReportResult;
+
+struct ReportStats
+{
+	uint32_t sent;
+	uint32_t dropped; // Changed reports that were replaced or reverted before the host saw them
+};
+
 InputMode get_input_mode(void);
-void initialize_driver(InputMode mode);
-void receive_report(uint8_t *buffer);
-void send_report(void *report, uint16_t report_size);
+UsbMode get_usb_mode(void);
+void initialize_driver(InputMode mode, UsbMode configMode = USB_MODE_NET); // configMode picks the device INPUT_MODE_CONFIG enumerates as
+bool receive_report(uint8_t *buffer, uint32_t *timestamp); // Next host OUT report, false if none are waiting
+ReportResult send_report(void *report); // Report for the mode given to initialize_driver(), only sent when it changed
+ReportStats get_report_stats(void);
 
@@ -12,6 +12,13 @@
 #include "descriptors/XInputDescriptors.h"
 
 #define XINPUT_OUT_SIZE 32
+#define XINPUT_OUT_QUEUE_SIZE 8 // Host reports waiting to be read, must be a power of 2
+
+typedef enum
+{
+	XINPUT_OUT_RUMBLE = 0x00,
+	XINPUT_OUT_LED    = 0x01,
+} XInputOutReportType;
 
 typedef enum
 {
@@ -31,13 +38,21 @@ typedef enum
 	XINPUT_PLED_ALTERNATE = 0x0D, // Alternating (e.g. 1+4-2+3), then back to previous*
 } XInputPLEDPattern;
 
+// Host OUT report, stamped when the transfer completed
+typedef struct
+{
+	uint32_t timestamp;
+	uint8_t size;
+	uint8_t data[XINPUT_OUT_SIZE];
+} XInputOutReport;
+
 // USB endpoint state vars
 extern uint8_t endpoint_in;
 extern uint8_t endpoint_out;
 extern uint8_t xinput_out_buffer[XINPUT_OUT_SIZE];
 extern const usbd_class_driver_t xinput_driver;
 
-void receive_xinput_report(void);
+bool receive_xinput_report(uint8_t *buffer, uint32_t *timestamp);
 bool send_xinput_report(void *report, uint8_t report_size);
 
 #pragma once
@@ -0,0 +1,14 @@
+#include "cdc_driver.h"
+
+const usbd_class_driver_t cdc_driver = {
+#if CFG_TUSB_DEBUG >= 2
+	.name = "CDC",
+#endif
+	.init             = cdcd_init,
+	.reset            = cdcd_reset,
+	.open             = cdcd_open,
+	.control_request  = cdcd_control_request,
+	.control_complete = cdcd_control_complete,
+	.xfer_cb          = cdcd_xfer_cb,
+	.sof              = NULL,
+};
@@ -14,59 +14,161 @@
 
 #include "usb_driver.h"
 #include "net_driver.h"
+#include "cdc_driver.h"
 #include "hid_driver.h"
 #include "xinput_driver.h"
 
 UsbMode usb_mode = USB_MODE_HID;
 InputMode input_mode = INPUT_MODE_XINPUT;
 
+typedef ReportResult (*ReportSender)(void *report);
+typedef uint16_t (*ReportGetter)(uint8_t *buffer, uint16_t reqlen);
+
+static ReportStats report_stats = { };
+
+// Last report the host accepted, and the newest one the endpoint was too busy for, per mode
+template<InputMode mode>
+struct ReportCache
+{
+	static typename GamepadReport<mode>::Type last;
+	static typename GamepadReport<mode>::Type pending;
+	static bool hasPending;
+};
+
+template<InputMode mode>
+typename GamepadReport<mode>::Type ReportCache<mode>::last = { };
+
+template<InputMode mode>
+typename GamepadReport<mode>::Type ReportCache<mode>::pending = { };
+
+template<InputMode mode>
+bool ReportCache<mode>::hasPending = false;
+
+template<InputMode mode>
+static ReportResult send_mode_report(void *report)
+{
+	typedef typename GamepadReport<mode>::Type Report;
+
+	// A pending report is only copied while the endpoint is busy, the common path is one compare
+	Report &last = ReportCache<mode>::last;
+	bool &hasPending = ReportCache<mode>::hasPending;
+	if (memcmp(&last, report, sizeof(Report)) == 0)
+	{
+		if (hasPending) // Changed and changed back before the host saw it
+			report_stats.dropped++;
+
+		hasPending = false;
+		return REPORT_UNCHANGED;
+	}
+
+	bool sent = (mode == INPUT_MODE_XINPUT)
+		? send_xinput_report(report, sizeof(Report))
+		: send_hid_report(0, report, sizeof(Report));
+
+	if (sent)
+	{
+		memcpy(&last, report, sizeof(Report));
+		hasPending = false;
+		report_stats.sent++;
+		return REPORT_SENT;
+	}
+
+	Report &pending = ReportCache<mode>::pending;
+	if (hasPending && memcmp(&pending, report, sizeof(Report)) != 0)
+		report_stats.dropped++;
+
+	memcpy(&pending, report, sizeof(Report));
+	hasPending = true;
+	return REPORT_BUSY;
+}
+
+template<InputMode mode>
+static uint16_t get_mode_report(uint8_t *buffer, uint16_t reqlen)
+{
+	uint16_t report_size = sizeof(typename GamepadReport<mode>::Type);
+	if (report_size > reqlen)
+		report_size = reqlen;
+
+	memcpy(buffer, &ReportCache<mode>::last, report_size);
+	return report_size;
+}
+
+static ReportResult send_no_report(void *report)
+{
+	(void)report;
+	return REPORT_UNCHANGED;
+}
+
+static uint16_t get_no_report(uint8_t *buffer, uint16_t reqlen)
+{
+	(void)buffer;
+	(void)reqlen;
+	return 0;
+}
+
+static ReportSender report_sender = send_no_report;
+static ReportGetter report_getter = get_no_report;
+
 InputMode get_input_mode(void)
 {
 	return input_mode;
 }
 
-void initialize_driver(InputMode mode)
+UsbMode get_usb_mode(void)
+{
+	return usb_mode;
+}
+
+void initialize_driver(InputMode mode, UsbMode configMode)
 {
 	input_mode = mode;
-	if (mode == INPUT_MODE_CONFIG)
-		usb_mode = USB_MODE_NET;
+	switch (mode)
+	{
+		case INPUT_MODE_HID:
+			report_sender = send_mode_report<INPUT_MODE_HID>;
+			report_getter = get_mode_report<INPUT_MODE_HID>;
+			break;
+
+		case INPUT_MODE_SWITCH:
+			report_sender = send_mode_report<INPUT_MODE_SWITCH>;
+			report_getter = get_mode_report<INPUT_MODE_SWITCH>;
+			break;
+
+		case INPUT_MODE_XINPUT:
+			report_sender = send_mode_report<INPUT_MODE_XINPUT>;
+			report_getter = get_mode_report<INPUT_MODE_XINPUT>;
+			break;
+
+		case INPUT_MODE_CONFIG:
+			usb_mode = configMode;
+			break;
+
+		default:
+			break;
+	}
 
 	tusb_init();
 }
 
-void receive_report(uint8_t *buffer)
+bool receive_report(uint8_t *buffer, uint32_t *timestamp)
 {
 	if (input_mode == INPUT_MODE_XINPUT)
-	{
-		receive_xinput_report();
-		memcpy(buffer, xinput_out_buffer, XINPUT_OUT_SIZE);
-	}
+		return receive_xinput_report(buffer, timestamp);
+
+	return false;
 }
 
-void send_report(void *report, uint16_t report_size)
+ReportResult send_report(void *report)
 {
-	static uint8_t previous_report[CFG_TUD_ENDPOINT0_SIZE] = { };
-
 	if (tud_suspended())
 		tud_remote_wakeup();
 
-	if (memcmp(previous_report, report, report_size) != 0)
-	{
-		bool sent = false;
-		switch (input_mode)
-		{
-			case INPUT_MODE_XINPUT:
-				sent = send_xinput_report(report, report_size);
-				break;
-
-			default:
-				sent = send_hid_report(0, report, report_size);
-				break;
-		}
+	return report_sender(report);
+}
 
-		if (sent)
-			memcpy(previous_report, report, report_size);
-	}
+ReportStats get_report_stats(void)
+{
+	return report_stats;
 }
 
 /* USB Driver Callback (Required for XInput) */
@@ -79,6 +181,10 @@ const usbd_class_driver_t *usbd_app_driver_get_cb(uint8_t *driver_count)
 	{
 		return &net_driver;
 	}
+	else if (usb_mode == USB_MODE_SERIAL)
+	{
+		return &cdc_driver;
+	}
 	else
 	{
 		switch (input_mode)
@@ -99,29 +205,12 @@ const usbd_class_driver_t *usbd_app_driver_get_cb(uint8_t *driver_count)
 // Return zero will cause the stack to STALL request
 uint16_t tud_hid_get_report_cb(uint8_t itf, uint8_t report_id, hid_report_type_t report_type, uint8_t *buffer, uint16_t reqlen)
 {
-	// TODO: Handle the correct report type, if required
 	(void)itf;
 	(void)report_id;
 	(void)report_type;
-	(void)reqlen;
 
-	uint8_t report_size = 0;
-	SwitchReport switch_report;
-	HIDReport hid_report;
-	switch (input_mode)
-	{
-		case INPUT_MODE_SWITCH:
-			report_size = sizeof(SwitchReport);
-			memcpy(buffer, &switch_report, report_size);
-			break;
-
-		default:
-			report_size = sizeof(HIDReport);
-			memcpy(buffer, &hid_report, report_size);
-			break;
-	}
-
-	return report_size;
+	// Answer with the last input report the host accepted
+	return report_getter(buffer, reqlen);
 }
 
 // Invoked when received SET_REPORT control request or
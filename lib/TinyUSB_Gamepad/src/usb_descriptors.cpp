@@ -9,6 +9,33 @@
 #include "usb_driver.h"
 #include "GamepadDescriptors.h"
 #include "webserver_descriptors.h"
+#include "serial_descriptors.h"
+
+// Serial config strings are plain ASCII, the host wants them as UTF-16 descriptors
+static uint16_t const *get_serial_string_descriptor(uint8_t index)
+{
+	static uint16_t descriptor[SERIAL_STRING_MAX_LENGTH + 1];
+
+	uint8_t length;
+	if (index == 0)
+	{
+		descriptor[1] = 0x0409; // English
+		length = 1;
+	}
+	else if (index < sizeof(serial_string_descriptors) / sizeof(serial_string_descriptors[0]))
+	{
+		const char *str = serial_string_descriptors[index];
+		for (length = 0; str[length] && length < SERIAL_STRING_MAX_LENGTH; length++)
+			descriptor[1 + length] = str[length];
+	}
+	else
+	{
+		return nullptr;
+	}
+
+	descriptor[0] = (TUSB_DESC_STRING << 8) | (2 * length + 2);
+	return descriptor;
+}
 
 // Invoked when received GET STRING DESCRIPTOR request
 // Application return pointer to descriptor, whose contents must exist long enough for transfer to complete
@@ -16,7 +43,11 @@ uint16_t const *tud_descriptor_string_cb(uint8_t index, uint16_t langid)
 {
 	(void)langid;
 
-	if (get_input_mode() == INPUT_MODE_CONFIG)
+	if (get_usb_mode() == USB_MODE_SERIAL)
+	{
+		return get_serial_string_descriptor(index);
+	}
+	else if (get_input_mode() == INPUT_MODE_CONFIG)
 	{
 		return reinterpret_cast<uint16_t const *>(webserver_string_descriptors[index]);
 	}
@@ -34,6 +65,9 @@ uint8_t const *tud_descriptor_device_cb(void)
 	switch (get_input_mode())
 	{
 		case INPUT_MODE_CONFIG:
+			if (get_usb_mode() == USB_MODE_SERIAL)
+				return reinterpret_cast<uint8_t const *>(&serial_device_descriptor);
+
 			return reinterpret_cast<uint8_t const *>(&webserver_device_descriptor);
 
 		case INPUT_MODE_XINPUT:
@@ -71,6 +105,9 @@ uint8_t const *tud_descriptor_configuration_cb(uint8_t index)
 	switch (get_input_mode())
 	{
 		case INPUT_MODE_CONFIG:
+			if (get_usb_mode() == USB_MODE_SERIAL)
+				return serial_configuration_descriptor;
+
 			return net_configuration_arr[index];
 
 		case INPUT_MODE_XINPUT:
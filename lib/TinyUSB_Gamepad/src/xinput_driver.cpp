@@ -3,14 +3,37 @@
  * SPDX-FileCopyrightText: Copyright (c) 2021 Jason Skuby (mytechtoybox.com)
  */
 
+#include <string.h>
+#include "hardware/timer.h"
+
 #include "xinput_driver.h"
 
 uint8_t endpoint_in = 0;
 uint8_t endpoint_out = 0;
 uint8_t xinput_out_buffer[XINPUT_OUT_SIZE] = { };
 
-void receive_xinput_report(void)
+// Completed OUT reports, filled by the transfer callback and drained by receive_xinput_report
+static XInputOutReport out_queue[XINPUT_OUT_QUEUE_SIZE];
+static volatile uint8_t out_queue_head = 0;
+static volatile uint8_t out_queue_tail = 0;
+
+static void queue_xinput_report(uint32_t size)
+{
+	uint8_t next = (out_queue_head + 1) & (XINPUT_OUT_QUEUE_SIZE - 1);
+	if (next == out_queue_tail)
+		return; // Full, drop the newest and keep the order of what is waiting
+
+	XInputOutReport *report = &out_queue[out_queue_head];
+	report->timestamp = time_us_32();
+	report->size = (size > XINPUT_OUT_SIZE) ? XINPUT_OUT_SIZE : size;
+	memcpy(report->data, xinput_out_buffer, report->size);
+	memset(report->data + report->size, 0, XINPUT_OUT_SIZE - report->size);
+	out_queue_head = next;
+}
+
+bool receive_xinput_report(uint8_t *buffer, uint32_t *timestamp)
 {
+	// Arm the OUT endpoint the first time, the transfer callback keeps it armed after that
 	if (
 		tud_ready() &&
 		(endpoint_out != 0) && (!usbd_edpt_busy(0, endpoint_out))
@@ -19,6 +42,17 @@ void receive_xinput_report(void)
 		usbd_edpt_xfer(0, endpoint_out, xinput_out_buffer, XINPUT_OUT_SIZE); // Retrieve report buffer
 		usbd_edpt_release(0, endpoint_out);                                  // Release control of OUT endpoint
 	}
+
+	if (out_queue_tail == out_queue_head)
+		return false;
+
+	XInputOutReport *report = &out_queue[out_queue_tail];
+	memcpy(buffer, report->data, XINPUT_OUT_SIZE);
+	if (timestamp != nullptr)
+		*timestamp = report->timestamp;
+
+	out_queue_tail = (out_queue_tail + 1) & (XINPUT_OUT_QUEUE_SIZE - 1);
+	return true;
 }
 
 bool send_xinput_report(void *report, uint8_t report_size)
@@ -95,11 +129,14 @@ static bool xinput_control_complete(uint8_t rhport, tusb_control_request_t const
 static bool xinput_xfer_callback(uint8_t rhport, uint8_t ep_addr, xfer_result_t result, uint32_t xferred_bytes)
 {
 	(void)rhport;
-	(void)result;
-	(void)xferred_bytes;
 
 	if (ep_addr == endpoint_out)
+	{
+		if (result == XFER_RESULT_SUCCESS && xferred_bytes > 0)
+			queue_xinput_report(xferred_bytes);
+
 		usbd_edpt_xfer(0, endpoint_out, xinput_out_buffer, XINPUT_OUT_SIZE);
+	}
 
 	return true;
 }
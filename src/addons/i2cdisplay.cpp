@@ -8,11 +8,16 @@
 #include "helper.h"
 #include "storagemanager.h"
 #include "pico/stdlib.h"
-#include "bitmaps.h"
+#include "bitmaps_rle.h"
+#include "messagebus.h"
+#include "ResourceManager.hpp"
 
+// The first flush claims a DMA channel, don't start if other addons already hold them all
 bool I2CDisplayAddon::available() {
 	BoardOptions boardOptions = Storage::getInstance().getBoardOptions();
-	return boardOptions.hasI2CDisplay && boardOptions.i2cSDAPin != -1 && boardOptions.i2cSCLPin != -1;
+	ResourceRequest request = { nullptr, 0, 1 };
+	return boardOptions.hasI2CDisplay && boardOptions.i2cSDAPin != -1 && boardOptions.i2cSCLPin != -1
+		&& ResourceManager::getInstance().CanClaim(request);
 }
 
 void I2CDisplayAddon::setup() {
@@ -34,488 +39,507 @@ void I2CDisplayAddon::setup() {
 	gamepad = Storage::getInstance().GetGamepad();
 	pGamepad = Storage::getInstance().GetProcessedGamepad();
 
+	loadButtonLayout();
+	MessageBus::getInstance().subscribe(MESSAGE_CONFIG_CHANGED, I2CDisplayAddon::handleConfigChanged, this);
+	MessageBus::getInstance().subscribe(MESSAGE_PERF_HUD, I2CDisplayAddon::handlePerfHUD, this);
+	scheduler.SetFrameRate(DISPLAY_FRAME_RATE);
+	displayState = readState();
+	changedButtons = 0;
+	fullRedraw = true;
+	splashShown = false;
+	splashFrame = { };
+	splashFirstPage = 0;
+	splashLastPage = -1;
+	flushPending = false;
+	hudShown = false;
+	menuShown = false;
+	nextHudUpdate = 0;
+	menuState = { };
+	textDirty = 0;
+	core0Stats = { };
+	ledStats = nullptr;
 }
 
 void I2CDisplayAddon::process() {
 	//Gamepad * gamepad = Storage::getInstance().GetGamepad();
 	//Gamepad * pGamepad = Storage::getInstance().GetProcessedGamepad();
 
-	clearScreen(0);
-	bool configMode = Storage::getInstance().GetConfigMode();
-	if (configMode == true ) {
+	uint64_t frameStart = time_us_64();
+	if (!scheduler.FrameDue(frameStart))
+		return;
+
+	DisplayState state = readState();
+	bool menuUpdated = MessageBus::getInstance().readMenu(menuState);
+	bool menu = menuState.open && !state.configMode;
+	bool splash = !state.configMode && !menu && getMillis() < 7500 && SPLASH_MODE != NOSPLASH;
+	if (splash != splashShown || menu != menuShown || state.configMode != displayState.configMode)
+		fullRedraw = true;
+
+	bool statusChanged = fullRedraw
+		|| state.inputMode != displayState.inputMode
+		|| state.dpadMode != displayState.dpadMode
+		|| state.socdMode != displayState.socdMode
+		|| state.turboShotCount != displayState.turboShotCount;
+	changedButtons = state.buttons ^ displayState.buttons;
+	displayState = state;
+	splashShown = splash;
+	menuShown = menu;
+
+	// Nothing is redrawn until something on screen changes, the splash included
+	bool hud = hudShown && !state.configMode && !splash && !menu;
+	bool buttonsShown = !state.configMode && !splash && !menu && !hud;
+	bool pageChanged;
+	if (splash)
+		pageChanged = updateSplash();
+	else
+		pageChanged = menu ? updateMenuPage(menuUpdated) : (hud && updatePerfHUD(frameStart));
+	if (!statusChanged && !pageChanged && !(buttonsShown && changedButtons != 0)) {
+		if (flushPending)
+			flushPending = obdDumpBufferAsync(&obd, NULL) < 0;
+		return;
+	}
+
+	if (fullRedraw)
+		clearScreen(0);
+
+	if (state.configMode) {
 		drawStatusBar(gamepad);
 		drawText(0, 3, "[Web Config Mode]");
 		drawText(0, 4, std::string("GP2040-CE : ") + std::string(GP2040VERSION));
-	} else if (getMillis() < 7500 && SPLASH_MODE != NOSPLASH) {
-		drawSplashScreen(SPLASH_MODE, 90);
+	} else if (splash) {
+		drawSplashScreen();
+	} else if (menu || hud) {
+		drawTextPage();
 	} else {
-		drawStatusBar(gamepad);
-		switch (BUTTON_LAYOUT)
-		{
-			case BUTTON_LAYOUT_STICK:
-				drawArcadeStick(8, 28, 8, 2);
-				break;
-			case BUTTON_LAYOUT_STICKLESS:
-				drawStickless(8, 20, 8, 2);
-				break;
-			case BUTTON_LAYOUT_BUTTONS_ANGLED:
-				drawWasdBox(8, 28, 7, 3);
-				break;
-			case BUTTON_LAYOUT_BUTTONS_BASIC:
-				drawUDLR(8, 28, 8, 2);
-				break;
-			case BUTTON_LAYOUT_KEYBOARD_ANGLED:
-				drawKeyboardAngled(18, 28, 5, 2);
-				break;
-			case BUTTON_LAYOUT_KEYBOARDA:
-				drawMAMEA(8, 28, 10, 1);
-				break;
-			case BUTTON_LAYOUT_DANCEPADA:
-				drawDancepadA(39, 12, 15, 2);
-				break;
-			case BUTTON_LAYOUT_TWINSTICKA:
-				drawTwinStickA(8, 28, 8, 2);
-				break;
-			case BUTTON_LAYOUT_BLANKA:
-				drawBlankA(0, 0, 0, 0);
-				break;
-		}
-
-		switch (BUTTON_LAYOUT_RIGHT)
-		{
-			case BUTTON_LAYOUT_ARCADE:
-				drawArcadeButtons(8, 28, 8, 2);
-				break;
-			case BUTTON_LAYOUT_STICKLESSB:
-				drawSticklessButtons(8, 20, 8, 2);
-				break;
-			case BUTTON_LAYOUT_BUTTONS_ANGLEDB:
-				drawWasdButtons(8, 28, 7, 3);
-				break;
-			case BUTTON_LAYOUT_VEWLIX:
-				drawVewlix(8, 28, 8, 2);
-				break;
-			case BUTTON_LAYOUT_VEWLIX7:
-				drawVewlix7(8, 28, 8, 2);
-				break;
-			case BUTTON_LAYOUT_CAPCOM:
-				drawCapcom(6, 28, 8, 2);
-				break;
-			case BUTTON_LAYOUT_CAPCOM6:
-				drawCapcom6(16, 28, 8, 2);
-				break;
-			case BUTTON_LAYOUT_SEGA2P:
-				drawSega2p(8, 28, 8, 2);
-				break;
-			case BUTTON_LAYOUT_NOIR8:
-				drawNoir8(8, 28, 8, 2);
-				break;
-			case BUTTON_LAYOUT_KEYBOARDB:
-				drawMAMEB(68, 28, 10, 1);
-				break;
-			case BUTTON_LAYOUT_DANCEPADB:
-				drawDancepadB(39, 12, 15, 2);
-				break;
-			case BUTTON_LAYOUT_TWINSTICKB:
-				drawTwinStickB(100, 28, 8, 2);
-				break;
-			case BUTTON_LAYOUT_BLANKB:
-				drawSticklessButtons(0, 0, 0, 0);
-				break;
-		}
+		if (statusChanged)
+			drawStatusBar(gamepad);
+		drawButtons();
 	}
 
-	obdDumpBuffer(&obd, NULL);
+	// The flush runs on DMA while core1 gets on with the LEDs, a frame that finds the
+	// last one still going is sent on a later tick
+	fullRedraw = false;
+	flushPending = obdDumpBufferAsync(&obd, NULL) < 0;
+	scheduler.RecordRender((uint32_t)(time_us_64() - frameStart), !flushPending);
 }
 
-void I2CDisplayAddon::clearScreen(int render) {
-	obdFill(&obd, 0, render);
-}
+DisplayState I2CDisplayAddon::readState() {
+	BoardOptions boardOptions = Storage::getInstance().getBoardOptions();
 
-void I2CDisplayAddon::drawDiamond(int cx, int cy, int size, uint8_t colour, uint8_t filled)
-{
-	if (filled) {
-		int i;
-		for (i = 0; i < size; i++) {
-			obdDrawLine(&obd, cx - i, cy - size + i, cx + i, cy - size + i, colour, 0);
-			obdDrawLine(&obd, cx - i, cy + size - i, cx + i, cy + size - i, colour, 0);
-		}
-		obdDrawLine(&obd, cx - size, cy, cx + size, cy, colour, 0); // Fill in the middle
-	}
-	obdDrawLine(&obd, cx - size, cy, cx, cy - size, colour, 0);
-	obdDrawLine(&obd, cx, cy - size, cx + size, cy, colour, 0);
-	obdDrawLine(&obd, cx + size, cy, cx, cy + size, colour, 0);
-	obdDrawLine(&obd, cx, cy + size, cx - size, cy, colour, 0);
+	DisplayState state;
+	state.buttons = (uint32_t)pGamepad->state.dpad << 16 | pGamepad->state.buttons;
+	state.inputMode = gamepad->options.inputMode;
+	state.dpadMode = gamepad->options.dpadMode;
+	state.socdMode = gamepad->options.socdMode;
+	state.turboShotCount = (boardOptions.pinButtonTurbo != (uint8_t)-1) ? boardOptions.turboShotCount : 0;
+	state.configMode = Storage::getInstance().GetConfigMode();
+	return state;
 }
 
-void I2CDisplayAddon::drawStickless(int startX, int startY, int buttonRadius, int buttonPadding)
-{
-
-	const int buttonMargin = buttonPadding + (buttonRadius * 2);
+// Layouts are tables, a layout change from the web config is picked up without a reboot
+void I2CDisplayAddon::loadButtonLayout() {
+	BoardOptions boardOptions = Storage::getInstance().getBoardOptions();
+	buttonSprites.clear();
+	buttonElements.clear();
+	stickElements.clear();
+
+	if (boardOptions.buttonLayout == BUTTON_LAYOUT_CUSTOMA) {
+		LayoutElement elements[DISPLAY_LAYOUT_MAX_ELEMENTS];
+		uint8_t count = Storage::getInstance().getDisplayLayout(elements);
+		for (uint8_t i = 0; i < count; i++)
+			addElement(elements[i]);
+	} else if (boardOptions.buttonLayout < BUTTON_LAYOUT_CUSTOMA) {
+		addLayout(layoutsLeft[boardOptions.buttonLayout]);
+	}
 
-	obdPreciseEllipse(&obd, startX, startY, buttonRadius, buttonRadius, 1, pGamepad->pressedLeft());
-	obdPreciseEllipse(&obd, startX + buttonMargin, startY, buttonRadius, buttonRadius, 1, pGamepad->pressedDown());
-	obdPreciseEllipse(&obd, startX + (buttonMargin * 1.875), startY + (buttonMargin / 2), buttonRadius, buttonRadius, 1, pGamepad->pressedRight());
-	obdPreciseEllipse(&obd, startX + (buttonMargin * 2.25), startY + buttonMargin * 1.875, buttonRadius, buttonRadius, 1, pGamepad->pressedUp());
+	if (boardOptions.buttonLayoutRight <= BUTTON_LAYOUT_BLANKB)
+		addLayout(layoutsRight[boardOptions.buttonLayoutRight]);
 }
 
-void I2CDisplayAddon::drawWasdBox(int startX, int startY, int buttonRadius, int buttonPadding)
+void I2CDisplayAddon::handleConfigChanged(const Message &message, void *context)
 {
-	const int buttonMargin = buttonPadding + (buttonRadius * 2);
+	if (!(message.configBlocks & (CONFIG_BLOCK_BOARD | CONFIG_BLOCK_DISPLAY_LAYOUT)))
+		return;
 
-	// WASD
-	obdPreciseEllipse(&obd, startX, startY + buttonMargin * 0.5, buttonRadius, buttonRadius, 1, pGamepad->pressedLeft());
-	obdPreciseEllipse(&obd, startX + buttonMargin, startY + buttonMargin * 0.875, buttonRadius, buttonRadius, 1, pGamepad->pressedDown());
-	obdPreciseEllipse(&obd, startX + buttonMargin * 1.5, startY - buttonMargin * 0.125, buttonRadius, buttonRadius, 1, pGamepad->pressedUp());
-	obdPreciseEllipse(&obd, startX + (buttonMargin * 2), startY + buttonMargin * 1.25, buttonRadius, buttonRadius, 1, pGamepad->pressedRight());
+	I2CDisplayAddon * addon = static_cast<I2CDisplayAddon *>(context);
+	addon->loadButtonLayout();
+	addon->fullRedraw = true;
 }
 
-void I2CDisplayAddon::drawUDLR(int startX, int startY, int buttonRadius, int buttonPadding)
+void I2CDisplayAddon::handlePerfHUD(const Message &message, void *context)
 {
-	const int buttonMargin = buttonPadding + (buttonRadius * 2);
-
-	// UDLR
-	obdPreciseEllipse(&obd, startX, startY + buttonMargin / 2, buttonRadius, buttonRadius, 1, pGamepad->pressedLeft());
-	obdPreciseEllipse(&obd, startX + (buttonMargin * 0.875), startY - (buttonMargin / 4), buttonRadius, buttonRadius, 1, pGamepad->pressedUp());
-	obdPreciseEllipse(&obd, startX + (buttonMargin * 0.875), startY + buttonMargin * 1.25, buttonRadius, buttonRadius, 1, pGamepad->pressedDown());
-	obdPreciseEllipse(&obd, startX + (buttonMargin * 1.625), startY + buttonMargin / 2, buttonRadius, buttonRadius, 1, pGamepad->pressedRight());
+	I2CDisplayAddon * addon = static_cast<I2CDisplayAddon *>(context);
+	addon->hudShown = !addon->hudShown;
+	addon->fullRedraw = true;
 }
 
-void I2CDisplayAddon::drawArcadeStick(int startX, int startY, int buttonRadius, int buttonPadding)
+// Counters are windowed once a second, so the rows are rebuilt twice a second
+bool I2CDisplayAddon::updatePerfHUD(uint64_t now)
 {
-	const int buttonMargin = buttonPadding + (buttonRadius * 2);
-
-	// Stick
-	obdPreciseEllipse(&obd, startX + (buttonMargin / 2), startY + (buttonMargin / 2), buttonRadius * 1.25, buttonRadius * 1.25, 1, 0);
-	
-	if (pGamepad->pressedUp()) {
-		if (pGamepad->pressedLeft()) {
-			obdPreciseEllipse(&obd, startX + (buttonMargin / 5), startY + (buttonMargin / 5), buttonRadius, buttonRadius, 1, 1);
-		} else if (pGamepad->pressedRight()) {
-			obdPreciseEllipse(&obd, startX + (buttonMargin * 0.875), startY + (buttonMargin / 5), buttonRadius, buttonRadius, 1, 1);
-		} else {
-			obdPreciseEllipse(&obd, startX + (buttonMargin / 2), startY, buttonRadius, buttonRadius, 1, 1);
-		}
-	} else if (pGamepad->pressedDown()) {
-		if (pGamepad->pressedLeft()) {
-			obdPreciseEllipse(&obd, startX + (buttonMargin / 5), startY + (buttonMargin * 0.875), buttonRadius, buttonRadius, 1, 1);
-		} else if (pGamepad->pressedRight()) {
-			obdPreciseEllipse(&obd, startX + (buttonMargin * 0.875), startY + (buttonMargin * 0.875), buttonRadius, buttonRadius, 1, 1);
-		} else {
-			obdPreciseEllipse(&obd, startX + buttonMargin / 2, startY + buttonMargin, buttonRadius, buttonRadius, 1, 1);
-		}
-	} else if (pGamepad->pressedLeft()) {
-		obdPreciseEllipse(&obd, startX, startY + buttonMargin / 2, buttonRadius, buttonRadius, 1, 1);
-	} else if (pGamepad->pressedRight()) {
-		obdPreciseEllipse(&obd, startX + buttonMargin, startY + buttonMargin / 2, buttonRadius, buttonRadius, 1, 1);
-	} else {
-		obdPreciseEllipse(&obd, startX + buttonMargin / 2, startY + buttonMargin / 2, buttonRadius, buttonRadius, 1, 1);
-	}
+	if (!fullRedraw && now < nextHudUpdate)
+		return false;
+
+	nextHudUpdate = now + (PERF_WINDOW_US / 2);
+	MessageBus::getInstance().readStats(core0Stats);
+	const FrameStats &displayStats = scheduler.GetStats();
+	MessageQueueStats busStats = MessageBus::getInstance().getStats(1);
+
+	char lines[DISPLAY_TEXT_LINES][DISPLAY_TEXT_WIDTH + 1];
+	snprintf(lines[0], sizeof(lines[0]), "Loop %7lu/s", (unsigned long)core0Stats.loopRate);
+	snprintf(lines[1], sizeof(lines[1]), "p99 %5luus mx %5lu", (unsigned long)core0Stats.latencyP99, (unsigned long)core0Stats.latencyMax);
+	snprintf(lines[2], sizeof(lines[2]), "USB %4lu/s drop %4lu", (unsigned long)core0Stats.reportRate, (unsigned long)core0Stats.dropped);
+	if (ledStats != nullptr)
+		snprintf(lines[3], sizeof(lines[3]), "LED %3u/s %4lu+%4lu", ledStats->fps, (unsigned long)ledStats->renderTime, (unsigned long)ledStats->transmitTime);
+	else
+		snprintf(lines[3], sizeof(lines[3]), "LED off");
+	snprintf(lines[4], sizeof(lines[4]), "OLED %3u/s %5luus", displayStats.fps, (unsigned long)displayStats.renderTime);
+	snprintf(lines[5], sizeof(lines[5]), "Skip LED %3u OLED %3u", (ledStats != nullptr) ? ledStats->skipped : 0, displayStats.skipped);
+	snprintf(lines[6], sizeof(lines[6]), "Flash %3lu max %5luus", (unsigned long)core0Stats.flashCommits, (unsigned long)core0Stats.flashStall);
+	snprintf(lines[7], sizeof(lines[7]), "Bus drop %5lu", (unsigned long)busStats.dropped);
+	return updateTextPage(lines);
 }
 
-void I2CDisplayAddon::drawTwinStickA(int startX, int startY, int buttonRadius, int buttonPadding)
+// The menu lives on core0, this only draws what it last published
+bool I2CDisplayAddon::updateMenuPage(bool updated)
 {
-	const int buttonMargin = buttonPadding + (buttonRadius * 2);
-
-	// Stick
-	obdPreciseEllipse(&obd, startX + (buttonMargin / 2), startY + (buttonMargin / 2), buttonRadius * 1.25, buttonRadius * 1.25, 1, 0);
-	
-	if (pGamepad->pressedUp()) {
-		if (pGamepad->pressedLeft()) {
-			obdPreciseEllipse(&obd, startX + (buttonMargin / 5), startY + (buttonMargin / 5), buttonRadius, buttonRadius, 1, 1);
-		} else if (pGamepad->pressedRight()) {
-			obdPreciseEllipse(&obd, startX + (buttonMargin * 0.875), startY + (buttonMargin / 5), buttonRadius, buttonRadius, 1, 1);
-		} else {
-			obdPreciseEllipse(&obd, startX + (buttonMargin / 2), startY, buttonRadius, buttonRadius, 1, 1);
-		}
-	} else if (pGamepad->pressedDown()) {
-		if (pGamepad->pressedLeft()) {
-			obdPreciseEllipse(&obd, startX + (buttonMargin / 5), startY + (buttonMargin * 0.875), buttonRadius, buttonRadius, 1, 1);
-		} else if (pGamepad->pressedRight()) {
-			obdPreciseEllipse(&obd, startX + (buttonMargin * 0.875), startY + (buttonMargin * 0.875), buttonRadius, buttonRadius, 1, 1);
-		} else {
-			obdPreciseEllipse(&obd, startX + buttonMargin / 2, startY + buttonMargin, buttonRadius, buttonRadius, 1, 1);
-		}
-	} else if (pGamepad->pressedLeft()) {
-		obdPreciseEllipse(&obd, startX, startY + buttonMargin / 2, buttonRadius, buttonRadius, 1, 1);
-	} else if (pGamepad->pressedRight()) {
-		obdPreciseEllipse(&obd, startX + buttonMargin, startY + buttonMargin / 2, buttonRadius, buttonRadius, 1, 1);
-	} else {
-		obdPreciseEllipse(&obd, startX + buttonMargin / 2, startY + buttonMargin / 2, buttonRadius, buttonRadius, 1, 1);
+	if (!updated && !fullRedraw)
+		return false;
+
+	char lines[DISPLAY_TEXT_LINES][DISPLAY_TEXT_WIDTH + 1] = { };
+	snprintf(lines[0], sizeof(lines[0]), menuState.modified ? "Settings *" : "Settings");
+	for (uint8_t i = 0; i < DISPLAY_MENU_COUNT; i++) {
+		const DisplayMenuItem &item = displayMenuItems[i];
+		uint8_t value = menuState.values[i];
+		char number[4];
+		const char *name = number;
+		if (item.names != nullptr && value >= item.min && value <= item.max)
+			name = item.names[value - item.min];
+		else
+			snprintf(number, sizeof(number), "%u", value);
+
+		snprintf(lines[i + 1], sizeof(lines[i + 1]), "%c%-8s%12s", (i == menuState.selected) ? '>' : ' ', item.label, name);
 	}
+	snprintf(lines[DISPLAY_TEXT_LINES - 1], sizeof(lines[0]), "B1 Save  B2 Cancel");
+	return updateTextPage(lines);
 }
 
-void I2CDisplayAddon::drawTwinStickB(int startX, int startY, int buttonRadius, int buttonPadding)
+// Only rows whose text changed are drawn, so the flush stays a page or two
+bool I2CDisplayAddon::updateTextPage(char lines[DISPLAY_TEXT_LINES][DISPLAY_TEXT_WIDTH + 1])
 {
-	const int buttonMargin = buttonPadding + (buttonRadius * 2);
-
-	// Stick
-	obdPreciseEllipse(&obd, startX + (buttonMargin / 2), startY + (buttonMargin / 2), buttonRadius * 1.25, buttonRadius * 1.25, 1, 0);
-	
-	if (pGamepad->pressedB4()) {
-		if (pGamepad->pressedB3()) {
-			obdPreciseEllipse(&obd, startX + (buttonMargin / 5), startY + (buttonMargin / 5), buttonRadius, buttonRadius, 1, 1);
-		} else if (pGamepad->pressedB2()) {
-			obdPreciseEllipse(&obd, startX + (buttonMargin * 0.875), startY + (buttonMargin / 5), buttonRadius, buttonRadius, 1, 1);
-		} else {
-			obdPreciseEllipse(&obd, startX + (buttonMargin / 2), startY, buttonRadius, buttonRadius, 1, 1);
+	if (fullRedraw)
+		textDirty = (1 << DISPLAY_TEXT_LINES) - 1;
+
+	for (uint8_t i = 0; i < DISPLAY_TEXT_LINES; i++) {
+		std::string line(lines[i]);
+		line.resize(DISPLAY_TEXT_WIDTH, ' '); // Padded so a shorter value never leaves old text behind
+		if (line != textLines[i]) {
+			textLines[i] = line;
+			textDirty |= (1 << i);
 		}
-	} else if (pGamepad->pressedB1()) {
-		if (pGamepad->pressedB3()) {
-			obdPreciseEllipse(&obd, startX + (buttonMargin / 5), startY + (buttonMargin * 0.875), buttonRadius, buttonRadius, 1, 1);
-		} else if (pGamepad->pressedB2()) {
-			obdPreciseEllipse(&obd, startX + (buttonMargin * 0.875), startY + (buttonMargin * 0.875), buttonRadius, buttonRadius, 1, 1);
-		} else {
-			obdPreciseEllipse(&obd, startX + buttonMargin / 2, startY + buttonMargin, buttonRadius, buttonRadius, 1, 1);
-		}
-	} else if (pGamepad->pressedB3()) {
-		obdPreciseEllipse(&obd, startX, startY + buttonMargin / 2, buttonRadius, buttonRadius, 1, 1);
-	} else if (pGamepad->pressedB2()) {
-		obdPreciseEllipse(&obd, startX + buttonMargin, startY + buttonMargin / 2, buttonRadius, buttonRadius, 1, 1);
-	} else {
-		obdPreciseEllipse(&obd, startX + buttonMargin / 2, startY + buttonMargin / 2, buttonRadius, buttonRadius, 1, 1);
 	}
-}
-
-void I2CDisplayAddon::drawMAMEA(int startX, int startY, int buttonSize, int buttonPadding)
-{
-	const int buttonMargin = buttonPadding + buttonSize;
 
-	// MAME
-	obdRectangle(&obd, startX, startY + buttonMargin, startX + buttonSize, startY + buttonSize + buttonMargin, 1, pGamepad->pressedLeft());
-	obdRectangle(&obd, startX + buttonMargin, startY + buttonMargin, startX + buttonSize + buttonMargin, startY + buttonSize + buttonMargin, 1, pGamepad->pressedDown());
-	obdRectangle(&obd, startX + buttonMargin, startY, startX + buttonSize + buttonMargin, startY + buttonSize, 1, pGamepad->pressedUp());
-	obdRectangle(&obd, startX + buttonMargin * 2, startY + buttonMargin, startX + buttonSize + buttonMargin * 2, startY + buttonSize + buttonMargin, 1, pGamepad->pressedRight());
+	return textDirty != 0;
 }
 
-void I2CDisplayAddon::drawMAMEB(int startX, int startY, int buttonSize, int buttonPadding)
+void I2CDisplayAddon::drawTextPage()
 {
-	const int buttonMargin = buttonPadding + buttonSize;
-
-	// 6-button MAME Style
-	obdRectangle(&obd, startX, startY, startX + buttonSize, startY + buttonSize, 1, pGamepad->pressedB3());
-	obdRectangle(&obd, startX + buttonMargin, startY, startX + buttonSize + buttonMargin, startY + buttonSize, 1, pGamepad->pressedB4());
-	obdRectangle(&obd, startX + buttonMargin * 2, startY, startX + buttonSize + buttonMargin * 2, startY + buttonSize, 1, pGamepad->pressedR1());
+	for (uint8_t i = 0; i < DISPLAY_TEXT_LINES; i++) {
+		if (textDirty & (1 << i))
+			drawText(0, i, textLines[i]);
+	}
 
-	obdRectangle(&obd, startX, startY + buttonMargin, startX + buttonSize, startY + buttonMargin + buttonSize, 1, pGamepad->pressedB1());
-	obdRectangle(&obd, startX + buttonMargin, startY + buttonMargin, startX + buttonSize + buttonMargin, startY + buttonMargin + buttonSize, 1, pGamepad->pressedB2());
-	obdRectangle(&obd, startX + buttonMargin * 2, startY + buttonMargin, startX + buttonSize + buttonMargin * 2, startY + buttonMargin + buttonSize, 1, pGamepad->pressedR2());
+	textDirty = 0;
+}
 
+void I2CDisplayAddon::clearScreen(int render) {
+	obdFill(&obd, 0, render);
 }
 
-void I2CDisplayAddon::drawKeyboardAngled(int startX, int startY, int buttonRadius, int buttonPadding)
+void I2CDisplayAddon::drawDiamond(OBDISP *pOBD, int cx, int cy, int size, uint8_t colour, uint8_t filled)
 {
-	const int buttonMargin = buttonPadding + (buttonRadius * 2);
-
-	// MixBox
-	drawDiamond(startX, startY, buttonRadius, 1, pGamepad->pressedLeft());
-	drawDiamond(startX + buttonMargin / 2, startY + buttonMargin / 2, buttonRadius, 1, pGamepad->pressedDown());
-	drawDiamond(startX + buttonMargin, startY, buttonRadius, 1, pGamepad->pressedUp());
-	drawDiamond(startX + buttonMargin, startY + buttonMargin, buttonRadius, 1, pGamepad->pressedRight());
+	if (filled) {
+		int i;
+		for (i = 0; i < size; i++) {
+			obdDrawLine(pOBD, cx - i, cy - size + i, cx + i, cy - size + i, colour, 0);
+			obdDrawLine(pOBD, cx - i, cy + size - i, cx + i, cy + size - i, colour, 0);
+		}
+		obdDrawLine(pOBD, cx - size, cy, cx + size, cy, colour, 0); // Fill in the middle
+	}
+	obdDrawLine(pOBD, cx - size, cy, cx, cy - size, colour, 0);
+	obdDrawLine(pOBD, cx, cy - size, cx + size, cy, colour, 0);
+	obdDrawLine(pOBD, cx + size, cy, cx, cy + size, colour, 0);
+	obdDrawLine(pOBD, cx, cy + size, cx - size, cy, colour, 0);
 }
 
-void I2CDisplayAddon::drawVewlix(int startX, int startY, int buttonRadius, int buttonPadding)
+// Layout elements are turned into sprites once, the float position math never runs per frame
+void I2CDisplayAddon::addLayout(const LayoutTable &layout)
 {
-	const int buttonMargin = buttonPadding + (buttonRadius * 2);
-
-	// 8-button Vewlix
-	obdPreciseEllipse(&obd, startX + (buttonMargin * 2.75), startY + (buttonMargin * 0.2), buttonRadius, buttonRadius, 1, pGamepad->pressedB3());
-	obdPreciseEllipse(&obd, startX + (buttonMargin * 3.75), startY - (buttonMargin / 4), buttonRadius, buttonRadius, 1, pGamepad->pressedB4());
-	obdPreciseEllipse(&obd, startX + (buttonMargin * 4.75), startY - (buttonMargin / 4), buttonRadius, buttonRadius, 1, pGamepad->pressedR1());
-	obdPreciseEllipse(&obd, startX + (buttonMargin * 5.75), startY - (buttonMargin / 4), buttonRadius, buttonRadius, 1, pGamepad->pressedL1());
-
-	obdPreciseEllipse(&obd, startX + (buttonMargin * 2.75) - (buttonMargin / 3), startY + buttonMargin + (buttonMargin * 0.2), buttonRadius, buttonRadius, 1, pGamepad->pressedB1());
-	obdPreciseEllipse(&obd, startX + (buttonMargin * 3.75) - (buttonMargin / 3), startY + buttonMargin - (buttonMargin / 4), buttonRadius, buttonRadius, 1, pGamepad->pressedB2());
-	obdPreciseEllipse(&obd, startX + (buttonMargin * 4.75) - (buttonMargin / 3), startY + buttonMargin - (buttonMargin / 4), buttonRadius, buttonRadius, 1, pGamepad->pressedR2());
-	obdPreciseEllipse(&obd, startX + (buttonMargin * 5.75) - (buttonMargin / 3), startY + buttonMargin - (buttonMargin / 4), buttonRadius, buttonRadius, 1, pGamepad->pressedL2());
+	for (uint8_t i = 0; i < layout.count; i++)
+		addElement(layout.elements[i]);
 }
 
-void I2CDisplayAddon::drawVewlix7(int startX, int startY, int buttonRadius, int buttonPadding)
+void I2CDisplayAddon::addElement(const LayoutElement &element)
 {
-	const int buttonMargin = buttonPadding + (buttonRadius * 2);
-
-	// 8-button Vewlix
-	obdPreciseEllipse(&obd, startX + (buttonMargin * 2.75), startY + (buttonMargin * 0.2), buttonRadius, buttonRadius, 1, pGamepad->pressedB3());
-	obdPreciseEllipse(&obd, startX + (buttonMargin * 3.75), startY - (buttonMargin / 4), buttonRadius, buttonRadius, 1, pGamepad->pressedB4());
-	obdPreciseEllipse(&obd, startX + (buttonMargin * 4.75), startY - (buttonMargin / 4), buttonRadius, buttonRadius, 1, pGamepad->pressedR1());
-	obdPreciseEllipse(&obd, startX + (buttonMargin * 5.75), startY - (buttonMargin / 4), buttonRadius, buttonRadius, 1, pGamepad->pressedL1());
-
-	obdPreciseEllipse(&obd, startX + (buttonMargin * 2.75) - (buttonMargin / 3), startY + buttonMargin + (buttonMargin * 0.2), buttonRadius, buttonRadius, 1, pGamepad->pressedB1());
-	obdPreciseEllipse(&obd, startX + (buttonMargin * 3.75) - (buttonMargin / 3), startY + buttonMargin - (buttonMargin / 4), buttonRadius, buttonRadius, 1, pGamepad->pressedB2());
-	obdPreciseEllipse(&obd, startX + (buttonMargin * 4.75) - (buttonMargin / 3), startY + buttonMargin - (buttonMargin / 4), buttonRadius, buttonRadius, 1, pGamepad->pressedR2());
-	//obdPreciseEllipse(&obd, startX + (buttonMargin * 5.75) - (buttonMargin / 3), startY + buttonMargin - (buttonMargin / 4), buttonRadius, buttonRadius, 1, gamepad->pressedL2());
+	switch (element.shape)
+	{
+		case LAYOUT_SHAPE_ELLIPSE:
+			addButton(LAYOUT_SHAPE_ELLIPSE, element.x - element.width, element.y - element.height,
+				element.width * 2 + 1, element.height * 2 + 1, element.mask);
+			break;
+		case LAYOUT_SHAPE_RECT:
+			addButton(LAYOUT_SHAPE_RECT, element.x, element.y, element.width, element.height, element.mask);
+			break;
+		case LAYOUT_SHAPE_DIAMOND:
+			addButton(LAYOUT_SHAPE_DIAMOND, element.x - element.width, element.y - element.width,
+				element.width * 2 + 1, element.width * 2 + 1, element.mask);
+			break;
+		case LAYOUT_SHAPE_STICK:
+			addStick(element.x, element.y, element.width, element.height,
+				1u << (element.mask & 0x1F), 1u << ((element.mask >> 8) & 0x1F),
+				1u << ((element.mask >> 16) & 0x1F), 1u << ((element.mask >> 24) & 0x1F));
+			break;
+	}
 }
 
-void I2CDisplayAddon::drawSega2p(int startX, int startY, int buttonRadius, int buttonPadding)
+void I2CDisplayAddon::addButton(uint8_t shape, int x, int y, int width, int height, uint32_t mask)
 {
-	const int buttonMargin = buttonPadding + (buttonRadius * 2);
-
-	// 8-button Sega2P
-	obdPreciseEllipse(&obd, startX + (buttonMargin * 2.75), startY + (buttonMargin / 3), buttonRadius, buttonRadius, 1, pGamepad->pressedB3());
-	obdPreciseEllipse(&obd, startX + (buttonMargin * 3.75), startY - (buttonMargin / 4), buttonRadius, buttonRadius, 1, pGamepad->pressedB4());
-	obdPreciseEllipse(&obd, startX + (buttonMargin * 4.75), startY - (buttonMargin / 4), buttonRadius, buttonRadius, 1, pGamepad->pressedR1());
-	obdPreciseEllipse(&obd, startX + (buttonMargin * 5.75), startY, buttonRadius, buttonRadius, 1, pGamepad->pressedL1());
-
-	obdPreciseEllipse(&obd, startX + (buttonMargin * 2.75), startY + buttonMargin + (buttonMargin / 3), buttonRadius, buttonRadius, 1, pGamepad->pressedB1());
-	obdPreciseEllipse(&obd, startX + (buttonMargin * 3.75), startY + buttonMargin - (buttonMargin / 4), buttonRadius, buttonRadius, 1, pGamepad->pressedB2());
-	obdPreciseEllipse(&obd, startX + (buttonMargin * 4.75), startY + buttonMargin - (buttonMargin / 4), buttonRadius, buttonRadius, 1, pGamepad->pressedR2());
-	obdPreciseEllipse(&obd, startX + (buttonMargin * 5.75), startY + buttonMargin, buttonRadius, buttonRadius, 1, pGamepad->pressedL2());
+	ButtonElement element;
+	element.x = x;
+	element.page = y >> 3;
+	element.mask = mask;
+	element.sprite = getSprite(shape, width, height, y & 7);
+	buttonElements.push_back(element);
 }
 
-void I2CDisplayAddon::drawNoir8(int startX, int startY, int buttonRadius, int buttonPadding)
+void I2CDisplayAddon::addStick(int startX, int startY, int buttonRadius, int buttonMargin, uint32_t up, uint32_t down, uint32_t left, uint32_t right)
 {
-	const int buttonMargin = buttonPadding + (buttonRadius * 2);
-
-	// 8-button Noir8
-	obdPreciseEllipse(&obd, startX + (buttonMargin * 2.75), startY + (buttonMargin / 3.5), buttonRadius, buttonRadius, 1, pGamepad->pressedB3());
-	obdPreciseEllipse(&obd, startX + (buttonMargin * 3.75), startY - (buttonMargin / 4), buttonRadius, buttonRadius, 1, pGamepad->pressedB4());
-	obdPreciseEllipse(&obd, startX + (buttonMargin * 4.75), startY - (buttonMargin / 4), buttonRadius, buttonRadius, 1, pGamepad->pressedR1());
-	obdPreciseEllipse(&obd, startX + (buttonMargin * 5.75), startY, buttonRadius, buttonRadius, 1, pGamepad->pressedL1());
-
-	obdPreciseEllipse(&obd, startX + (buttonMargin * 2.75), startY + buttonMargin + (buttonMargin / 3.5), buttonRadius, buttonRadius, 1, pGamepad->pressedB1());
-	obdPreciseEllipse(&obd, startX + (buttonMargin * 3.75), startY + buttonMargin - (buttonMargin / 4), buttonRadius, buttonRadius, 1, pGamepad->pressedB2());
-	obdPreciseEllipse(&obd, startX + (buttonMargin * 4.75), startY + buttonMargin - (buttonMargin / 4), buttonRadius, buttonRadius, 1, pGamepad->pressedR2());
-	obdPreciseEllipse(&obd, startX + (buttonMargin * 5.75), startY + buttonMargin, buttonRadius, buttonRadius, 1, pGamepad->pressedL2());
+	const int gateRadius = buttonRadius * 1.25;
+	const int center = buttonMargin / 2;
+	const int inner = buttonMargin / 5;
+	const int outer = buttonMargin * 0.875;
+
+	// Ball centers for up, neutral and down rows, left, neutral and right columns
+	const int positions[9][2] = {
+		{ inner, inner }, { center, 0 },            { outer, inner },
+		{ 0, center },    { center, center },       { buttonMargin, center },
+		{ inner, outer }, { center, buttonMargin }, { outer, outer },
+	};
+
+	StickElement stick;
+	stick.up = up;
+	stick.down = down;
+	stick.left = left;
+	stick.right = right;
+	stick.gate.x = startX + center - gateRadius;
+	stick.gate.page = (startY + center - gateRadius) >> 3;
+	stick.gate.mask = 0;
+	stick.gate.sprite = getSprite(LAYOUT_SHAPE_ELLIPSE, gateRadius * 2 + 1, gateRadius * 2 + 1, (startY + center - gateRadius) & 7);
+	for (int i = 0; i < 9; i++) {
+		int ballY = startY + positions[i][1] - buttonRadius;
+		stick.balls[i].x = startX + positions[i][0] - buttonRadius;
+		stick.balls[i].page = ballY >> 3;
+		stick.balls[i].mask = up | down | left | right;
+		stick.balls[i].sprite = getSprite(LAYOUT_SHAPE_ELLIPSE, buttonRadius * 2 + 1, buttonRadius * 2 + 1, ballY & 7);
+	}
+
+	// The ball moves, so the whole stick area is cleared instead of one button
+	stick.x1 = std::max(startX - buttonRadius, 0);
+	stick.y1 = std::max(startY - buttonRadius, 0);
+	stick.x2 = std::min(startX + buttonMargin + buttonRadius, obd.width - 1);
+	stick.y2 = std::min(startY + buttonMargin + buttonRadius, obd.height - 1);
+	stickElements.push_back(stick);
 }
 
-void I2CDisplayAddon::drawCapcom(int startX, int startY, int buttonRadius, int buttonPadding)
+// Sprites are shared by every button with the same shape, size and row offset
+uint16_t I2CDisplayAddon::getSprite(uint8_t shape, int width, int height, int shift)
 {
-	const int buttonMargin = buttonPadding + (buttonRadius * 2);
-
-	// 8-button Capcom
-	obdPreciseEllipse(&obd, startX + buttonMargin * 3.25, startY, buttonRadius, buttonRadius, 1, pGamepad->pressedB3());
-	obdPreciseEllipse(&obd, startX + buttonMargin * 4.25, startY, buttonRadius, buttonRadius, 1, pGamepad->pressedB4());
-	obdPreciseEllipse(&obd, startX + buttonMargin * 5.25, startY, buttonRadius, buttonRadius, 1, pGamepad->pressedR1());
-	obdPreciseEllipse(&obd, startX + buttonMargin * 6.25, startY, buttonRadius, buttonRadius, 1, pGamepad->pressedL1());
-
-	obdPreciseEllipse(&obd, startX + buttonMargin * 3.25, startY + buttonMargin, buttonRadius, buttonRadius, 1, pGamepad->pressedB1());
-	obdPreciseEllipse(&obd, startX + buttonMargin * 4.25, startY + buttonMargin, buttonRadius, buttonRadius, 1, pGamepad->pressedB2());
-	obdPreciseEllipse(&obd, startX + buttonMargin * 5.25, startY + buttonMargin, buttonRadius, buttonRadius, 1, pGamepad->pressedR2());
-	obdPreciseEllipse(&obd, startX + buttonMargin * 6.25, startY + buttonMargin, buttonRadius, buttonRadius, 1, pGamepad->pressedL2());
+	for (uint16_t i = 0; i < buttonSprites.size(); i++) {
+		const ButtonSprite &sprite = buttonSprites[i];
+		if (sprite.shape == shape && sprite.width == width && sprite.height == height && sprite.shift == shift)
+			return i;
+	}
+
+	ButtonSprite sprite;
+	sprite.shape = shape;
+	sprite.width = width;
+	sprite.height = height;
+	sprite.shift = shift;
+	sprite.pages = (shift + height + 7) / 8;
+	sprite.pressed = rasterize(sprite, true);
+	sprite.released = rasterize(sprite, false);
+
+	// A button owns every pixel of its filled shape, released ones clear their old fill
+	sprite.cover = sprite.pressed;
+	for (size_t i = 0; i < sprite.cover.size(); i++)
+		sprite.cover[i] |= sprite.released[i];
+
+	buttonSprites.push_back(sprite);
+	return buttonSprites.size() - 1;
 }
 
-void I2CDisplayAddon::drawCapcom6(int startX, int startY, int buttonRadius, int buttonPadding)
+std::vector<uint8_t> I2CDisplayAddon::rasterize(const ButtonSprite &sprite, bool filled)
 {
-	const int buttonMargin = buttonPadding + (buttonRadius * 2);
+	std::vector<uint8_t> pixels(sprite.width * sprite.pages, 0);
+	OBDISP canvas = { };
+	obdCreateVirtualDisplay(&canvas, sprite.width, sprite.pages * 8, pixels.data());
 
-	// 6-button Capcom
-	obdPreciseEllipse(&obd, startX + buttonMargin * 3.25, startY, buttonRadius, buttonRadius, 1, pGamepad->pressedB3());
-	obdPreciseEllipse(&obd, startX + buttonMargin * 4.25, startY, buttonRadius, buttonRadius, 1, pGamepad->pressedB4());
-	obdPreciseEllipse(&obd, startX + buttonMargin * 5.25, startY, buttonRadius, buttonRadius, 1, pGamepad->pressedR1());
+	const int top = sprite.shift;
+	switch (sprite.shape)
+	{
+		case LAYOUT_SHAPE_ELLIPSE:
+			obdPreciseEllipse(&canvas, sprite.width / 2, top + sprite.height / 2, sprite.width / 2, sprite.height / 2, 1, filled);
+			break;
+		case LAYOUT_SHAPE_RECT:
+			obdRectangle(&canvas, 0, top, sprite.width - 1, top + sprite.height - 1, 1, filled);
+			break;
+		case LAYOUT_SHAPE_DIAMOND:
+			drawDiamond(&canvas, sprite.width / 2, top + sprite.height / 2, sprite.width / 2, 1, filled);
+			break;
+	}
 
-	obdPreciseEllipse(&obd, startX + buttonMargin * 3.25, startY + buttonMargin, buttonRadius, buttonRadius, 1, pGamepad->pressedB1());
-	obdPreciseEllipse(&obd, startX + buttonMargin * 4.25, startY + buttonMargin, buttonRadius, buttonRadius, 1, pGamepad->pressedB2());
-	obdPreciseEllipse(&obd, startX + buttonMargin * 5.25, startY + buttonMargin, buttonRadius, buttonRadius, 1, pGamepad->pressedR2());
+	return pixels;
 }
 
-void I2CDisplayAddon::drawSticklessButtons(int startX, int startY, int buttonRadius, int buttonPadding)
+// Sprites are stored in the display's page layout, a draw is a masked byte copy per column
+void I2CDisplayAddon::blitSprite(const ButtonElement &element, bool isPressed)
 {
-	const int buttonMargin = buttonPadding + (buttonRadius * 2);
-
-	// 8-button
-	obdPreciseEllipse(&obd, startX + (buttonMargin * 2.75), startY, buttonRadius, buttonRadius, 1, pGamepad->pressedB3());
-	obdPreciseEllipse(&obd, startX + (buttonMargin * 3.75), startY - (buttonMargin / 4), buttonRadius, buttonRadius, 1, pGamepad->pressedB4());
-	obdPreciseEllipse(&obd, startX + (buttonMargin * 4.75), startY - (buttonMargin / 4), buttonRadius, buttonRadius, 1, pGamepad->pressedR1());
-	obdPreciseEllipse(&obd, startX + (buttonMargin * 5.75), startY, buttonRadius, buttonRadius, 1, pGamepad->pressedL1());
-
-	obdPreciseEllipse(&obd, startX + (buttonMargin * 2.75), startY + buttonMargin, buttonRadius, buttonRadius, 1, pGamepad->pressedB1());
-	obdPreciseEllipse(&obd, startX + (buttonMargin * 3.75), startY + buttonMargin - (buttonMargin / 4), buttonRadius, buttonRadius, 1, pGamepad->pressedB2());
-	obdPreciseEllipse(&obd, startX + (buttonMargin * 4.75), startY + buttonMargin - (buttonMargin / 4), buttonRadius, buttonRadius, 1, pGamepad->pressedR2());
-	obdPreciseEllipse(&obd, startX + (buttonMargin * 5.75), startY + buttonMargin, buttonRadius, buttonRadius, 1, pGamepad->pressedL2());
+	const ButtonSprite &sprite = buttonSprites[element.sprite];
+	const uint8_t *image = isPressed ? sprite.pressed.data() : sprite.released.data();
+	const int displayPages = obd.height >> 3;
+
+	for (int p = 0; p < sprite.pages; p++) {
+		int page = element.page + p;
+		if (page < 0 || page >= displayPages)
+			continue;
+
+		uint8_t *row = &ucBackBuffer[page * obd.width];
+		const uint8_t *cover = &sprite.cover[p * sprite.width];
+		const uint8_t *src = &image[p * sprite.width];
+		for (int c = 0; c < sprite.width; c++) {
+			int x = element.x + c;
+			if (x >= 0 && x < obd.width)
+				row[x] = (row[x] & ~cover[c]) | src[c];
+		}
+	}
 }
 
-void I2CDisplayAddon::drawWasdButtons(int startX, int startY, int buttonRadius, int buttonPadding)
+void I2CDisplayAddon::drawButtons()
 {
-	const int buttonMargin = buttonPadding + (buttonRadius * 2);
-
-	// 8-button
-	obdPreciseEllipse(&obd, startX + buttonMargin * 3.625, startY, buttonRadius, buttonRadius, 1, pGamepad->pressedB3());
-	obdPreciseEllipse(&obd, startX + buttonMargin * 4.625, startY - (buttonMargin / 4), buttonRadius, buttonRadius, 1, pGamepad->pressedB4());
-	obdPreciseEllipse(&obd, startX + buttonMargin * 5.625, startY - (buttonMargin / 4), buttonRadius, buttonRadius, 1, pGamepad->pressedR1());
-	obdPreciseEllipse(&obd, startX + buttonMargin * 6.625, startY, buttonRadius, buttonRadius, 1, pGamepad->pressedL1());
-
-	obdPreciseEllipse(&obd, startX + buttonMargin * 3.25, startY + buttonMargin, buttonRadius, buttonRadius, 1, pGamepad->pressedB1());
-	obdPreciseEllipse(&obd, startX + buttonMargin * 4.25, startY + buttonMargin - (buttonMargin / 4), buttonRadius, buttonRadius, 1, pGamepad->pressedB2());
-	obdPreciseEllipse(&obd, startX + buttonMargin * 5.25, startY + buttonMargin - (buttonMargin / 4), buttonRadius, buttonRadius, 1, pGamepad->pressedR2());
-	obdPreciseEllipse(&obd, startX + buttonMargin * 6.25, startY + buttonMargin, buttonRadius, buttonRadius, 1, pGamepad->pressedL2());
-}
+	for (const ButtonElement &element : buttonElements) {
+		if (regionDirty(element.mask))
+			blitSprite(element, pressed(element.mask));
+	}
 
-void I2CDisplayAddon::drawArcadeButtons(int startX, int startY, int buttonRadius, int buttonPadding)
-{
-	const int buttonMargin = buttonPadding + (buttonRadius * 2);
-
-	// 8-button
-	obdPreciseEllipse(&obd, startX + buttonMargin * 3.125, startY, buttonRadius, buttonRadius, 1, pGamepad->pressedB3());
-	obdPreciseEllipse(&obd, startX + buttonMargin * 4.125, startY - (buttonMargin / 4), buttonRadius, buttonRadius, 1, pGamepad->pressedB4());
-	obdPreciseEllipse(&obd, startX + buttonMargin * 5.125, startY - (buttonMargin / 4), buttonRadius, buttonRadius, 1, pGamepad->pressedR1());
-	obdPreciseEllipse(&obd, startX + buttonMargin * 6.125, startY, buttonRadius, buttonRadius, 1, pGamepad->pressedL1());
-
-	obdPreciseEllipse(&obd, startX + buttonMargin * 2.875, startY + buttonMargin, buttonRadius, buttonRadius, 1, pGamepad->pressedB1());
-	obdPreciseEllipse(&obd, startX + buttonMargin * 3.875, startY + buttonMargin - (buttonMargin / 4), buttonRadius, buttonRadius, 1, pGamepad->pressedB2());
-	obdPreciseEllipse(&obd, startX + buttonMargin * 4.875, startY + buttonMargin - (buttonMargin / 4), buttonRadius, buttonRadius, 1, pGamepad->pressedR2());
-	obdPreciseEllipse(&obd, startX + buttonMargin * 5.875, startY + buttonMargin, buttonRadius, buttonRadius, 1, pGamepad->pressedL2());
-}
+	for (const StickElement &stick : stickElements) {
+		if (!regionDirty(stick.up | stick.down | stick.left | stick.right))
+			continue;
 
-// I pulled this out of my PR, brought it back because of recent talks re: SOCD and rhythm games
-// Enjoy!
+		// Up wins over down and left over right, like the stick drawing always did
+		int row = pressed(stick.up) ? 0 : (pressed(stick.down) ? 2 : 1);
+		int column = pressed(stick.left) ? 0 : (pressed(stick.right) ? 2 : 1);
+		obdRectangle(&obd, stick.x1, stick.y1, stick.x2, stick.y2, 0, 1);
+		blitSprite(stick.gate, false);
+		blitSprite(stick.balls[row * 3 + column], true);
+	}
+}
 
-void I2CDisplayAddon::drawDancepadA(int startX, int startY, int buttonSize, int buttonPadding)
+SplashFrame I2CDisplayAddon::getSplashFrame(int splashMode, int splashSpeed)
 {
-	const int buttonMargin = buttonPadding + buttonSize;
+	SplashFrame frame = { };
+	frame.bandTop = -1;
+	frame.bandBottom = obd.height;
 
-	obdRectangle(&obd, startX, startY + buttonMargin, startX + buttonSize, startY + buttonSize + buttonMargin, 1, pGamepad->pressedLeft());
-	obdRectangle(&obd, startX + buttonMargin, startY + buttonMargin * 2, startX + buttonSize + buttonMargin, startY + buttonSize + buttonMargin * 2, 1, pGamepad->pressedDown());
-	obdRectangle(&obd, startX + buttonMargin, startY, startX + buttonSize + buttonMargin, startY + buttonSize, 1, pGamepad->pressedUp());
-	obdRectangle(&obd, startX + buttonMargin * 2, startY + buttonMargin, startX + buttonSize + buttonMargin * 2, startY + buttonSize + buttonMargin, 1, pGamepad->pressedRight());
-}
+	int mils = getMillis();
+	switch (splashMode)
+	{
+		case STATICSPLASH: // Default, display static or custom image
+			frame.image = true;
+			break;
+		case CLOSEIN: // Close-in. Animate the GP2040 logo
+			frame.logos = true;
+			frame.logoTop = std::min<int>((mils / splashSpeed) - 39, 0);
+			frame.logoBottom = std::max<int>(64 - (mils / (splashSpeed * 2)), 44);
+			break;
+		case CLOSEINCUSTOM: // Close-in on custom image or delayed close-in if custom image does not exist
+			frame.image = (splashCustom.size > 0);
+			if (mils > 2500) {
+				int milss = mils - 2500;
+				frame.bandTop = std::min<int>(1 + (milss / splashSpeed), obd.height - 1);
+				frame.bandBottom = std::max<int>(62 - (milss / (splashSpeed * 2)), 0);
+				frame.logos = true;
+				frame.logoTop = std::min<int>((milss / splashSpeed) - 39, 0);
+				frame.logoBottom = std::max<int>(64 - (milss / (splashSpeed * 2)), 44);
+			}
+			break;
+	}
 
-void I2CDisplayAddon::drawDancepadB(int startX, int startY, int buttonSize, int buttonPadding)
-{
-	const int buttonMargin = buttonPadding + buttonSize;
-	
-	obdRectangle(&obd, startX, startY, startX + buttonSize, startY + buttonSize, 1, pGamepad->pressedB2()); // Up/Left
-	obdRectangle(&obd, startX, startY + buttonMargin * 2, startX + buttonSize, startY + buttonSize + buttonMargin * 2, 1, pGamepad->pressedB4()); // Down/Left
-	obdRectangle(&obd, startX + buttonMargin * 2, startY, startX + buttonSize + buttonMargin * 2, startY + buttonSize, 1, pGamepad->pressedB1()); // Up/Right
-	obdRectangle(&obd, startX + buttonMargin * 2, startY + buttonMargin * 2, startX + buttonSize + buttonMargin * 2, startY + buttonSize + buttonMargin * 2, 1, pGamepad->pressedB3()); // Down/Right
+	return frame;
 }
 
-void I2CDisplayAddon::drawBlankA(int startX, int startY, int buttonSize, int buttonPadding)
+// The logos move a row every few frames, so most frames leave the splash alone and skip the flush
+bool I2CDisplayAddon::updateSplash()
 {
-}
+	SplashFrame frame = getSplashFrame(SPLASH_MODE, 90);
+	const SplashFrame &last = splashFrame;
+
+	int top = obd.height;
+	int bottom = -1;
+	auto changed = [&](int firstRow, int lastRow) {
+		top = std::min(top, firstRow);
+		bottom = std::max(bottom, lastRow);
+	};
+
+	if (fullRedraw || frame.image != last.image || frame.logos != last.logos) {
+		changed(0, obd.height - 1);
+	} else {
+		if (frame.logoTop != last.logoTop)
+			changed(std::min(frame.logoTop, last.logoTop), std::max(frame.logoTop, last.logoTop) + bootLogoTop.height - 1);
+		if (frame.logoBottom != last.logoBottom)
+			changed(std::min(frame.logoBottom, last.logoBottom), std::max(frame.logoBottom, last.logoBottom) + bootLogoBottom.height - 1);
+		if (frame.bandTop != last.bandTop)
+			changed(std::min(frame.bandTop, last.bandTop) + 1, std::max(frame.bandTop, last.bandTop));
+		if (frame.bandBottom != last.bandBottom)
+			changed(std::min(frame.bandBottom, last.bandBottom), std::max(frame.bandBottom, last.bandBottom) - 1);
+	}
 
-void I2CDisplayAddon::drawBlankB(int startX, int startY, int buttonSize, int buttonPadding)
-{
+	splashFrame = frame;
+	top = std::max(top, 0);
+	bottom = std::min(bottom, obd.height - 1);
+	if (top > bottom)
+		return false;
+
+	splashFirstPage = top >> 3;
+	splashLastPage = bottom >> 3;
+	return true;
 }
 
-void I2CDisplayAddon::drawSplashScreen(int splashMode, int splashSpeed)
+// Pages that changed are cleared and everything overlapping them is decoded straight into the back buffer
+void I2CDisplayAddon::drawSplashScreen()
 {
-    int mils = getMillis();
-    switch (splashMode)
-	{
-		case STATICSPLASH: // Default, display static or custom image
-            if ((sizeof(splashCustom) / sizeof(*splashCustom)) > 0) {
-                obdDrawSprite(&obd, (uint8_t *)splashCustom, 128, 64, 16, 0, 0, 1);
-            } else {
-			    obdDrawSprite(&obd, (uint8_t *)splashImageMain, 128, 64, 16, 0, 0, 1);
-            }
-			break;
-		case CLOSEIN: // Close-in. Animate the GP2040 logo
-			obdDrawSprite(&obd, (uint8_t *)bootLogoTop, 43, 39, 6, 43, std::min<int>((mils / splashSpeed) - 39, 0), 1);
-			obdDrawSprite(&obd, (uint8_t *)bootLogoBottom, 80, 21, 10, 24, std::max<int>(64 - (mils / (splashSpeed * 2)), 44), 1);
-			break;
-        case CLOSEINCUSTOM: // Close-in on custom image or delayed close-in if custom image does not exist
-            if ((sizeof(splashCustom) / sizeof(*splashCustom)) > 0) {
-               obdDrawSprite(&obd, (uint8_t *)splashCustom, 128, 64, 16, 0, 0, 1);
-            }
-            if (mils > 2500) {
-                int milss = mils - 2500;
-                obdRectangle(&obd, 0, 0, 127, 1 + (milss / splashSpeed), 0, 1);
-                obdRectangle(&obd, 0, 63, 127, 62 - (milss / (splashSpeed * 2)), 0, 1);
-                obdDrawSprite(&obd, (uint8_t *)bootLogoTop, 43, 39, 6, 43, std::min<int>((milss / splashSpeed) - 39, 0), 1);
-                obdDrawSprite(&obd, (uint8_t *)bootLogoBottom, 80, 21, 10, 24, std::max<int>(64 - (milss / (splashSpeed * 2)), 44), 1);
-            }
-            break;
+	const SplashFrame &frame = splashFrame;
+	const int pages = obd.height >> 3;
+	if (splashFirstPage > splashLastPage)
+		return;
+
+	memset(&ucBackBuffer[splashFirstPage * obd.width], 0, (splashLastPage - splashFirstPage + 1) * obd.width);
+
+	int top = splashFirstPage << 3;
+	int bottom = (splashLastPage << 3) + 7;
+	if (frame.image) {
+		const RLEBitmap &image = (splashCustom.size > 0) ? splashCustom : splashImageMain;
+		drawRLEBitmap(ucBackBuffer, obd.width, pages, image, 0, 0, splashFirstPage, splashLastPage);
 	}
+	if (frame.bandTop >= top)
+		obdRectangle(&obd, 0, top, obd.width - 1, std::min<int>(frame.bandTop, bottom), 0, 1);
+	if (frame.bandBottom <= bottom)
+		obdRectangle(&obd, 0, std::max<int>(frame.bandBottom, top), obd.width - 1, bottom, 0, 1);
+	if (frame.logos) {
+		drawRLEBitmap(ucBackBuffer, obd.width, pages, bootLogoTop, 43, frame.logoTop, splashFirstPage, splashLastPage);
+		drawRLEBitmap(ucBackBuffer, obd.width, pages, bootLogoBottom, 24, frame.logoBottom, splashFirstPage, splashLastPage);
+	}
+
+	splashFirstPage = 0;
+	splashLastPage = -1;
 }
 
 void I2CDisplayAddon::drawText(int x, int y, std::string text) {
@@ -528,6 +552,7 @@ void I2CDisplayAddon::drawStatusBar(Gamepad * gamepad)
 
 	// Limit to 21 chars with 6x8 font for now
 	statusBar.clear();
+	obdRectangle(&obd, 0, 0, 127, 7, 0, 1); // Only the status row is redrawn when a mode changes
 
 	switch (gamepad->options.inputMode)
 	{
@@ -7,6 +7,7 @@
 #include "AnimationStorage.hpp"
 #include "NeoPico.hpp"
 #include "Pixel.hpp"
+#include "ResourceManager.hpp"
 #include "PlayerLEDs.h"
 #include "gp2040.h"
 #include "addons/neopicoleds.h"
@@ -18,73 +19,35 @@
 
 static std::vector<uint8_t> EMPTY_VECTOR;
 
-uint32_t rgbPLEDValues[4];
+bool hasLEDChains(const LEDOptions &ledOptions) {
+	if (ledOptions.chainCount == 0)
+		return ledOptions.dataPin != -1;
 
-// TODO: Make this a helper function
-// Animation Helper for Player LEDs
-PLEDAnimationState getXInputAnimationNEOPICO(uint8_t *data)
-{
-	PLEDAnimationState animationState =
-	{
-		.state = 0,
-		.animation = PLED_ANIM_NONE,
-		.speed = PLED_SPEED_OFF,
-	};
-
-	// Check first byte for LED payload
-	if (data[0] == 0x01)
-	{
-		switch (data[2])
-		{
-			case XINPUT_PLED_BLINKALL:
-			case XINPUT_PLED_ROTATE:
-			case XINPUT_PLED_BLINK:
-			case XINPUT_PLED_SLOWBLINK:
-			case XINPUT_PLED_ALTERNATE:
-				animationState.state = (PLED_STATE_LED1 | PLED_STATE_LED2 | PLED_STATE_LED3 | PLED_STATE_LED4);
-				animationState.animation = PLED_ANIM_BLINK;
-				animationState.speed = PLED_SPEED_FAST;
-				break;
-
-			case XINPUT_PLED_FLASH1:
-			case XINPUT_PLED_ON1:
-				animationState.state = PLED_STATE_LED1;
-				animationState.animation = PLED_ANIM_SOLID;
-				animationState.speed = PLED_SPEED_OFF;
-				break;
-
-			case XINPUT_PLED_FLASH2:
-			case XINPUT_PLED_ON2:
-				animationState.state = PLED_STATE_LED2;
-				animationState.animation = PLED_ANIM_SOLID;
-				animationState.speed = PLED_SPEED_OFF;
-				break;
-
-			case XINPUT_PLED_FLASH3:
-			case XINPUT_PLED_ON3:
-				animationState.state = PLED_STATE_LED3;
-				animationState.animation = PLED_ANIM_SOLID;
-				animationState.speed = PLED_SPEED_OFF;
-				break;
-
-			case XINPUT_PLED_FLASH4:
-			case XINPUT_PLED_ON4:
-				animationState.state = PLED_STATE_LED4;
-				animationState.animation = PLED_ANIM_SOLID;
-				animationState.speed = PLED_SPEED_OFF;
-				break;
-
-			default:
-				break;
-		}
+	for (int i = 0; i < ledOptions.chainCount && i < LED_MAX_CHAINS; i++) {
+		if (ledOptions.chains[i].dataPin != -1)
+			return true;
 	}
 
-	return animationState;
+	return false;
 }
 
+// Every chain needs a state machine and a DMA channel, don't start if other addons already hold them
 bool NeoPicoLEDAddon::available() {
 	LEDOptions ledOptions = Storage::getInstance().getLEDOptions();
-	return ledOptions.dataPin != -1;
+	if (!hasLEDChains(ledOptions))
+		return false;
+
+	ResourceRequest request = { &ws2812_program, 1, 1 };
+	if (ledOptions.chainCount > 0) {
+		request.stateMachines = 0;
+		for (int i = 0; i < ledOptions.chainCount && i < LED_MAX_CHAINS; i++) {
+			if (ledOptions.chains[i].dataPin != -1 && ledOptions.chains[i].ledCount > 0)
+				request.stateMachines++;
+		}
+		request.dmaChannels = request.stateMachines;
+	}
+
+	return ResourceManager::getInstance().CanClaim(request);
 }
 
 void NeoPicoLEDAddon::setup()
@@ -99,75 +62,118 @@ void NeoPicoLEDAddon::setup()
 		neoPLEDs = new NeoPicoPlayerLEDs();
 	}
 
-	neopico = nullptr; // set neopico to null
-
-	// Create a dummy Neo Pico for the initial configuration
-	neopico = new NeoPico(-1, 0);
 	configureLEDs();
 
-	nextRunTime = make_timeout_time_ms(0); // Reset timeout
+	MessageBus::getInstance().subscribe(MESSAGE_CONFIG_CHANGED, NeoPicoLEDAddon::handleConfigChanged, this);
+	MessageBus::getInstance().subscribe(MESSAGE_HOTKEY, NeoPicoLEDAddon::handleHotkey, this);
+	MessageBus::getInstance().subscribe(MESSAGE_ANIMATION_OPTIONS, NeoPicoLEDAddon::handleAnimationOptions, this);
+	if (PLED_TYPE == PLED_TYPE_RGB)
+		MessageBus::getInstance().subscribe(MESSAGE_PLAYER_LEDS, NeoPicoLEDAddon::handlePlayerLEDs, this);
 }
 
-void NeoPicoLEDAddon::process()
+// Brightness changes from config apply live, chain changes still need a reboot
+void NeoPicoLEDAddon::handleConfigChanged(const Message &message, void *context)
 {
+	NeoPicoLEDAddon * addon = static_cast<NeoPicoLEDAddon *>(context);
+	if (message.configBlocks & CONFIG_BLOCK_LED_PROGRAM)
+		addon->loadLEDProgram();
+
+	if (!(message.configBlocks & CONFIG_BLOCK_LED))
+		return;
+
 	LEDOptions ledOptions = Storage::getInstance().getLEDOptions();
-	if (ledOptions.dataPin < 0 || !time_reached(this->nextRunTime))
+	addon->as.ConfigureBrightness(ledOptions.brightnessMaximum, ledOptions.brightnessSteps);
+	addon->as.SetBrightness(addon->as.GetBrightness());
+	addon->scheduler.SetFrameRate((ledOptions.frameRate != 0) ? ledOptions.frameRate : LED_FRAME_RATE);
+}
+
+// LED hotkeys are detected on Core0 so the combo never reaches the host
+void NeoPicoLEDAddon::handleHotkey(const Message &message, void *context)
+{
+	NeoPicoLEDAddon * addon = static_cast<NeoPicoLEDAddon *>(context);
+	addon->as.HandleEvent(message.hotkey);
+}
+
+// Core1 saves the running options every frame, so new ones have to be applied here to stick
+void NeoPicoLEDAddon::handleAnimationOptions(const Message &message, void *context)
+{
+	NeoPicoLEDAddon * addon = static_cast<NeoPicoLEDAddon *>(context);
+	addon->as.SetOptions(message.animationOptions);
+	addon->as.SetMode(addon->as.options.baseAnimationIndex);
+	addon->as.SetPressEffect(addon->as.options.pressEffectIndex);
+	AnimationStore.save();
+}
+
+// Player LED pattern from the host, decoded on Core0 once per OUT report
+void NeoPicoLEDAddon::handlePlayerLEDs(const Message &message, void *context)
+{
+	NeoPicoLEDAddon * addon = static_cast<NeoPicoLEDAddon *>(context);
+	addon->animationState.state = message.playerLEDs.state;
+	addon->animationState.animation = message.playerLEDs.animation;
+	addon->animationState.speed = message.playerLEDs.speed;
+}
+
+void NeoPicoLEDAddon::process()
+{
+	uint64_t frameStart = time_us_64();
+	if (chains.empty() || !scheduler.FrameDue(frameStart))
 		return;
 
 	Gamepad * gamepad = Storage::getInstance().GetProcessedGamepad();
-	uint8_t * featureData = Storage::getInstance().GetFeatureData();
-	AnimationHotkey action = animationHotkeys(gamepad);
 	if (PLED_TYPE == PLED_TYPE_RGB) {
 		inputMode = gamepad->options.inputMode; // HACK
-		switch (gamepad->options.inputMode) {
-			case INPUT_MODE_XINPUT:
-				animationState = getXInputAnimationNEOPICO(featureData);
-				if (neoPLEDs != nullptr && animationState.animation != PLED_ANIM_NONE)
-					neoPLEDs->animate(animationState);
-				break;
-		}
-	}
-
-	if ( action != HOTKEY_LEDS_NONE ) {
-		as.HandleEvent(action);
+		if (neoPLEDs != nullptr && animationState.animation != PLED_ANIM_NONE)
+			neoPLEDs->animate(animationState);
 	}
 
-	uint32_t buttonState = gamepad->state.dpad << 16 | gamepad->state.buttons;
-	vector<Pixel> pressed;
-	for (auto row : matrix.pixels)
-	{
-		for (auto pixel : row)
-		{
-			if (buttonState & pixel.mask)
-				pressed.push_back(pixel);
-		}
-	}
-	if (pressed.size() > 0)
-		as.HandlePressed(pressed);
+	// Only buttons that have LEDs count as pressed, so other buttons don't restart the press animation
+	uint32_t pressedMask = (gamepad->state.dpad << 16 | gamepad->state.buttons) & ledMask;
+	if (pressedMask != 0)
+		as.HandlePressed(pressedMask);
 	else
 		as.ClearPressed();
 
-	as.Animate();
-	as.ApplyBrightness(frame);
-
-	// Apply the player LEDs to our first 4 leds if we're in NEOPIXEL mode
+	// Player LEDs sit on their own layer above the button effects
 	if (PLED_TYPE == PLED_TYPE_RGB) {
 		switch (inputMode) { // HACK
 			case INPUT_MODE_XINPUT:
 				for (int i = 0; i < PLED_COUNT; i++) {
-					float level = (static_cast<float>(PLED_MAX_LEVEL - neoPLEDs->getLedLevels()[i]) / static_cast<float>(PLED_MAX_LEVEL));
-					float brightness = as.GetBrightnessX() * level;
-					rgbPLEDValues[i] = ((RGB)ColorGreen).value(neopico->GetFormat(), brightness);
-					frame[PLED_PINS[i]] = rgbPLEDValues[i];
+					// Scale green by the PWM level, brightness is applied with the rest of the frame
+					uint8_t level = (PLED_MAX_LEVEL - neoPLEDs->getLedLevels()[i]) >> 8;
+					if (PLED_PINS[i] >= 0)
+						as.compositor.SetPixel(LAYER_PLAYER_LEDS, PLED_PINS[i], RGB(0, level, 0));
 				}
+				break;
+			default:
+				as.compositor.ClearLayer(LAYER_PLAYER_LEDS);
+				break;
 		}
 	}
 
-	neopico->SetFrame(frame);
-	neopico->Show();
-	AnimationStore.save();
+	// Unchanged frames skip packing and transmission, a chain that was still busy retries next frame
+	bool transmit = as.Animate(frameStart / 1000) || framePending;
+	if (transmit) {
+		as.ApplyBrightness(frame.data());
+
+		// Every chain starts its DMA right away, so they all transmit at the same time
+		framePending = false;
+		uint32_t * chainFrame = frame.data();
+		for (NeoPico * chain : chains) {
+			chain->SetFrame(chainFrame, frameFormat);
+			if (!chain->Show() && chain->IsBusy())
+				framePending = true;
+			chainFrame += chain->GetPixelCount();
+		}
+	}
 
-	this->nextRunTime = make_timeout_time_ms(NeoPicoLEDAddon::intervalMS);
+	// Chains transmit in parallel, so the slowest one is the transmit time
+	uint32_t transmitTime = 0;
+	for (NeoPico * chain : chains)
+		transmitTime = std::max(transmitTime, chain->GetTransmitTime());
+	scheduler.RecordTransmit(transmitTime);
+	scheduler.RecordRender((uint32_t)(time_us_64() - frameStart), transmit);
+
+	AnimationStore.save();
 }
 
 std::vector<uint8_t> * NeoPicoLEDAddon::getLEDPositions(string button, std::vector<std::vector<uint8_t>> *positions)
@@ -183,6 +189,10 @@ std::vector<uint8_t> * NeoPicoLEDAddon::getLEDPositions(string button, std::vect
 #define PIXEL(BUTTON, MASK) \
 	Pixel(buttonPositions[BUTTON], MASK, *getLEDPositions(BUTTON, positions))
 
+// Pixel that isn't where its grid cell puts it, X/Y are in layout cells (0.5 is the center of the first cell)
+#define PIXEL_AT(BUTTON, MASK, X, Y) \
+	Pixel(buttonPositions[BUTTON], MASK, *getLEDPositions(BUTTON, positions), (int16_t)((X) * PIXEL_GRID_SIZE), (int16_t)((Y) * PIXEL_GRID_SIZE))
+
 /**
  * @brief Create an LED layout using a 2x4 matrix.
  */
@@ -207,16 +217,16 @@ std::vector<std::vector<Pixel>> NeoPicoLEDAddon::generatedLEDButtons(std::vector
 			PIXEL(BUTTON_LABEL_L2, GAMEPAD_MASK_L2),
 		},
 		{
-			PIXEL(BUTTON_LABEL_LEFT, GAMEPAD_MASK_DL),
-			PIXEL(BUTTON_LABEL_DOWN, GAMEPAD_MASK_DD),
-			PIXEL(BUTTON_LABEL_RIGHT, GAMEPAD_MASK_DR),
-			PIXEL(BUTTON_LABEL_UP, GAMEPAD_MASK_DU),
-			PIXEL(BUTTON_LABEL_S1, GAMEPAD_MASK_S1),
-			PIXEL(BUTTON_LABEL_S2, GAMEPAD_MASK_S2),
-			PIXEL(BUTTON_LABEL_L3, GAMEPAD_MASK_L3),
-			PIXEL(BUTTON_LABEL_R3, GAMEPAD_MASK_R3),
-			PIXEL(BUTTON_LABEL_A1, GAMEPAD_MASK_A1),
-			PIXEL(BUTTON_LABEL_A2, GAMEPAD_MASK_A2),
+			PIXEL_AT(BUTTON_LABEL_LEFT, GAMEPAD_MASK_DL, -2.0, 1.0),
+			PIXEL_AT(BUTTON_LABEL_DOWN, GAMEPAD_MASK_DD, -1.5, 1.5),
+			PIXEL_AT(BUTTON_LABEL_RIGHT, GAMEPAD_MASK_DR, -1.0, 1.0),
+			PIXEL_AT(BUTTON_LABEL_UP, GAMEPAD_MASK_DU, -1.5, 0.5),
+			PIXEL_AT(BUTTON_LABEL_S1, GAMEPAD_MASK_S1, -2.0, -0.5),
+			PIXEL_AT(BUTTON_LABEL_S2, GAMEPAD_MASK_S2, -1.0, -0.5),
+			PIXEL_AT(BUTTON_LABEL_L3, GAMEPAD_MASK_L3, 0.5, -0.5),
+			PIXEL_AT(BUTTON_LABEL_R3, GAMEPAD_MASK_R3, 1.5, -0.5),
+			PIXEL_AT(BUTTON_LABEL_A1, GAMEPAD_MASK_A1, 2.5, -0.5),
+			PIXEL_AT(BUTTON_LABEL_A2, GAMEPAD_MASK_A2, 3.5, -0.5),
 		},
 	};
 
@@ -246,7 +256,7 @@ std::vector<std::vector<Pixel>> NeoPicoLEDAddon::generatedLEDHitbox(vector<vecto
 			NO_PIXEL,
 		},
 		{
-			PIXEL(BUTTON_LABEL_UP, GAMEPAD_MASK_DU),
+			PIXEL_AT(BUTTON_LABEL_UP, GAMEPAD_MASK_DU, 3.0, 2.5), // Thumb button below the fingers
 			NO_PIXEL,
 			NO_PIXEL,
 		},
@@ -271,12 +281,12 @@ std::vector<std::vector<Pixel>> NeoPicoLEDAddon::generatedLEDHitbox(vector<vecto
 			NO_PIXEL,
 		},
 		{
-			PIXEL(BUTTON_LABEL_S1, GAMEPAD_MASK_S1),
-			PIXEL(BUTTON_LABEL_S2, GAMEPAD_MASK_S2),
-			PIXEL(BUTTON_LABEL_L3, GAMEPAD_MASK_L3),
-			PIXEL(BUTTON_LABEL_R3, GAMEPAD_MASK_R3),
-			PIXEL(BUTTON_LABEL_A1, GAMEPAD_MASK_A1),
-			PIXEL(BUTTON_LABEL_A2, GAMEPAD_MASK_A2),
+			PIXEL_AT(BUTTON_LABEL_S1, GAMEPAD_MASK_S1, 0.5, -0.5),
+			PIXEL_AT(BUTTON_LABEL_S2, GAMEPAD_MASK_S2, 1.5, -0.5),
+			PIXEL_AT(BUTTON_LABEL_L3, GAMEPAD_MASK_L3, 4.5, -0.5),
+			PIXEL_AT(BUTTON_LABEL_R3, GAMEPAD_MASK_R3, 5.5, -0.5),
+			PIXEL_AT(BUTTON_LABEL_A1, GAMEPAD_MASK_A1, 6.5, -0.5),
+			PIXEL_AT(BUTTON_LABEL_A2, GAMEPAD_MASK_A2, 7.5, -0.5),
 		},
 	};
 
@@ -319,12 +329,12 @@ std::vector<std::vector<Pixel>> NeoPicoLEDAddon::generatedLEDWasd(std::vector<st
 			PIXEL(BUTTON_LABEL_L2, GAMEPAD_MASK_L2),
 		},
 		{
-			PIXEL(BUTTON_LABEL_S1, GAMEPAD_MASK_S1),
-			PIXEL(BUTTON_LABEL_S2, GAMEPAD_MASK_S2),
-			PIXEL(BUTTON_LABEL_L3, GAMEPAD_MASK_L3),
-			PIXEL(BUTTON_LABEL_R3, GAMEPAD_MASK_R3),
-			PIXEL(BUTTON_LABEL_A1, GAMEPAD_MASK_A1),
-			PIXEL(BUTTON_LABEL_A2, GAMEPAD_MASK_A2),
+			PIXEL_AT(BUTTON_LABEL_S1, GAMEPAD_MASK_S1, 0.5, -0.5),
+			PIXEL_AT(BUTTON_LABEL_S2, GAMEPAD_MASK_S2, 1.5, -0.5),
+			PIXEL_AT(BUTTON_LABEL_L3, GAMEPAD_MASK_L3, 3.5, -0.5),
+			PIXEL_AT(BUTTON_LABEL_R3, GAMEPAD_MASK_R3, 4.5, -0.5),
+			PIXEL_AT(BUTTON_LABEL_A1, GAMEPAD_MASK_A1, 5.5, -0.5),
+			PIXEL_AT(BUTTON_LABEL_A2, GAMEPAD_MASK_A2, 6.5, -0.5),
 		},
 	};
 
@@ -407,24 +417,61 @@ uint8_t NeoPicoLEDAddon::setupButtonPositions()
 void NeoPicoLEDAddon::configureLEDs()
 {
 	LEDOptions ledOptions = Storage::getInstance().getLEDOptions();
+	clampLEDOptions(ledOptions); // Options stored by anything else must not be able to exhaust the heap at boot
 	uint8_t buttonCount = setupButtonPositions();
 	vector<vector<Pixel>> pixels = createLEDLayout(ledOptions.ledLayout, ledOptions.ledsPerButton, buttonCount);
 	matrix.setup(pixels, ledOptions.ledsPerButton);
+	ledMask = 0;
+	for (uint32_t mask : matrix.masks)
+		ledMask |= mask;
 	ledCount = matrix.getLedCount();
 	if (PLED_TYPE == PLED_TYPE_RGB && PLED_COUNT > 0)
 		ledCount += PLED_COUNT;
 
-	// Remove the old neopico (config can call this)
-	delete neopico;
-	neopico = new NeoPico(ledOptions.dataPin, ledCount, ledOptions.ledFormat);
-	neopico->Off();
+	// Remove the old chains (config can call this)
+	for (NeoPico * chain : chains)
+		delete chain;
+	chains.clear();
+
+	// Chains take consecutive slices of the frame, the frame covers every LED on every chain
+	uint32_t frameSize = ledCount;
+	if (ledOptions.chainCount == 0) {
+		chains.push_back(new NeoPico(ledOptions.dataPin, ledCount, ledOptions.ledFormat));
+	} else {
+		uint32_t chainTotal = 0;
+		for (int i = 0; i < ledOptions.chainCount && i < LED_MAX_CHAINS; i++) {
+			LEDChain & chain = ledOptions.chains[i];
+			chains.push_back(new NeoPico(chain.dataPin, chain.ledCount, chain.ledFormat));
+			chainTotal += chains.back()->GetPixelCount();
+		}
+		if (chainTotal > frameSize)
+			frameSize = chainTotal;
+	}
+
+	for (NeoPico * chain : chains)
+		chain->Off();
+
+	frameFormat = ledOptions.ledFormat;
+	frame.assign(frameSize, 0);
+	as.SetFrameSize(frameSize);
 
 	Animation::format = ledOptions.ledFormat;
 	as.ConfigureBrightness(ledOptions.brightnessMaximum, ledOptions.brightnessSteps);
 	as.SetOptions(AnimationStore.getAnimationOptions());
+	scheduler.SetFrameRate((ledOptions.frameRate != 0) ? ledOptions.frameRate : LED_FRAME_RATE);
 	addStaticThemes(ledOptions);
-	as.SetMode(as.options.baseAnimationIndex);
 	as.SetMatrix(matrix);
+	loadLEDProgram();
+	as.SetMode(as.options.baseAnimationIndex);
+	as.SetPressEffect(as.options.pressEffectIndex);
+}
+
+// Programs are compiled here on Core1, the web config only validates and stores them
+void NeoPicoLEDAddon::loadLEDProgram()
+{
+	uint8_t code[LED_PROGRAM_MAX_SIZE];
+	uint16_t size = Storage::getInstance().getLEDProgram(code);
+	as.LoadProgram(code, size); // A program that fails to load leaves the custom effect falling back to a static color
 }
 
 AnimationHotkey animationHotkeys(Gamepad *gamepad)
@@ -473,6 +520,16 @@ AnimationHotkey animationHotkeys(Gamepad *gamepad)
 			action = HOTKEY_LEDS_PRESS_PARAMETER_DOWN;
 			gamepad->state.buttons &= ~(GAMEPAD_MASK_L2 | gamepad->f1Mask);
 		}
+		else if (gamepad->pressedL3())
+		{
+			action = HOTKEY_LEDS_PRESS_EFFECT_UP;
+			gamepad->state.buttons &= ~(GAMEPAD_MASK_L3 | gamepad->f1Mask);
+		}
+		else if (gamepad->pressedR3())
+		{
+			action = HOTKEY_LEDS_PRESS_EFFECT_DOWN;
+			gamepad->state.buttons &= ~(GAMEPAD_MASK_R3 | gamepad->f1Mask);
+		}
 	}
 
 	return action;
@@ -4,20 +4,23 @@
  */
 
 // Pico Includes
+#include <cstdlib>
 #include <vector>
 #include "pico/stdlib.h"
+#include "hardware/clocks.h"
+#include "hardware/dma.h"
 #include "hardware/pwm.h"
 #include "GamepadEnums.h"
 #include "xinput_driver.h"
 
 // GP2040 Includes
 #include "addons/playerleds.h"
+#include "ResourceManager.hpp"
 #include "helper.h"
 #include "storagemanager.h"
 
-// TODO: make this a helper function
-// Animation Helper for Player LEDs
-PLEDAnimationState getXInputAnimationPWM(uint8_t *data)
+// Animation Helper for Player LEDs, decodes an X-Input OUT report
+PLEDAnimationState getXInputAnimation(const uint8_t *data)
 {
 	PLEDAnimationState animationState =
 	{
@@ -27,7 +30,7 @@ PLEDAnimationState getXInputAnimationPWM(uint8_t *data)
 	};
 
 	// Check first byte for LED payload
-	if (data[0] == 0x01)
+	if (data[0] == XINPUT_OUT_LED)
 	{
 		switch (data[2])
 		{
@@ -77,8 +80,24 @@ PLEDAnimationState getXInputAnimationPWM(uint8_t *data)
 	return animationState;
 }
 
+// PWM fades claim a DMA channel per slice when they start, don't count on channels other addons already hold
 bool PlayerLEDAddon::available() {
-	return PLED_TYPE != PLED_TYPE_NONE;
+	if (PLED_TYPE != PLED_TYPE_PWM)
+		return PLED_TYPE != PLED_TYPE_NONE;
+
+	uint32_t usedSlices = 0;
+	ResourceRequest request = { nullptr, 0, 0 };
+	for (int i = 0; i < PLED_COUNT; i++)
+	{
+		uint32_t sliceBit = (PLED_PINS[i] > -1) ? (1 << pwm_gpio_to_slice_num(PLED_PINS[i])) : 0;
+		if (sliceBit != 0 && !(usedSlices & sliceBit))
+		{
+			usedSlices |= sliceBit;
+			request.dmaChannels++;
+		}
+	}
+
+	return ResourceManager::getInstance().CanClaim(request);
 }
 
 void PlayerLEDAddon::setup() {
@@ -93,58 +112,252 @@ void PlayerLEDAddon::setup() {
 			break;
 	}
 
-	if (pwmLEDs != nullptr)
+	if (pwmLEDs != nullptr) {
 		pwmLEDs->setup();
+		MessageBus::getInstance().subscribe(MESSAGE_PLAYER_LEDS, PlayerLEDAddon::handlePlayerLEDs, this);
+	}
 }
 
-void PlayerLEDAddon::process()
+// Player LED pattern from the host, decoded on Core0 once per OUT report
+void PlayerLEDAddon::handlePlayerLEDs(const Message &message, void *context)
 {
-	Gamepad * gamepad = Storage::getInstance().GetProcessedGamepad();
+	PlayerLEDAddon * addon = static_cast<PlayerLEDAddon *>(context);
+	addon->animationState.state = message.playerLEDs.state;
+	addon->animationState.animation = message.playerLEDs.animation;
+	addon->animationState.speed = message.playerLEDs.speed;
+}
 
+void PlayerLEDAddon::process()
+{
 	// Player LEDs can be PWM or driven by NeoPixel
-	uint8_t * featureData = Storage::getInstance().GetFeatureData();
-	if (PLED_TYPE == PLED_TYPE_PWM) { // only process the feature queue if we're on PWM
-		if (pwmLEDs != nullptr)
-			pwmLEDs->display();
-
-		switch (gamepad->options.inputMode)
-		{
-			case INPUT_MODE_XINPUT:
-				animationState = getXInputAnimationPWM(featureData);
-				break;
-		}
+	if (PLED_TYPE == PLED_TYPE_PWM) { // only animate here if we're on PWM
 		if (pwmLEDs != nullptr && animationState.animation != PLED_ANIM_NONE)
-			pwmLEDs->animate(animationState);
+			pwmLEDs->play(animationState);
 	}
 }
 
+// Fade tables, aligned to their size for the DMA read ring
+static uint32_t fadeTables[PLED_COUNT][PLED_FADE_STEPS] __attribute__((aligned(PLED_FADE_STEPS * sizeof(uint32_t))));
+
+static inline uint16_t pledLevel(bool on, uint8_t brightness)
+{
+	return PLED_MAX_LEVEL - (on ? (brightness * brightness) : 0);
+}
+
 void PWMPlayerLEDs::setup()
 {
 	pwm_config config = pwm_get_default_config();
 	pwm_config_set_clkdiv(&config, 4.f);
 
-	std::vector<uint> sliceNums;
-
+	uint32_t usedSlices = 0;
 	for (int i = 0; i < PLED_COUNT; i++)
 	{
 		if (PLED_PINS[i] > -1)
 		{
 			gpio_set_function(PLED_PINS[i], GPIO_FUNC_PWM);
-			uint sliceNum = pwm_gpio_to_slice_num(PLED_PINS[i]);
-			uint channelNum = pwm_gpio_to_channel(PLED_PINS[i]);
-			sliceNums.push_back(sliceNum);
-			pwm_set_chan_level(sliceNum, channelNum, PLED_MAX_LEVEL);
+			usedSlices |= (1 << pwm_gpio_to_slice_num(PLED_PINS[i]));
+			writeLevel(i, PLED_MAX_LEVEL);
 		}
 	}
 
-	for (auto sliceNum : sliceNums)
-		pwm_set_enabled(sliceNum, true);
+	for (uint sliceNum = 0; sliceNum < NUM_PWM_SLICES; sliceNum++)
+	{
+		if (usedSlices & (1 << sliceNum))
+			pwm_set_enabled(sliceNum, true);
+	}
+
+	// The highest slice without a player LED paces fades, it never drives a pin
+	for (int sliceNum = NUM_PWM_SLICES - 1; sliceNum >= 0 && paceSlice < 0; sliceNum--)
+	{
+		if (!(usedSlices & (1 << sliceNum)))
+			paceSlice = sliceNum;
+	}
+
+	if (paceSlice >= 0)
+	{
+		pwm_config paceConfig = pwm_get_default_config();
+		float cycles = (clock_get_hz(clk_sys) / 1000000.f) * PLED_FADE_STEP_US;
+		pwm_config_set_clkdiv(&paceConfig, cycles / (PLED_MAX_LEVEL + 1));
+		pwm_config_set_wrap(&paceConfig, PLED_MAX_LEVEL);
+		pwm_init(paceSlice, &paceConfig, false);
+	}
 }
 
+// Only used while the fade steps in software, everything else writes levels as it changes them
 void PWMPlayerLEDs::display()
 {
 	for (int i = 0; i < PLED_COUNT; i++)
 		if (PLED_PINS[i] > -1)
-			pwm_set_gpio_level(PLED_PINS[i], ledLevels[i]);
+			writeLevel(i, ledLevels[i]);
+}
+
+void PWMPlayerLEDs::play(const PLEDAnimationState &animationState)
+{
+	if (animationState.animation == playing.animation && animationState.state == playing.state
+		&& animationState.speed == playing.speed)
+	{
+		if (softwareFade)
+		{
+			animate(animationState);
+			display();
+		}
+		return;
+	}
+
+	stop();
+	playing = animationState;
+	step = 0;
+
+	switch (playing.animation)
+	{
+		case PLED_ANIM_SOLID:
+			showState(playing.state);
+			break;
+
+		case PLED_ANIM_BLINK:
+		case PLED_ANIM_CYCLE:
+			showState(playing.state);
+			timerActive = add_repeating_timer_ms((playing.speed > 0) ? playing.speed : PLED_SPEED_LUDICROUS,
+				PWMPlayerLEDs::handleTimer, this, &timer);
+			break;
+
+		case PLED_ANIM_FADE:
+			if (!startFade())
+			{
+				softwareFade = true;
+				animate(playing);
+				display();
+			}
+			break;
+
+		default:
+			showState(0);
+			break;
+	}
+}
+
+// Runs from the timer IRQ, so it only touches the PWM levels
+bool PWMPlayerLEDs::handleTimer(repeating_timer_t *timer)
+{
+	PWMPlayerLEDs *leds = static_cast<PWMPlayerLEDs *>(timer->user_data);
+	uint8_t state = leds->playing.state;
+
+	if (leds->playing.animation == PLED_ANIM_BLINK)
+	{
+		leds->step ^= 1;
+		leds->showState(leds->step ? 0 : state);
+	}
+	else if (state != 0)
+	{
+		// Start from the first lit LED and move one LED along per step
+		uint8_t first = 0;
+		while (!(state & (1 << first)))
+			first++;
+
+		leds->step++;
+		leds->showState(1 << ((first + leds->step) % PLED_COUNT));
+	}
+
+	return true;
+}
+
+void PWMPlayerLEDs::stop()
+{
+	if (timerActive)
+	{
+		cancel_repeating_timer(&timer);
+		timerActive = false;
+	}
+
+	for (uint8_t s = 0; s < fadeSliceCount; s++)
+	{
+		ResourceManager::getInstance().ReleaseDMA(fadeSlices[s].dmaChannel);
+	}
+
+	// DMA left the compare registers at some point of the fade
+	if (fadeSliceCount > 0)
+	{
+		pwm_set_enabled(paceSlice, false);
+		for (int i = 0; i < PLED_COUNT; i++)
+			writtenLevels[i] = UINT32_MAX;
+	}
+
+	fadeSliceCount = 0;
+	softwareFade = false;
+}
+
+bool PWMPlayerLEDs::startFade()
+{
+	if (paceSlice < 0)
+		return false;
+
+	for (int i = 0; i < PLED_COUNT; i++)
+	{
+		if (PLED_PINS[i] < 0)
+			continue;
+
+		uint sliceNum = pwm_gpio_to_slice_num(PLED_PINS[i]);
+		uint8_t s = 0;
+		while (s < fadeSliceCount && fadeSlices[s].slice != sliceNum)
+			s++;
+
+		if (s == fadeSliceCount)
+		{
+			int dmaChannel = ResourceManager::getInstance().ClaimDMA("PLED");
+			if (dmaChannel < 0)
+			{
+				stop();
+				return false;
+			}
+
+			// Channels without a player LED keep their level
+			fadeSlices[s] = { sliceNum, dmaChannel };
+			fadeSliceCount++;
+			for (int t = 0; t < PLED_FADE_STEPS; t++)
+				fadeTables[s][t] = pwm_hw->slice[sliceNum].cc;
+		}
+
+		// Same curve as the software fade, out and back in
+		uint shift = (pwm_gpio_to_channel(PLED_PINS[i]) == PWM_CHAN_B) ? 16 : 0;
+		bool on = (playing.state & (1 << i)) != 0;
+		for (int t = 0; t < PLED_FADE_STEPS; t++)
+		{
+			int brightness = abs(PLED_MAX_BRIGHTNESS - (t * 4));
+			if (brightness > PLED_MAX_BRIGHTNESS)
+				brightness = PLED_MAX_BRIGHTNESS;
+			fadeTables[s][t] = (fadeTables[s][t] & ~(0xFFFFu << shift)) | ((uint32_t)pledLevel(on, brightness) << shift);
+		}
+	}
+
+	for (uint8_t s = 0; s < fadeSliceCount; s++)
+	{
+		dma_channel_config config = dma_channel_get_default_config(fadeSlices[s].dmaChannel);
+		channel_config_set_transfer_data_size(&config, DMA_SIZE_32);
+		channel_config_set_read_increment(&config, true);
+		channel_config_set_write_increment(&config, false);
+		channel_config_set_ring(&config, false, __builtin_ctz(sizeof(fadeTables[s])));
+		channel_config_set_dreq(&config, pwm_get_dreq(paceSlice));
+		dma_channel_configure(fadeSlices[s].dmaChannel, &config, &pwm_hw->slice[fadeSlices[s].slice].cc,
+			fadeTables[s], UINT32_MAX, true);
+	}
+
+	pwm_set_counter(paceSlice, 0);
+	pwm_set_enabled(paceSlice, fadeSliceCount > 0);
+	return true;
+}
+
+void PWMPlayerLEDs::showState(uint8_t state)
+{
+	for (int i = 0; i < PLED_COUNT; i++)
+		if (PLED_PINS[i] > -1)
+			writeLevel(i, pledLevel(state & (1 << i), PLED_MAX_BRIGHTNESS));
 }
 
+void PWMPlayerLEDs::writeLevel(int index, uint16_t level)
+{
+	if (writtenLevels[index] == level)
+		return;
+
+	pwm_set_gpio_level(PLED_PINS[index], level);
+	writtenLevels[index] = level;
+}
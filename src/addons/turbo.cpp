@@ -4,9 +4,6 @@
 
 #define TURBO_DEBOUNCE_MILLIS 5
 
-#define TURBO_SHOT_MIN 5
-#define TURBO_SHOT_MAX 30
-
 bool TurboInput::available() {
 	BoardOptions boardOptions = Storage::getInstance().getBoardOptions();
     return (boardOptions.pinButtonTurbo != (uint8_t)-1);
@@ -31,7 +28,8 @@ void TurboInput::setup()
     lastPressed = 0;
     lastDpad = 0;
     buttonsEnabled = 0;
-    uIntervalMS = (uint32_t)(1000.0 / boardOptions.turboShotCount);
+    shotCount = boardOptions.turboShotCount;
+    uIntervalMS = (uint32_t)(1000.0 / shotCount);
     bTurboState = false;
     bTurboFlicker = false;
     nextTimer = getMillis();
@@ -61,6 +59,12 @@ void TurboInput::process()
     uint16_t buttonsPressed = gamepad->state.buttons & TURBO_BUTTON_MASK;
     uint16_t dpadPressed = gamepad->state.dpad & GAMEPAD_MASK_DPAD;
 
+    // The shot count can also be changed from the display menu
+    if (boardOptions.turboShotCount != shotCount) {
+        shotCount = boardOptions.turboShotCount;
+        uIntervalMS = (uint32_t)(1000.0 / shotCount);
+    }
+
     // Get TURBO Button State
     bTurboState = read();
 #if TURBO_DEBOUNCE_MILLIS > 0
@@ -1,20 +1,31 @@
 #include "configmanager.h"
 
 #include "addonmanager.h"
+#include "messagebus.h"
 #include "configs/webconfig.h"
+#include "configs/serialconfig.h"
+#include "configs/displayconfig.h"
 #include "addons/neopicoleds.h"
+#include "AnimationStorage.hpp"
 
 void ConfigManager::setup(ConfigType config) {
 	switch(config) {
 		case CONFIG_TYPE_WEB:
 			setupConfig(new WebConfig());
 			break;
+		case CONFIG_TYPE_SERIAL:
+			setupConfig(new SerialConfig());
+			break;
+		case CONFIG_TYPE_DISPLAY:
+			setupConfig(new DisplayConfig());
+			break;
 	}
     this->cType = config;
 }
 
 void ConfigManager::loop() {
-    config->loop();
+    if (config != nullptr)
+        config->loop();
 }
 
 void ConfigManager::setupConfig(GPConfig * gpconfig) {
@@ -24,10 +35,35 @@ void ConfigManager::setupConfig(GPConfig * gpconfig) {
 
 void ConfigManager::setGamepadOptions(Gamepad* gamepad) {
 	gamepad->save();
+	notifyChanged(CONFIG_BLOCK_GAMEPAD);
 }
 
 void ConfigManager::setLedOptions(LEDOptions ledOptions) {
 	Storage::getInstance().setLEDOptions(ledOptions);
+	notifyChanged(CONFIG_BLOCK_LED);
+}
+
+// The LED addon owns the running animation options, only write them here when it isn't running
+void ConfigManager::setAnimationOptions(AnimationOptions animationOptions) {
+	if (hasLEDChains(Storage::getInstance().getLEDOptions())) {
+		Message message = { };
+		message.type = MESSAGE_ANIMATION_OPTIONS;
+		message.animationOptions = animationOptions;
+		MessageBus::getInstance().post(1, message);
+	} else {
+		AnimationStore.setAnimationOptions(animationOptions);
+		EEPROM.commit();
+	}
+}
+
+void ConfigManager::setLedProgram(const uint8_t *code, uint16_t size) {
+	Storage::getInstance().setLEDProgram(code, size);
+	notifyChanged(CONFIG_BLOCK_LED_PROGRAM);
+}
+
+void ConfigManager::setDisplayLayout(const LayoutElement *elements, uint8_t count) {
+	Storage::getInstance().setDisplayLayout(elements, count);
+	notifyChanged(CONFIG_BLOCK_DISPLAY_LAYOUT);
 }
 
 void ConfigManager::setBoardOptions(BoardOptions boardOptions) {
@@ -54,4 +90,13 @@ void ConfigManager::setBoardOptions(BoardOptions boardOptions) {
 	gamepad->mapButtonA2->setPin(boardOptions.pinButtonA2);
 
 	GamepadStore.save();
+	notifyChanged(CONFIG_BLOCK_BOARD);
+}
+
+// Let Core1 react to changes instead of re-reading options
+void ConfigManager::notifyChanged(uint32_t configBlocks) {
+	Message message = { };
+	message.type = MESSAGE_CONFIG_CHANGED;
+	message.configBlocks = configBlocks;
+	MessageBus::getInstance().post(1, message);
 }
@@ -0,0 +1,153 @@
+#include "configs/displayconfig.h"
+
+#include "storagemanager.h"
+#include "configmanager.h"
+#include "messagebus.h"
+#include "helper.h"
+
+#include "addons/turbo.h"
+
+static const char * const socdNames[] = { "Up Prio", "Neutral", "Last Win" };
+static const char * const dpadNames[] = { "D-pad", "Left Stick", "Right Stick" };
+static const char * const layoutNames[] = { "Arcade", "Hitbox", "WASD", "UDLR", "Kb Angled", "Keyboard", "Dancepad", "Twinstick", "Blank", "Custom" };
+static const char * const layoutRightNames[] = { "Arcade", "Hitbox", "WASD", "Vewlix", "Vewlix 7", "Capcom", "Capcom 6", "Sega 2P", "Noir 8", "Keyboard", "Dancepad", "Twinstick", "Blank" };
+
+const DisplayMenuItem displayMenuItems[DISPLAY_MENU_COUNT] =
+{
+	{ "SOCD",     SOCD_MODE_UP_PRIORITY,  SOCD_MODE_SECOND_INPUT_PRIORITY, socdNames },
+	{ "D-Pad",    DPAD_MODE_DIGITAL,      DPAD_MODE_RIGHT_ANALOG,          dpadNames },
+	{ "Turbo",    TURBO_SHOT_MIN,         TURBO_SHOT_MAX,                  nullptr },
+	{ "Layout L", BUTTON_LAYOUT_STICK,    BUTTON_LAYOUT_CUSTOMA,           layoutNames },
+	{ "Layout R", BUTTON_LAYOUT_ARCADE,   BUTTON_LAYOUT_BLANKB,            layoutRightNames },
+};
+
+void DisplayMenu::open(const uint8_t *values)
+{
+	state.open = true;
+	state.modified = false;
+	state.selected = 0;
+	memcpy(state.values, values, sizeof(state.values));
+}
+
+void DisplayMenu::select(int8_t step)
+{
+	state.selected = (state.selected + DISPLAY_MENU_COUNT + step) % DISPLAY_MENU_COUNT;
+}
+
+void DisplayMenu::change(int8_t step)
+{
+	const DisplayMenuItem &item = displayMenuItems[state.selected];
+	int value = state.values[state.selected] + step;
+	if (value < item.min)
+		value = item.min;
+	else if (value > item.max)
+		value = item.max;
+
+	if (value != state.values[state.selected]) {
+		state.values[state.selected] = value;
+		state.modified = true;
+	}
+}
+
+void DisplayConfig::setup() {
+	DisplayMenuState state = { };
+	MessageBus::getInstance().publishMenu(state);
+}
+
+// Called every poll before the gamepad is processed, so an open menu can swallow the inputs
+void DisplayConfig::loop() {
+	Gamepad * gamepad = Storage::getInstance().GetGamepad();
+	uint32_t inputs = ((uint32_t)gamepad->state.dpad << 16) | gamepad->state.buttons;
+	uint32_t pressed = inputs & ~lastInputs;
+	lastInputs = inputs;
+
+	// Inputs stay held back after the menu closes until everything is let go
+	if (releasing) {
+		releasing = (inputs != 0);
+		gamepad->state.dpad = 0;
+		gamepad->state.buttons = 0;
+		return;
+	}
+
+	if (!menu.isOpen()) {
+		// Only F1 + DISPLAY_MENU_HOTKEY on their own, anything else goes to the host and the other hotkeys
+		if (gamepad->state.dpad != 0 || gamepad->state.buttons != (gamepad->f1Mask | DISPLAY_MENU_HOTKEY)) {
+			holdStart = 0;
+			return;
+		}
+
+		uint32_t now = getMillis();
+		if (holdStart == 0)
+			holdStart = now;
+		else if ((now - holdStart) >= DISPLAY_MENU_HOLD_MS)
+			open();
+
+		// Like the other F1 hotkeys, the combo isn't reported while it's held
+		gamepad->state.buttons = 0;
+		return;
+	}
+
+	gamepad->state.dpad = 0;
+	gamepad->state.buttons = 0;
+	if (pressed == 0)
+		return;
+
+	if (pressed & (GAMEPAD_MASK_UP << 16))
+		menu.select(-1);
+	else if (pressed & (GAMEPAD_MASK_DOWN << 16))
+		menu.select(1);
+	else if (pressed & (GAMEPAD_MASK_LEFT << 16))
+		menu.change(-1);
+	else if (pressed & (GAMEPAD_MASK_RIGHT << 16))
+		menu.change(1);
+	else if (pressed & GAMEPAD_MASK_B1)
+		save();
+	else if (pressed & GAMEPAD_MASK_B2)
+		menu.close();
+	else
+		return;
+
+	releasing = !menu.isOpen();
+	MessageBus::getInstance().publishMenu(menu.getState());
+}
+
+void DisplayConfig::open() {
+	Gamepad * gamepad = Storage::getInstance().GetGamepad();
+	BoardOptions boardOptions = Storage::getInstance().getBoardOptions();
+
+	uint8_t values[DISPLAY_MENU_COUNT];
+	values[DISPLAY_MENU_SOCD] = gamepad->options.socdMode;
+	values[DISPLAY_MENU_DPAD] = gamepad->options.dpadMode;
+	values[DISPLAY_MENU_TURBO] = boardOptions.turboShotCount;
+	values[DISPLAY_MENU_LAYOUT] = boardOptions.buttonLayout;
+	values[DISPLAY_MENU_LAYOUT_RIGHT] = boardOptions.buttonLayoutRight;
+
+	menu.open(values);
+	holdStart = 0;
+	MessageBus::getInstance().publishMenu(menu.getState());
+}
+
+// Saves go through the same path as the web config, so core1 picks them up from the config message
+void DisplayConfig::save() {
+	const DisplayMenuState &state = menu.getState();
+	if (state.modified) {
+		Gamepad * gamepad = Storage::getInstance().GetGamepad();
+		if (gamepad->options.socdMode != state.values[DISPLAY_MENU_SOCD] || gamepad->options.dpadMode != state.values[DISPLAY_MENU_DPAD]) {
+			gamepad->options.socdMode = (SOCDMode)state.values[DISPLAY_MENU_SOCD];
+			gamepad->options.dpadMode = (DpadMode)state.values[DISPLAY_MENU_DPAD];
+			ConfigManager::getInstance().setGamepadOptions(gamepad);
+		}
+
+		BoardOptions boardOptions = Storage::getInstance().getBoardOptions();
+		if (boardOptions.turboShotCount != state.values[DISPLAY_MENU_TURBO]
+			|| boardOptions.buttonLayout != state.values[DISPLAY_MENU_LAYOUT]
+			|| boardOptions.buttonLayoutRight != state.values[DISPLAY_MENU_LAYOUT_RIGHT]) {
+			boardOptions.turboShotCount = state.values[DISPLAY_MENU_TURBO];
+			boardOptions.buttonLayout = (ButtonLayout)state.values[DISPLAY_MENU_LAYOUT];
+			boardOptions.buttonLayoutRight = (ButtonLayoutRight)state.values[DISPLAY_MENU_LAYOUT_RIGHT];
+			ConfigManager::getInstance().setBoardOptions(boardOptions);
+		}
+	}
+
+	menu.close();
+}
@@ -0,0 +1,409 @@
+#include "configs/serialconfig.h"
+
+#include "storagemanager.h"
+#include "configmanager.h"
+#include "helper.h"
+#include "addons/turbo.h"
+
+#include "AnimationStorage.hpp"
+#include "FlashPROM.h"
+#include "CRC32.h"
+
+#include "hardware/watchdog.h"
+#include "tusb.h"
+
+#define SERIAL_RECORD_HEADER_SIZE 3
+
+static const uint16_t blockSizes[SERIAL_BLOCK_COUNT] =
+{
+	sizeof(GamepadOptions),
+	sizeof(BoardOptions),
+	sizeof(LEDOptions),
+	sizeof(AnimationOptions),
+};
+
+// A GET for every block has to fit in one reply next to its status byte
+static_assert(
+	sizeof(GamepadOptions) + sizeof(BoardOptions) + sizeof(LEDOptions) + sizeof(AnimationOptions)
+		+ (SERIAL_BLOCK_COUNT * SERIAL_RECORD_HEADER_SIZE) < SERIAL_CONFIG_MAX_PAYLOAD,
+	"Serial config blocks don't fit in one frame"
+);
+
+static uint8_t response[SERIAL_CONFIG_MAX_PAYLOAD];
+
+static inline uint16_t readU16(const uint8_t *data) { return data[0] | (data[1] << 8); }
+static inline uint32_t readU32(const uint8_t *data) { return data[0] | (data[1] << 8) | (data[2] << 16) | ((uint32_t)data[3] << 24); }
+
+static inline void writeU16(uint8_t *data, uint16_t value)
+{
+	data[0] = value & 0xFF;
+	data[1] = value >> 8;
+}
+
+void SerialConfig::setup() {
+	pollWindowStart = getMillis();
+}
+
+void SerialConfig::loop() {
+	tud_task();
+
+	uint32_t now = getMillis();
+	polls++;
+	if ((now - pollWindowStart) >= 1000) {
+		pollRate = polls;
+		polls = 0;
+		pollWindowStart = now;
+	}
+
+	// Closing the port drops any partial frame and stops the stream
+	if (!tud_cdc_connected()) {
+		frameSize = 0;
+		streamInterval = 0;
+		return;
+	}
+
+	receive();
+
+	if (streamInterval != 0 && (int32_t)(now - nextStream) >= 0) {
+		SerialTelemetry telemetry = getTelemetry();
+		reply(SERIAL_CMD_STREAM, streamSequence++, SERIAL_STATUS_OK, (const uint8_t *)&telemetry, sizeof(telemetry));
+		nextStream = now + streamInterval;
+	}
+}
+
+// Frames are assembled straight from the CDC FIFO, bytes before a sync are skipped
+void SerialConfig::receive() {
+	while (tud_cdc_available()) {
+		if (frameSize == 0) {
+			uint8_t sync;
+			if (tud_cdc_read(&sync, 1) == 1 && sync == SERIAL_CONFIG_SYNC) {
+				frame[frameSize++] = sync;
+				frameStart = getMillis();
+			}
+			continue;
+		}
+
+		uint16_t needed = SERIAL_CONFIG_HEADER_SIZE;
+		if (frameSize >= SERIAL_CONFIG_HEADER_SIZE) {
+			uint16_t length = readU16(frame + 3);
+			if (length > SERIAL_CONFIG_MAX_PAYLOAD) { // Not a real header, look for the next sync
+				badFrames++;
+				frameSize = 0;
+				continue;
+			}
+			needed = SERIAL_CONFIG_HEADER_SIZE + length + 4;
+		}
+
+		frameSize += tud_cdc_read(frame + frameSize, needed - frameSize);
+		if (frameSize == needed && needed > SERIAL_CONFIG_HEADER_SIZE) {
+			handleFrame();
+			frameSize = 0;
+		}
+	}
+
+	if (frameSize != 0 && (getMillis() - frameStart) >= SERIAL_CONFIG_TIMEOUT_MS) {
+		badFrames++;
+		frameSize = 0;
+	}
+}
+
+void SerialConfig::handleFrame() {
+	uint8_t command = frame[1];
+	uint8_t sequence = frame[2];
+	uint16_t size = readU16(frame + 3);
+	const uint8_t *payload = frame + SERIAL_CONFIG_HEADER_SIZE;
+
+	if (CRC32::calculate(frame + 1, SERIAL_CONFIG_HEADER_SIZE - 1 + size) != readU32(payload + size)) {
+		badFrames++;
+		reply(command, sequence, SERIAL_STATUS_BAD_CRC);
+		return;
+	}
+
+	switch (command) {
+		case SERIAL_CMD_PING: {
+			uint16_t length = 0;
+			response[length++] = SERIAL_CONFIG_VERSION;
+			writeU16(response + length, SERIAL_CONFIG_MAX_PAYLOAD);
+			length += 2;
+			for (uint8_t block = 0; block < SERIAL_BLOCK_COUNT; block++, length += 2)
+				writeU16(response + length, blockSizes[block]);
+			memcpy(response + length, GP2040VERSION, strlen(GP2040VERSION));
+			length += strlen(GP2040VERSION);
+			reply(command, sequence, SERIAL_STATUS_OK, response, length);
+			break;
+		}
+
+		case SERIAL_CMD_GET: {
+			uint16_t length = 0;
+			for (uint16_t i = 0; i < size; i++) {
+				uint8_t block = payload[i];
+				if (block >= SERIAL_BLOCK_COUNT) {
+					reply(command, sequence, SERIAL_STATUS_BAD_BLOCK);
+					return;
+				}
+				if (length + SERIAL_RECORD_HEADER_SIZE + blockSizes[block] >= SERIAL_CONFIG_MAX_PAYLOAD) {
+					reply(command, sequence, SERIAL_STATUS_BAD_SIZE);
+					return;
+				}
+
+				response[length] = block;
+				writeU16(response + length + 1, blockSizes[block]);
+				length += SERIAL_RECORD_HEADER_SIZE;
+				length += getBlock(block, response + length);
+			}
+			reply(command, sequence, SERIAL_STATUS_OK, response, length);
+			break;
+		}
+
+		case SERIAL_CMD_SET: {
+			SerialStatus status = checkBlocks(payload, size);
+			if (status == SERIAL_STATUS_OK) {
+				for (uint16_t i = 0; i < size; i += SERIAL_RECORD_HEADER_SIZE + blockSizes[payload[i]])
+					setBlock(payload[i], payload + i + SERIAL_RECORD_HEADER_SIZE);
+			}
+			reply(command, sequence, status);
+			break;
+		}
+
+		case SERIAL_CMD_TELEMETRY: {
+			SerialTelemetry telemetry = getTelemetry();
+			reply(command, sequence, SERIAL_STATUS_OK, (const uint8_t *)&telemetry, sizeof(telemetry));
+			break;
+		}
+
+		case SERIAL_CMD_STREAM:
+			if (size != 2) {
+				reply(command, sequence, SERIAL_STATUS_BAD_SIZE);
+				break;
+			}
+			streamInterval = readU16(payload);
+			nextStream = getMillis();
+			reply(command, sequence, SERIAL_STATUS_OK);
+			break;
+
+		case SERIAL_CMD_REBOOT:
+			reply(command, sequence, SERIAL_STATUS_OK);
+			watchdog_reboot(0, SRAM_END, SERIAL_CONFIG_TIMEOUT_MS); // Leaves time for the reply to go out
+			break;
+
+		default:
+			reply(command, sequence, SERIAL_STATUS_BAD_COMMAND);
+			break;
+	}
+}
+
+void SerialConfig::reply(uint8_t command, uint8_t sequence, SerialStatus status, const uint8_t *payload, uint16_t size) {
+	uint8_t header[SERIAL_CONFIG_HEADER_SIZE + 1] =
+	{
+		SERIAL_CONFIG_SYNC,
+		(uint8_t)(command | SERIAL_CMD_REPLY),
+		sequence,
+		(uint8_t)((size + 1) & 0xFF),
+		(uint8_t)((size + 1) >> 8),
+		(uint8_t)status,
+	};
+
+	CRC32 crc;
+	crc.update(header + 1, sizeof(header) - 1);
+	if (size > 0)
+		crc.update(payload, size);
+
+	uint32_t checksum = crc.finalize();
+	uint8_t trailer[4] = { (uint8_t)checksum, (uint8_t)(checksum >> 8), (uint8_t)(checksum >> 16), (uint8_t)(checksum >> 24) };
+
+	write(header, sizeof(header));
+	write(payload, size);
+	write(trailer, sizeof(trailer));
+	tud_cdc_write_flush();
+}
+
+// The TX FIFO is smaller than a full reply, keep USB running until it all fits
+void SerialConfig::write(const uint8_t *data, uint16_t size) {
+	while (size > 0) {
+		uint32_t written = tud_cdc_write(data, size);
+		data += written;
+		size -= written;
+		if (size > 0) {
+			tud_task();
+			if (!tud_cdc_connected())
+				return;
+		}
+	}
+}
+
+uint16_t SerialConfig::getBlock(uint8_t block, uint8_t *data) {
+	switch (block) {
+		case SERIAL_BLOCK_GAMEPAD: {
+			GamepadOptions options = Storage::getInstance().GetGamepad()->options;
+			memcpy(data, &options, sizeof(options));
+			break;
+		}
+
+		case SERIAL_BLOCK_BOARD: {
+			BoardOptions options = Storage::getInstance().getBoardOptions();
+			memcpy(data, &options, sizeof(options));
+			break;
+		}
+
+		case SERIAL_BLOCK_LED: {
+			LEDOptions options = Storage::getInstance().getLEDOptions();
+			memcpy(data, &options, sizeof(options));
+			break;
+		}
+
+		case SERIAL_BLOCK_ANIMATION: {
+			AnimationOptions options = AnimationStore.getAnimationOptions();
+			memcpy(data, &options, sizeof(options));
+			break;
+		}
+
+		default:
+			return 0;
+	}
+
+	return blockSizes[block];
+}
+
+static inline bool inRange(int value, int min, int max) { return value >= min && value <= max; }
+
+// Unused pins are -1, or 0xFF where the web config stores them
+static inline bool validPin(int pin) { return pin == -1 || pin == 0xFF || inRange(pin, 0, NUM_BANK0_GPIOS - 1); }
+
+// Raw blocks skip the clamping the web config and display menu do, so the values are checked here
+static bool checkBlockValues(uint8_t block, const uint8_t *data) {
+	switch (block) {
+		case SERIAL_BLOCK_GAMEPAD: {
+			GamepadOptions options;
+			memcpy(&options, data, sizeof(options));
+			return inRange(options.inputMode, INPUT_MODE_XINPUT, INPUT_MODE_HID)
+				&& inRange(options.dpadMode, DPAD_MODE_DIGITAL, DPAD_MODE_RIGHT_ANALOG)
+				&& inRange(options.socdMode, SOCD_MODE_UP_PRIORITY, SOCD_MODE_SECOND_INPUT_PRIORITY);
+		}
+
+		case SERIAL_BLOCK_BOARD: {
+			BoardOptions options;
+			memcpy(&options, data, sizeof(options));
+			const uint8_t pins[] = {
+				options.pinDpadUp, options.pinDpadDown, options.pinDpadLeft, options.pinDpadRight,
+				options.pinButtonB1, options.pinButtonB2, options.pinButtonB3, options.pinButtonB4,
+				options.pinButtonL1, options.pinButtonR1, options.pinButtonL2, options.pinButtonR2,
+				options.pinButtonS1, options.pinButtonS2, options.pinButtonL3, options.pinButtonR3,
+				options.pinButtonA1, options.pinButtonA2, options.pinButtonTurbo, options.pinButtonReverse,
+				options.pinSliderLS, options.pinSliderRS, options.pinTurboLED, options.pinReverseLED,
+			};
+			for (uint8_t pin : pins) {
+				if (!validPin(pin))
+					return false;
+			}
+
+			return validPin(options.i2cSDAPin) && validPin(options.i2cSCLPin)
+				&& validPin(options.i2cAnalog1219SDAPin) && validPin(options.i2cAnalog1219SCLPin)
+				&& inRange(options.i2cBlock, 0, 1) && inRange(options.i2cAnalog1219Block, 0, 1)
+				&& inRange(options.buttonLayout, BUTTON_LAYOUT_STICK, BUTTON_LAYOUT_CUSTOMA)
+				&& inRange(options.buttonLayoutRight, BUTTON_LAYOUT_ARCADE, BUTTON_LAYOUT_BLANKB)
+				&& inRange(options.turboShotCount, TURBO_SHOT_MIN, TURBO_SHOT_MAX);
+		}
+
+		case SERIAL_BLOCK_LED: {
+			LEDOptions options;
+			memcpy(&options, data, sizeof(options));
+			if (!validPin(options.dataPin) || !inRange(options.ledFormat, LED_FORMAT_GRB, LED_FORMAT_RGBW)
+				|| !inRange(options.ledLayout, BUTTON_LAYOUT_STICK, BUTTON_LAYOUT_CUSTOMA)
+				|| options.chainCount > LED_MAX_CHAINS)
+				return false;
+
+			uint32_t ledTotal = 0;
+			for (int i = 0; i < options.chainCount; i++) {
+				if (!validPin(options.chains[i].dataPin) || !inRange(options.chains[i].ledFormat, LED_FORMAT_GRB, LED_FORMAT_RGBW))
+					return false;
+
+				ledTotal += options.chains[i].ledCount;
+			}
+
+			return ledTotal <= LED_MAX_CHAIN_LEDS;
+		}
+
+		case SERIAL_BLOCK_ANIMATION: {
+			AnimationOptions options;
+			memcpy(&options, data, sizeof(options));
+			return options.baseAnimationIndex < TOTAL_EFFECTS && options.pressEffectIndex < TOTAL_PRESS_EFFECTS;
+		}
+	}
+
+	return false;
+}
+
+// A batch is all or nothing, so every record is checked before the first one is stored
+SerialStatus SerialConfig::checkBlocks(const uint8_t *records, uint16_t size) {
+	uint16_t i = 0;
+	while (i < size) {
+		if ((size - i) < SERIAL_RECORD_HEADER_SIZE)
+			return SERIAL_STATUS_BAD_SIZE;
+
+		uint8_t block = records[i];
+		if (block >= SERIAL_BLOCK_COUNT)
+			return SERIAL_STATUS_BAD_BLOCK;
+
+		uint16_t length = readU16(records + i + 1);
+		if (length != blockSizes[block] || (size - i - SERIAL_RECORD_HEADER_SIZE) < length)
+			return SERIAL_STATUS_BAD_SIZE;
+
+		if (!checkBlockValues(block, records + i + SERIAL_RECORD_HEADER_SIZE))
+			return SERIAL_STATUS_BAD_BLOCK;
+
+		i += SERIAL_RECORD_HEADER_SIZE + length;
+	}
+
+	return SERIAL_STATUS_OK;
+}
+
+// Stores go through the same path as the web config, checksums are recalculated there
+void SerialConfig::setBlock(uint8_t block, const uint8_t *data) {
+	switch (block) {
+		case SERIAL_BLOCK_GAMEPAD: {
+			Gamepad * gamepad = Storage::getInstance().GetGamepad();
+			memcpy(&gamepad->options, data, sizeof(GamepadOptions));
+			ConfigManager::getInstance().setGamepadOptions(gamepad);
+			break;
+		}
+
+		case SERIAL_BLOCK_BOARD: {
+			BoardOptions options;
+			memcpy(&options, data, sizeof(options));
+			ConfigManager::getInstance().setBoardOptions(options);
+			break;
+		}
+
+		case SERIAL_BLOCK_LED: {
+			LEDOptions options;
+			memcpy(&options, data, sizeof(options));
+			ConfigManager::getInstance().setLedOptions(options);
+			break;
+		}
+
+		case SERIAL_BLOCK_ANIMATION: {
+			AnimationOptions options;
+			memcpy(&options, data, sizeof(options));
+			ConfigManager::getInstance().setAnimationOptions(options);
+			break;
+		}
+	}
+}
+
+SerialTelemetry SerialConfig::getTelemetry() {
+	Gamepad * gamepad = Storage::getInstance().GetGamepad();
+	gamepad->read();
+
+	FlashPROMStats flashStats = FlashPROM::getStats();
+
+	SerialTelemetry telemetry = { };
+	telemetry.uptime = getMillis();
+	telemetry.dpad = gamepad->state.dpad;
+	telemetry.buttons = gamepad->state.buttons;
+	telemetry.aux = gamepad->state.aux;
+	telemetry.pollRate = pollRate;
+	telemetry.badFrames = badFrames;
+	telemetry.flashCommits = flashStats.commits;
+	telemetry.flashStall = flashStats.maxStall;
+	return telemetry;
+}
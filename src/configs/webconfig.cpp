@@ -3,6 +3,7 @@
 #include "storagemanager.h"
 #include "configmanager.h"
 
+#include <algorithm>
 #include <cstring>
 #include <string>
 #include <vector>
@@ -27,6 +28,10 @@
 #define API_SET_GAMEPAD_OPTIONS "/api/setGamepadOptions"
 #define API_GET_LED_OPTIONS "/api/getLedOptions"
 #define API_SET_LED_OPTIONS "/api/setLedOptions"
+#define API_GET_LED_PROGRAM "/api/getLedProgram"
+#define API_SET_LED_PROGRAM "/api/setLedProgram"
+#define API_GET_DISPLAY_LAYOUT "/api/getDisplayLayout"
+#define API_SET_DISPLAY_LAYOUT "/api/setDisplayLayout"
 #define API_GET_PIN_MAPPINGS "/api/getPinMappings"
 #define API_SET_PIN_MAPPINGS "/api/setPinMappings"
 #define API_GET_ADDON_OPTIONS "/api/getAddonsOptions"
@@ -167,6 +172,8 @@ std::string setDisplayOptions()
 	boardOptions.i2cSpeed          = doc["i2cSpeed"];
 	boardOptions.displayFlip       = doc["flipDisplay"];
 	boardOptions.displayInvert     = doc["invertDisplay"];
+	boardOptions.buttonLayout      = doc["buttonLayout"];
+	boardOptions.buttonLayoutRight = doc["buttonLayoutRight"];
 	ConfigManager::getInstance().setBoardOptions(boardOptions);
 	return serialize_json(doc);
 }
@@ -183,6 +190,8 @@ std::string getDisplayOptions() // Manually set Document Attributes for the disp
 	doc["i2cSpeed"]      = boardOptions.i2cSpeed;
 	doc["flipDisplay"]   = boardOptions.displayFlip ? 1 : 0;
 	doc["invertDisplay"] = boardOptions.displayInvert ? 1 : 0;
+	doc["buttonLayout"]  = boardOptions.buttonLayout;
+	doc["buttonLayoutRight"] = boardOptions.buttonLayoutRight;
 
 	Gamepad * gamepad = Storage::getInstance().GetGamepad();
 	auto usedPins = doc.createNestedArray("usedPins");
@@ -240,6 +249,8 @@ std::string setLedOptions()
 	ledOptions.ledsPerButton      = doc["ledsPerButton"];
 	ledOptions.brightnessMaximum  = doc["brightnessMaximum"];
 	ledOptions.brightnessSteps    = doc["brightnessSteps"];
+	int frameRate                 = doc["frameRate"] | 0; // 0 uses the board default
+	ledOptions.frameRate          = (frameRate < 0 || frameRate > 255) ? 0 : frameRate;
 	ledOptions.indexUp            = (doc["ledButtonMap"]["Up"]    == nullptr) ? -1 : doc["ledButtonMap"]["Up"];
 	ledOptions.indexDown          = (doc["ledButtonMap"]["Down"]  == nullptr) ? -1 : doc["ledButtonMap"]["Down"];
 	ledOptions.indexLeft          = (doc["ledButtonMap"]["Left"]  == nullptr) ? -1 : doc["ledButtonMap"]["Left"];
@@ -258,6 +269,23 @@ std::string setLedOptions()
 	ledOptions.indexR3            = (doc["ledButtonMap"]["R3"]    == nullptr) ? -1 : doc["ledButtonMap"]["R3"];
 	ledOptions.indexA1            = (doc["ledButtonMap"]["A1"]    == nullptr) ? -1 : doc["ledButtonMap"]["A1"];
 	ledOptions.indexA2            = (doc["ledButtonMap"]["A2"]    == nullptr) ? -1 : doc["ledButtonMap"]["A2"];
+	if (doc.containsKey("chains"))
+	{
+		JsonArray chains = doc["chains"];
+		ledOptions.chainCount = 0;
+		for (JsonObject chain : chains)
+		{
+			if (ledOptions.chainCount == LED_MAX_CHAINS)
+				break;
+
+			ledOptions.chains[ledOptions.chainCount].dataPin   = chain["dataPin"] | -1;
+			ledOptions.chains[ledOptions.chainCount].ledFormat = (LEDFormat)(chain["ledFormat"] | (int)ledOptions.ledFormat);
+			int ledCount = chain["ledCount"] | 0;
+			ledOptions.chains[ledOptions.chainCount].ledCount  = (ledCount < 0) ? 0 : std::min(ledCount, LED_MAX_CHAIN_LEDS);
+			ledOptions.chainCount++;
+		}
+	}
+	clampLEDOptions(ledOptions);
 	ConfigManager::getInstance().setLedOptions(ledOptions);
 	return serialize_json(doc);
 }
@@ -272,6 +300,7 @@ std::string getLedOptions()
 	doc["ledsPerButton"]     = ledOptions.ledsPerButton;
 	doc["brightnessMaximum"] = ledOptions.brightnessMaximum;
 	doc["brightnessSteps"]   = ledOptions.brightnessSteps;
+	doc["frameRate"]         = ledOptions.frameRate;
 
 	auto ledButtonMap = doc.createNestedObject("ledButtonMap");
 	if (ledOptions.indexUp == -1)    ledButtonMap["Up"]    = nullptr;  else ledButtonMap["Up"]    = ledOptions.indexUp;
@@ -293,6 +322,15 @@ std::string getLedOptions()
 	if (ledOptions.indexA1 == -1)    ledButtonMap["A1"]    = nullptr;  else ledButtonMap["A1"]    = ledOptions.indexA1;
 	if (ledOptions.indexA2 == -1)    ledButtonMap["A2"]    = nullptr;  else ledButtonMap["A2"]    = ledOptions.indexA2;
 
+	auto chains = doc.createNestedArray("chains");
+	for (int i = 0; i < ledOptions.chainCount && i < LED_MAX_CHAINS; i++)
+	{
+		auto chain = chains.createNestedObject();
+		chain["dataPin"]   = ledOptions.chains[i].dataPin;
+		chain["ledFormat"] = ledOptions.chains[i].ledFormat;
+		chain["ledCount"]  = ledOptions.chains[i].ledCount;
+	}
+
 	Gamepad * gamepad = Storage::getInstance().GetGamepad();
 	auto usedPins = doc.createNestedArray("usedPins");
 	usedPins.add(gamepad->mapDpadUp->pin);
@@ -452,6 +490,163 @@ std::string getAddonOptions()
 	return serialize_json(doc);
 }
 
+static int hex_value(char c)
+{
+	if (c >= '0' && c <= '9') return c - '0';
+	if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+	if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+	return -1;
+}
+
+static bool hex_decode(const string &hex, uint8_t *data)
+{
+	for (size_t i = 0; i < hex.size() / 2; i++)
+	{
+		int high = hex_value(hex[i * 2]);
+		int low = hex_value(hex[(i * 2) + 1]);
+		if (high < 0 || low < 0)
+			return false;
+		data[i] = (high << 4) | low;
+	}
+	return true;
+}
+
+static string hex_encode(const uint8_t *data, size_t size)
+{
+	static const char digits[] = "0123456789abcdef";
+	string hex;
+	hex.reserve(size * 2);
+	for (size_t i = 0; i < size; i++)
+	{
+		hex += digits[data[i] >> 4];
+		hex += digits[data[i] & 0x0F];
+	}
+	return hex;
+}
+
+// Programs are uploaded as a hex string, only bytecode that validates is stored
+std::string setLedProgram()
+{
+	DynamicJsonDocument doc = get_post_data();
+	string hex = doc["program"] | "";
+
+	DynamicJsonDocument response(LWIP_HTTPD_POST_MAX_PAYLOAD_LEN);
+	uint8_t code[LED_PROGRAM_MAX_SIZE];
+	uint16_t size = hex.size() / 2;
+	if ((hex.size() % 2) != 0 || size > LED_PROGRAM_MAX_SIZE)
+	{
+		response["success"] = false;
+		response["error"] = ((hex.size() % 2) != 0) ? "invalid hex" : LEDProgram::ErrorName(LED_PROGRAM_TOO_LARGE);
+		return serialize_json(response);
+	}
+
+	if (!hex_decode(hex, code))
+	{
+		response["success"] = false;
+		response["error"] = "invalid hex";
+		return serialize_json(response);
+	}
+
+	// An empty program clears the stored one
+	LEDProgramError error = (size > 0) ? LEDProgram::Validate(code, size) : LED_PROGRAM_OK;
+	if (error == LED_PROGRAM_OK)
+		ConfigManager::getInstance().setLedProgram(code, size);
+
+	response["success"] = (error == LED_PROGRAM_OK);
+	response["error"] = LEDProgram::ErrorName(error);
+	return serialize_json(response);
+}
+
+std::string getLedProgram()
+{
+	uint8_t code[LED_PROGRAM_MAX_SIZE];
+	uint16_t size = Storage::getInstance().getLEDProgram(code);
+
+	DynamicJsonDocument doc(LWIP_HTTPD_POST_MAX_PAYLOAD_LEN);
+	doc["program"] = hex_encode(code, size);
+	doc["size"] = size;
+	doc["maxSize"] = LED_PROGRAM_MAX_SIZE;
+	return serialize_json(doc);
+}
+
+#define DISPLAY_LAYOUT_ELEMENT_SIZE 9 // shape, x, y, width, height, then the mask big endian
+
+// Layouts travel as a hex string like LED programs, 32 nested JSON arrays don't fit the POST document
+std::string setDisplayLayout()
+{
+	DynamicJsonDocument doc = get_post_data();
+	string hex = doc["layout"] | "";
+
+	DynamicJsonDocument response(LWIP_HTTPD_POST_MAX_PAYLOAD_LEN);
+	uint8_t data[DISPLAY_LAYOUT_MAX_ELEMENTS * DISPLAY_LAYOUT_ELEMENT_SIZE];
+	size_t size = hex.size() / 2;
+	if (size > sizeof(data))
+	{
+		response["success"] = false;
+		response["error"] = "too many elements";
+		return serialize_json(response);
+	}
+
+	if ((hex.size() % 2) != 0 || (size % DISPLAY_LAYOUT_ELEMENT_SIZE) != 0 || !hex_decode(hex, data))
+	{
+		response["success"] = false;
+		response["error"] = "invalid hex";
+		return serialize_json(response);
+	}
+
+	LayoutElement elements[DISPLAY_LAYOUT_MAX_ELEMENTS];
+	uint8_t count = size / DISPLAY_LAYOUT_ELEMENT_SIZE;
+	for (uint8_t i = 0; i < count; i++)
+	{
+		const uint8_t *src = &data[i * DISPLAY_LAYOUT_ELEMENT_SIZE];
+		elements[i].shape  = src[0];
+		elements[i].x      = src[1];
+		elements[i].y      = src[2];
+		elements[i].width  = src[3];
+		elements[i].height = src[4];
+		elements[i].mask   = (src[5] << 24) | (src[6] << 16) | (src[7] << 8) | src[8];
+		if (!isValidLayoutElement(elements[i]))
+		{
+			response["success"] = false;
+			response["error"] = "invalid element";
+			response["element"] = i;
+			return serialize_json(response);
+		}
+	}
+
+	// An empty layout clears the stored one
+	ConfigManager::getInstance().setDisplayLayout(elements, count);
+	response["success"] = true;
+	return serialize_json(response);
+}
+
+std::string getDisplayLayout()
+{
+	LayoutElement elements[DISPLAY_LAYOUT_MAX_ELEMENTS];
+	uint8_t count = Storage::getInstance().getDisplayLayout(elements);
+
+	uint8_t data[DISPLAY_LAYOUT_MAX_ELEMENTS * DISPLAY_LAYOUT_ELEMENT_SIZE];
+	for (uint8_t i = 0; i < count; i++)
+	{
+		uint8_t *dst = &data[i * DISPLAY_LAYOUT_ELEMENT_SIZE];
+		dst[0] = elements[i].shape;
+		dst[1] = elements[i].x;
+		dst[2] = elements[i].y;
+		dst[3] = elements[i].width;
+		dst[4] = elements[i].height;
+		dst[5] = elements[i].mask >> 24;
+		dst[6] = elements[i].mask >> 16;
+		dst[7] = elements[i].mask >> 8;
+		dst[8] = elements[i].mask;
+	}
+
+	DynamicJsonDocument doc(LWIP_HTTPD_POST_MAX_PAYLOAD_LEN);
+	doc["layout"] = hex_encode(data, count * DISPLAY_LAYOUT_ELEMENT_SIZE);
+	doc["count"] = count;
+	doc["maxElements"] = DISPLAY_LAYOUT_MAX_ELEMENTS;
+	return serialize_json(doc);
+}
+
 // This should be a storage feature
 std::string resetSettings()
 {
@@ -471,6 +666,10 @@ int fs_open_custom(struct fs_file *file, const char *name)
 			return set_file_data(file, setGamepadOptions());
 		if (!memcmp(http_post_uri, API_SET_LED_OPTIONS, sizeof(API_SET_LED_OPTIONS)))
 			return set_file_data(file, setLedOptions());
+		if (!memcmp(http_post_uri, API_SET_LED_PROGRAM, sizeof(API_SET_LED_PROGRAM)))
+			return set_file_data(file, setLedProgram());
+		if (!memcmp(http_post_uri, API_SET_DISPLAY_LAYOUT, sizeof(API_SET_DISPLAY_LAYOUT)))
+			return set_file_data(file, setDisplayLayout());
 		if (!memcmp(http_post_uri, API_SET_PIN_MAPPINGS, sizeof(API_SET_PIN_MAPPINGS)))
 			return set_file_data(file, setPinMappings());
 		if (!memcmp(http_post_uri, API_SET_ADDON_OPTIONS, sizeof(API_SET_ADDON_OPTIONS)))
@@ -484,6 +683,10 @@ int fs_open_custom(struct fs_file *file, const char *name)
 			return set_file_data(file, getGamepadOptions());
 		if (!memcmp(name, API_GET_LED_OPTIONS, sizeof(API_GET_LED_OPTIONS)))
 			return set_file_data(file, getLedOptions());
+		if (!memcmp(name, API_GET_LED_PROGRAM, sizeof(API_GET_LED_PROGRAM)))
+			return set_file_data(file, getLedProgram());
+		if (!memcmp(name, API_GET_DISPLAY_LAYOUT, sizeof(API_GET_DISPLAY_LAYOUT)))
+			return set_file_data(file, getDisplayLayout());
 		if (!memcmp(name, API_GET_PIN_MAPPINGS, sizeof(API_GET_PIN_MAPPINGS)))
 			return set_file_data(file, getPinMappings());
 		if (!memcmp(name, API_GET_ADDON_OPTIONS, sizeof(API_GET_ADDON_OPTIONS)))
@@ -19,6 +19,16 @@ uint64_t getMicro() {
 	return to_us_since_boot(get_absolute_time());
 }
 
+ReportPacker getReportPacker(InputMode mode)
+{
+	switch (mode)
+	{
+		case INPUT_MODE_HID:    return packReport<INPUT_MODE_HID>;
+		case INPUT_MODE_SWITCH: return packReport<INPUT_MODE_SWITCH>;
+		default:                return packReport<INPUT_MODE_XINPUT>;
+	}
+}
+
 void Gamepad::setup()
 {
 	load(); // MPGS loads
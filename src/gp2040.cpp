@@ -5,12 +5,16 @@
 #include "configmanager.h" // Global Managers
 #include "storagemanager.h"
 #include "addonmanager.h"
+#include "messagebus.h"
 
 #include "addons/analog.h" // Inputs for Core0
 #include "addons/i2canalog1219.h"
 #include "addons/jslider.h"
 #include "addons/reverse.h"
 #include "addons/turbo.h"
+#include "addons/neopicoleds.h" // LED hotkeys are detected on Core0
+#include "addons/playerleds.h"  // Host OUT reports are decoded on Core0
+#include "addons/i2cdisplay.h"  // Performance page hotkey
 
 // Pico includes
 #include "pico/bootrom.h"
@@ -21,9 +25,15 @@
 
 #define GAMEPAD_DEBOUNCE_MILLIS 5 // make this a class object
 
+// Core1 asks core0 to commit since only core0 may lock out the other core
+static void handleFlashCommit(const Message &message, void *context) {
+	EEPROM.commit();
+}
+
 GP2040::GP2040() : nextRuntime(0) {
 	Storage::getInstance().SetGamepad(new Gamepad(GAMEPAD_DEBOUNCE_MILLIS));
 	Storage::getInstance().SetProcessedGamepad(new Gamepad(GAMEPAD_DEBOUNCE_MILLIS));
+	MessageBus::getInstance().subscribe(MESSAGE_FLASH_COMMIT, handleFlashCommit);
 }
 
 GP2040::~GP2040() {
@@ -44,7 +54,12 @@ void GP2040::setup() {
 		inputMode = INPUT_MODE_CONFIG; // force config
         initialize_driver(inputMode);
 		ConfigManager::getInstance().setup(CONFIG_TYPE_WEB);
-	} else { 											// Gamepad Mode
+	} else if (gamepad->pressedS1()) { 					// SELECT - Serial Config Mode
+		Storage::getInstance().SetConfigMode(true);
+		inputMode = INPUT_MODE_CONFIG;
+		initialize_driver(inputMode, USB_MODE_SERIAL);
+		ConfigManager::getInstance().setup(CONFIG_TYPE_SERIAL);
+	} else {											// Gamepad Mode
 		Storage::getInstance().SetConfigMode(false);
 		if (gamepad->pressedB3())                       // HOLD B3 - D-INPUT
 			inputMode = INPUT_MODE_HID;
@@ -57,21 +72,37 @@ void GP2040::setup() {
 			gamepad->save();
 		}
 		initialize_driver(inputMode);
+
+		// The display menu edits options while the gamepad keeps running
+		if (Storage::getInstance().getBoardOptions().hasI2CDisplay) {
+			ConfigManager::getInstance().setup(CONFIG_TYPE_DISPLAY);
+			displayPending = true;
+		}
 	}
 
+	packReport = getReportPacker(inputMode);
+
+	// Core1 only receives state through the message bus, give it the options once up front
+	Storage::getInstance().GetProcessedGamepad()->options = gamepad->options;
+
 	// Setup Add-ons
 	addons.LoadAddon(new AnalogInput(), CORE0_INPUT);
 	addons.LoadAddon(new I2CAnalog1219Input(), CORE0_INPUT);
 	addons.LoadAddon(new JSliderInput(), CORE0_INPUT);
 	addons.LoadAddon(new ReverseInput(), CORE0_INPUT);
 	addons.LoadAddon(new TurboInput(), CORE0_INPUT);
+
+	// LED hotkeys are only claimed when there are LEDs to control
+	ledHotkeys = hasLEDChains(Storage::getInstance().getLEDOptions());
 }
 
 void GP2040::run() {
 	Gamepad * gamepad = Storage::getInstance().GetGamepad();
-	Gamepad * processedGamepad = Storage::getInstance().GetProcessedGamepad();
+	MessageBus & messageBus = MessageBus::getInstance();
 	bool configMode = Storage::getInstance().GetConfigMode();
 	while (1) { // LOOP
+		messageBus.dispatch(); // Handle requests from Core1
+
 		// Config Loop (Web-Config does not require gamepad)
 		if (configMode == true ) {
 			ConfigManager::getInstance().loop();
@@ -84,24 +115,159 @@ void GP2040::run() {
 		}
 
 		// Gamepad Features
+		uint32_t readTime = (uint32_t)getMicro();
 		gamepad->read(); 	// gpio pin reads
 	#if GAMEPAD_DEBOUNCE_MILLIS > 0
 		gamepad->debounce();
 	#endif
+		// Core1 loads the display after this loop starts, and may not load it at all (no pins, no free DMA)
+		if (displayPending && messageBus.hasSubscriber(1, MESSAGE_PERF_HUD)) {
+			displayPending = false;
+			displayMenu = true;
+			hudHotkey = true;
+		}
+		if (displayMenu)
+			ConfigManager::getInstance().loop(); // an open menu takes the inputs before any hotkey sees them
 		gamepad->hotkey(); 	// check for MPGS hotkeys
+		if (ledHotkeys)
+			processLEDHotkeys(gamepad); // check for LED hotkeys, removes the combo before it is reported
+		if (hudHotkey)
+			processHUDHotkey(gamepad);
 		gamepad->process(); // process through MPGS
 
 		addons.ProcessAddons(ADDON_PROCESS::CORE0_INPUT);
 
-		// Copy Processed Gamepad for Core1 (race condition otherwise)
-		memcpy(&processedGamepad->state, &gamepad->state, sizeof(GamepadState));
+		// Publish Processed Gamepad for Core1
+		messageBus.publishInput(gamepad->state);
 
 		// USB FEATURES : Send/Get USB Features (including Player LEDs on X-Input)
-		send_report(gamepad->getReport(), gamepad->getReportSize());
-		Storage::getInstance().ClearFeatureData();
-		receive_report(Storage::getInstance().GetFeatureData());
+		ReportResult result = send_report(packReport(gamepad));
+		processOutReports();
 		tud_task(); // TinyUSB Task update
 
+		updateStats(result, readTime);
+
 		nextRuntime = getMicro() + GAMEPAD_POLL_MICRO;
 	}
 }
+
+void GP2040::processLEDHotkeys(Gamepad * gamepad) {
+	AnimationHotkey action = animationHotkeys(gamepad);
+	if (action == HOTKEY_LEDS_NONE) {
+		lastHotkey = HOTKEY_LEDS_NONE;
+		return;
+	}
+
+	// Send new presses right away, then repeat while the combo is held
+	uint32_t now = getMillis();
+	if (action == lastHotkey && now < nextHotkeyRepeat)
+		return;
+
+	Message message = { };
+	message.type = MESSAGE_HOTKEY;
+	message.hotkey = action;
+	if (MessageBus::getInstance().post(1, message)) {
+		lastHotkey = action;
+		nextHotkeyRepeat = now + LED_HOTKEY_REPEAT_MS;
+	}
+}
+
+// F1 + PERF_HUD_HOTKEY flips the display between the buttons and the performance page
+void GP2040::processHUDHotkey(Gamepad * gamepad) {
+	bool held = gamepad->pressedF1() && (gamepad->state.buttons & PERF_HUD_HOTKEY);
+	if (held)
+		gamepad->state.buttons &= ~(PERF_HUD_HOTKEY | gamepad->f1Mask);
+
+	if (held && !hudHotkeyHeld)
+		MessageBus::getInstance().post(1, MESSAGE_PERF_HUD);
+
+	hudHotkeyHeld = held;
+}
+
+// Only counters are touched per poll, rates and the percentile are worked out once per window
+void GP2040::updateStats(ReportResult result, uint32_t readTime) {
+	uint32_t now = (uint32_t)getMicro();
+	windowLoops++;
+
+	// Latency runs from the read that first saw a change to the report holding it being accepted
+	if (result == REPORT_SENT) {
+		latency.record(now - (changePending ? changeTime : readTime));
+		changePending = false;
+	} else if (result == REPORT_BUSY && !changePending) {
+		changeTime = readTime;
+		changePending = true;
+	} else if (result == REPORT_UNCHANGED) {
+		changePending = false;
+	}
+
+	uint32_t elapsed = now - windowStart;
+	if (elapsed < PERF_WINDOW_US)
+		return;
+
+	ReportStats reportStats = get_report_stats();
+	FlashPROMStats flashStats = FlashPROM::getStats();
+	stats.loopRate = ((uint64_t)windowLoops * 1000000) / elapsed;
+	stats.reportRate = ((uint64_t)(reportStats.sent - windowReports) * 1000000) / elapsed;
+	stats.dropped = reportStats.dropped;
+	stats.latencyP99 = latency.percentile(99);
+	stats.latencyMax = latency.getMax();
+	stats.flashCommits = flashStats.commits;
+	stats.flashStall = flashStats.maxStall;
+	MessageBus::getInstance().publishStats(stats);
+
+	latency.reset();
+	windowStart = now;
+	windowLoops = 0;
+	windowReports = reportStats.sent;
+}
+
+// Decode each host OUT report once and post it as a typed event
+void GP2040::processOutReports() {
+	MessageBus & messageBus = MessageBus::getInstance();
+	while (true) {
+		// Hold on to an event Core1 had no room for, so host commands are never dropped
+		if (hostEvent.type == MESSAGE_NONE) {
+			uint8_t report[XINPUT_OUT_SIZE];
+			uint32_t timestamp;
+			if (!receive_report(report, &timestamp))
+				return;
+
+			decodeOutReport(report, timestamp);
+			if (hostEvent.type == MESSAGE_NONE)
+				continue;
+		}
+
+		if (!messageBus.post(1, hostEvent))
+			return;
+
+		hostEvent.type = MESSAGE_NONE;
+	}
+}
+
+void GP2040::decodeOutReport(const uint8_t * report, uint32_t timestamp) {
+	hostEvent = { };
+	hostEvent.timestamp = timestamp;
+	switch (report[0]) {
+		case XINPUT_OUT_LED: {
+			PLEDAnimationState animationState = getXInputAnimation(report);
+			if (animationState.animation == PLED_ANIM_NONE)
+				return;
+
+			hostEvent.type = MESSAGE_PLAYER_LEDS;
+			hostEvent.playerLEDs.state = animationState.state;
+			hostEvent.playerLEDs.animation = animationState.animation;
+			hostEvent.playerLEDs.speed = animationState.speed;
+			break;
+		}
+
+		case XINPUT_OUT_RUMBLE:
+			// Nothing drives motors yet, don't let rumble queue up ahead of player LED events
+			if (!MessageBus::getInstance().hasSubscriber(1, MESSAGE_RUMBLE))
+				return;
+
+			hostEvent.type = MESSAGE_RUMBLE;
+			hostEvent.rumble.left = report[3];
+			hostEvent.rumble.right = report[4];
+			break;
+	}
+}
@@ -4,6 +4,7 @@
 
 #include "storagemanager.h" // Global Managers
 #include "addonmanager.h"
+#include "messagebus.h"
 
 #include "addons/i2cdisplay.h" // Add-Ons
 #include "addons/neopicoleds.h"
@@ -21,14 +22,24 @@ void GP2040Aux::setup() {
 	addons.LoadAddon(new I2CDisplayAddon(), CORE1_LOOP);
 	addons.LoadAddon(new NeoPicoLEDAddon(), CORE1_LOOP);
 	addons.LoadAddon(new PlayerLEDAddon(), CORE1_LOOP);
+
+	// The display's performance page shows the LED frame timing
+	I2CDisplayAddon * display = static_cast<I2CDisplayAddon *>(addons.GetAddon(I2CDisplayName));
+	NeoPicoLEDAddon * leds = static_cast<NeoPicoLEDAddon *>(addons.GetAddon(NeoPicoLEDName));
+	if (display != nullptr && leds != nullptr)
+		display->setLEDStats(&leds->getFrameStats());
 }
 
 void GP2040Aux::run() {
+	Gamepad * processedGamepad = Storage::getInstance().GetProcessedGamepad();
+	MessageBus & messageBus = MessageBus::getInstance();
 	while (1) {
 		if (nextRuntime > getMicro()) { // fix for unsigned
 			sleep_us(50); // Give some time back to our CPU (lower power consumption)
 			continue;
 		}
+		messageBus.readInput(processedGamepad->state); // Latest input from Core0
+		messageBus.dispatch();
 		addons.ProcessAddons(CORE1_LOOP);
 		nextRuntime = getMicro() + GAMEPAD_POLL_MICRO;
 	}
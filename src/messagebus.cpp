@@ -0,0 +1,115 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: Copyright (c) 2021 Jason Skuby (mytechtoybox.com)
+ */
+
+#include "messagebus.h"
+
+#include "pico/platform.h"
+
+bool MessageBus::post(uint8_t core, Message &message)
+{
+	if (core >= MESSAGE_CORE_COUNT)
+		return false;
+
+	if (message.timestamp == 0)
+		message.timestamp = (uint32_t)getMicro();
+
+	return inbox[core].push(message);
+}
+
+bool MessageBus::post(uint8_t core, MessageType type)
+{
+	Message message = { };
+	message.type = type;
+	return post(core, message);
+}
+
+bool MessageBus::subscribe(MessageType type, MessageHandler handler, void *context)
+{
+	uint8_t core = get_core_num();
+	if (subscriptionCount[core] >= MESSAGE_MAX_HANDLERS)
+		return false;
+
+	subscriptions[core][subscriptionCount[core]] = { type, handler, context };
+	__dmb(); // Other core may be checking for subscribers already
+	subscriptionCount[core]++;
+	return true;
+}
+
+bool MessageBus::hasSubscriber(uint8_t core, MessageType type)
+{
+	if (core >= MESSAGE_CORE_COUNT)
+		return false;
+
+	uint8_t count = subscriptionCount[core];
+	__dmb();
+	for (uint8_t i = 0; i < count; i++)
+	{
+		if (subscriptions[core][i].type == type)
+			return true;
+	}
+
+	return false;
+}
+
+uint16_t MessageBus::dispatch()
+{
+	uint8_t core = get_core_num();
+	uint16_t count = 0;
+	Message message;
+	while (inbox[core].pop(message))
+	{
+		for (uint8_t i = 0; i < subscriptionCount[core]; i++)
+		{
+			if (subscriptions[core][i].type == message.type)
+				subscriptions[core][i].handler(message, subscriptions[core][i].context);
+		}
+		count++;
+	}
+
+	return count;
+}
+
+void MessageBus::publishInput(GamepadState &state)
+{
+	InputFrame frame;
+	frame.state = state;
+	frame.timestamp = (uint32_t)getMicro();
+	inputFrame.write(frame);
+}
+
+bool MessageBus::readInput(GamepadState &state)
+{
+	InputFrame frame;
+	if (!inputFrame.read(frame))
+		return false;
+
+	state = frame.state;
+	return true;
+}
+
+void MessageBus::publishStats(const Core0Stats &stats)
+{
+	core0Stats.write(stats);
+}
+
+bool MessageBus::readStats(Core0Stats &stats)
+{
+	return core0Stats.read(stats);
+}
+
+void MessageBus::publishMenu(const DisplayMenuState &state)
+{
+	displayMenu.write(state);
+}
+
+bool MessageBus::readMenu(DisplayMenuState &state)
+{
+	return displayMenu.read(state);
+}
+
+MessageQueueStats MessageBus::getStats(uint8_t core)
+{
+	return inbox[core].getStats();
+}
@@ -0,0 +1,84 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: Copyright (c) 2021 Jason Skuby (mytechtoybox.com)
+ */
+
+#include "rlebitmap.h"
+
+bool RLEBitmapDecoder::load()
+{
+	if (src >= end)
+		return false;
+
+	uint8_t control = *src++;
+	uint8_t count = control & RLE_COUNT_MASK;
+	literal = false;
+	switch (control & RLE_CODE_MASK)
+	{
+		case RLE_LITERAL:
+			literal = true;
+			remaining = count + 1;
+			if (remaining > (uint16_t)(end - src)) // Never read past a truncated image
+				remaining = (uint16_t)(end - src);
+			break;
+		case RLE_ZEROS:
+			value = 0x00;
+			remaining = count + 1;
+			break;
+		case RLE_ONES:
+			value = 0xFF;
+			remaining = count + 1;
+			break;
+		default:
+			if (src >= end)
+				return false;
+			value = *src++;
+			remaining = count + 3;
+			break;
+	}
+
+	return remaining > 0;
+}
+
+void drawRLEBitmap(uint8_t *buffer, int bufferWidth, int bufferPages, const RLEBitmap &bitmap, int x, int y, int firstPage, int lastPage)
+{
+	if (bitmap.size == 0)
+		return;
+
+	if (firstPage < 0)
+		firstPage = 0;
+	if (lastPage >= bufferPages)
+		lastPage = bufferPages - 1;
+
+	// A source page straddles two display pages unless y lands on a page boundary
+	int topPage = (y >= 0) ? (y >> 3) : -((7 - y) >> 3);
+	int shift = y - (topPage << 3);
+	int pages = (bitmap.height + 7) >> 3;
+
+	RLEBitmapDecoder decoder(bitmap);
+	for (int p = 0; p < pages; p++)
+	{
+		int page = topPage + p;
+		int lowerPage = (shift != 0) ? page + 1 : page;
+		if (lowerPage < firstPage || page > lastPage)
+		{
+			decoder.skip(bitmap.width);
+			continue;
+		}
+
+		bool drawUpper = (page >= firstPage);
+		bool drawLower = (shift != 0) && (page + 1 <= lastPage);
+		for (int c = 0; c < bitmap.width; c++)
+		{
+			uint8_t bits = decoder.next();
+			int column = x + c;
+			if (bits == 0 || column < 0 || column >= bufferWidth)
+				continue;
+
+			if (drawUpper)
+				buffer[page * bufferWidth + column] |= bits << shift;
+			if (drawLower)
+				buffer[(page + 1) * bufferWidth + column] |= bits >> (8 - shift);
+		}
+	}
+}
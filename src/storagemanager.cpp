@@ -14,6 +14,7 @@
 #include "Animation.hpp"
 #include "CRC32.h"
 #include <sstream>
+#include <stddef.h>
 
 #include "addons/i2cdisplay.h"
 #include "addons/neopicoleds.h"
@@ -22,17 +23,90 @@
 #include "addons/turbo.h"
 
 #include "helper.h"
+#include "messagebus.h"
+
+// Every block has to stay inside its region, EEPROM.set quietly drops writes that run past the end
+static_assert(GAMEPAD_STORAGE_INDEX + sizeof(GamepadOptions) <= BOARD_STORAGE_INDEX, "GamepadOptions overruns its storage");
+static_assert(BOARD_STORAGE_INDEX + sizeof(BoardOptions) <= LED_STORAGE_INDEX, "BoardOptions overruns its storage");
+static_assert(LED_STORAGE_INDEX + sizeof(LEDOptions) <= ANIMATION_STORAGE_INDEX, "LEDOptions overruns its storage");
+static_assert(ANIMATION_STORAGE_INDEX + sizeof(AnimationOptions) <= LED_PROGRAM_STORAGE_INDEX, "AnimationOptions overruns its storage");
+static_assert(LED_PROGRAM_STORAGE_INDEX + sizeof(LEDProgramOptions) <= DISPLAY_LAYOUT_STORAGE_INDEX, "LEDProgramOptions overruns its storage");
+static_assert(DISPLAY_LAYOUT_STORAGE_INDEX + sizeof(DisplayLayoutOptions) <= EEPROM_SIZE_BYTES, "DisplayLayoutOptions overruns the EEPROM");
+
+// Flash commits lock out core1, so core1 hands them over to core0
+static void commitStorage()
+{
+	if (get_core_num() == 0)
+		EEPROM.commit();
+	else
+		MessageBus::getInstance().post(0, MESSAGE_FLASH_COMMIT);
+}
+
+// Reads options stored with an older struct layout, true if its CRC holds up for that layout
+template<typename T>
+static bool getLegacyOptions(uint16_t index, T &legacy)
+{
+	EEPROM.get(index, legacy);
+	uint32_t lastCRC = legacy.checksum;
+	legacy.checksum = CHECKSUM_MAGIC;
+	return lastCRC == CRC32::calculate(&legacy);
+}
+
+// BoardOptions before buttonLayoutRight, everything around it is unchanged
+struct BoardOptionsV0
+{
+	uint8_t head[offsetof(BoardOptions, buttonLayoutRight)];
+	uint8_t tail[offsetof(BoardOptions, checksum) - offsetof(BoardOptions, i2cSDAPin)];
+	uint32_t checksum;
+};
+
+// Earlier LEDOptions layouts, each is the current struct cut off where a field was added before boardVersion
+struct LEDOptionsV0 // before chainCount and chains
+{
+	uint8_t fields[offsetof(LEDOptions, chainCount)];
+	char boardVersion[32];
+	uint32_t checksum;
+};
+
+struct LEDOptionsV1 // before frameRate
+{
+	uint8_t fields[offsetof(LEDOptions, frameRate)];
+	char boardVersion[32];
+	uint32_t checksum;
+};
+
+// AnimationOptions before pressEffectIndex, unlike the others its checksum comes first
+struct __attribute__ ((__packed__)) AnimationOptionsV0
+{
+	uint32_t checksum;
+	uint8_t fields[offsetof(AnimationOptions, pressEffectIndex) - offsetof(AnimationOptions, baseAnimationIndex)];
+};
 
 /* Board stuffs */
 void Storage::initBoardOptions() {
 	EEPROM.get(BOARD_STORAGE_INDEX, boardOptions);
 	uint32_t lastCRC = boardOptions.checksum;
 	boardOptions.checksum = CHECKSUM_MAGIC;
-	if (lastCRC != CRC32::calculate(&boardOptions)) {
+	if (lastCRC != CRC32::calculate(&boardOptions) && !migrateBoardOptions()) {
 		setDefaultBoardOptions();
 	}
 }
 
+// Keeps the settings of an older layout, new fields get their defaults
+bool Storage::migrateBoardOptions()
+{
+	BoardOptionsV0 legacy;
+	if (!getLegacyOptions(BOARD_STORAGE_INDEX, legacy))
+		return false;
+
+	BoardOptions options = { };
+	memcpy(&options, legacy.head, sizeof(legacy.head));
+	options.buttonLayoutRight = BUTTON_LAYOUT_RIGHT;
+	memcpy(&options.i2cSDAPin, legacy.tail, sizeof(legacy.tail));
+	setBoardOptions(options);
+	return true;
+}
+
 BoardOptions Storage::getBoardOptions()
 {
 	return boardOptions;
@@ -65,6 +139,7 @@ void Storage::setDefaultBoardOptions()
 	boardOptions.pinSliderLS       = PIN_SLIDER_LS;
 	boardOptions.pinSliderRS       = PIN_SLIDER_RS;
 	boardOptions.buttonLayout      = BUTTON_LAYOUT;
+	boardOptions.buttonLayoutRight = BUTTON_LAYOUT_RIGHT;
 	boardOptions.i2cSDAPin         = I2C_SDA_PIN;
 	boardOptions.i2cSCLPin         = I2C_SCL_PIN;
 	boardOptions.i2cBlock          = (I2C_BLOCK == i2c0) ? 0 : 1;
@@ -97,7 +172,7 @@ void Storage::setBoardOptions(BoardOptions options)
 		options.checksum = CHECKSUM_MAGIC; // set checksum to magic number
 		options.checksum = CRC32::calculate(&options);
 		EEPROM.set(BOARD_STORAGE_INDEX, options);
-		EEPROM.commit();
+		commitStorage();
 		memcpy(&boardOptions, &options, sizeof(BoardOptions));
 	}
 }
@@ -108,11 +183,76 @@ void Storage::initLEDOptions()
 	EEPROM.get(LED_STORAGE_INDEX, ledOptions);
 	uint32_t lastCRC = ledOptions.checksum;
 	ledOptions.checksum = CHECKSUM_MAGIC;
-	if (lastCRC != CRC32::calculate(&ledOptions)) {
+	if (lastCRC != CRC32::calculate(&ledOptions) && !migrateLEDOptions()) {
 		setDefaultLEDOptions();
 	}
 }
 
+// Keeps the settings of an older layout, new fields get their defaults
+bool Storage::migrateLEDOptions()
+{
+	LEDOptions options = { };
+	LEDOptionsV1 v1;
+	LEDOptionsV0 v0;
+	if (getLegacyOptions(LED_STORAGE_INDEX, v1)) {
+		memcpy(&options, v1.fields, sizeof(v1.fields));
+		memcpy(options.boardVersion, v1.boardVersion, sizeof(options.boardVersion));
+	} else if (getLegacyOptions(LED_STORAGE_INDEX, v0)) {
+		memcpy(&options, v0.fields, sizeof(v0.fields));
+		memcpy(options.boardVersion, v0.boardVersion, sizeof(options.boardVersion));
+		options.chainCount = 0;
+		for (int i = 0; i < LED_MAX_CHAINS; i++)
+			options.chains[i] = { -1, LED_FORMAT, 0 };
+	} else {
+		return false;
+	}
+
+	options.frameRate = LED_FRAME_RATE;
+	setLEDOptions(options);
+	return true;
+}
+
+static inline bool validLEDPin(int pin) { return pin >= -1 && pin < NUM_BANK0_GPIOS; }
+static inline bool validLEDFormat(LEDFormat format) { return (int)format >= LED_FORMAT_GRB && (int)format <= LED_FORMAT_RGBW; }
+
+// Chains past the LED budget are cut short, a chain on a bad pin is turned off
+bool clampLEDOptions(LEDOptions &options)
+{
+	bool changed = false;
+	if (!validLEDPin(options.dataPin)) {
+		options.dataPin = -1;
+		changed = true;
+	}
+	if (!validLEDFormat(options.ledFormat)) {
+		options.ledFormat = LED_FORMAT;
+		changed = true;
+	}
+	if (options.chainCount > LED_MAX_CHAINS) {
+		options.chainCount = LED_MAX_CHAINS;
+		changed = true;
+	}
+
+	uint32_t total = 0;
+	for (int i = 0; i < options.chainCount; i++) {
+		LEDChain &chain = options.chains[i];
+		if (!validLEDPin(chain.dataPin)) {
+			chain.dataPin = -1;
+			changed = true;
+		}
+		if (!validLEDFormat(chain.ledFormat)) {
+			chain.ledFormat = options.ledFormat;
+			changed = true;
+		}
+		if (chain.ledCount > LED_MAX_CHAIN_LEDS - total) {
+			chain.ledCount = LED_MAX_CHAIN_LEDS - total;
+			changed = true;
+		}
+		total += chain.ledCount;
+	}
+
+	return changed;
+}
+
 LEDOptions Storage::getLEDOptions()
 {
 	return ledOptions;
@@ -144,6 +284,10 @@ void Storage::setDefaultLEDOptions()
 	ledOptions.indexR3 = LEDS_BUTTON_R3;
 	ledOptions.indexA1 = LEDS_BUTTON_A1;
 	ledOptions.indexA2 = LEDS_BUTTON_A2;
+	ledOptions.chainCount = 0;
+	for (int i = 0; i < LED_MAX_CHAINS; i++)
+		ledOptions.chains[i] = { -1, LED_FORMAT, 0 };
+	ledOptions.frameRate = LED_FRAME_RATE;
 	setLEDOptions(ledOptions);
 }
 
@@ -154,11 +298,67 @@ void Storage::setLEDOptions(LEDOptions options)
 		options.checksum = CHECKSUM_MAGIC; // set checksum to magic number
 		options.checksum = CRC32::calculate(&options);
 		EEPROM.set(LED_STORAGE_INDEX, options);
-		EEPROM.commit();
+		commitStorage();
 		memcpy(&ledOptions, &options, sizeof(LEDOptions));
 	}
 }
 
+/* LED program stuffs */
+void Storage::setLEDProgram(const uint8_t *code, uint16_t size)
+{
+	LEDProgramOptions program = { };
+	program.size = (size <= LED_PROGRAM_MAX_SIZE) ? size : 0;
+	if (program.size > 0)
+		memcpy(program.code, code, program.size);
+
+	program.checksum = CHECKSUM_MAGIC;
+	program.checksum = CRC32::calculate(&program);
+	EEPROM.set(LED_PROGRAM_STORAGE_INDEX, program);
+	commitStorage();
+}
+
+uint16_t Storage::getLEDProgram(uint8_t *code)
+{
+	LEDProgramOptions program;
+	EEPROM.get(LED_PROGRAM_STORAGE_INDEX, program);
+
+	uint32_t lastCRC = program.checksum;
+	program.checksum = CHECKSUM_MAGIC;
+	if (lastCRC != CRC32::calculate(&program) || program.size > LED_PROGRAM_MAX_SIZE)
+		return 0;
+
+	memcpy(code, program.code, program.size);
+	return program.size;
+}
+
+/* Display layout stuffs */
+void Storage::setDisplayLayout(const LayoutElement *elements, uint8_t count)
+{
+	DisplayLayoutOptions layout = { };
+	layout.count = (count <= DISPLAY_LAYOUT_MAX_ELEMENTS) ? count : 0;
+	if (layout.count > 0)
+		memcpy(layout.elements, elements, layout.count * sizeof(LayoutElement));
+
+	layout.checksum = CHECKSUM_MAGIC;
+	layout.checksum = CRC32::calculate(&layout);
+	EEPROM.set(DISPLAY_LAYOUT_STORAGE_INDEX, layout);
+	commitStorage();
+}
+
+uint8_t Storage::getDisplayLayout(LayoutElement *elements)
+{
+	DisplayLayoutOptions layout;
+	EEPROM.get(DISPLAY_LAYOUT_STORAGE_INDEX, layout);
+
+	uint32_t lastCRC = layout.checksum;
+	layout.checksum = CHECKSUM_MAGIC;
+	if (lastCRC != CRC32::calculate(&layout) || layout.count > DISPLAY_LAYOUT_MAX_ELEMENTS)
+		return 0;
+
+	memcpy(elements, layout.elements, layout.count * sizeof(LayoutElement));
+	return layout.count;
+}
+
 void Storage::ResetSettings()
 {
 	EEPROM.reset();
@@ -194,21 +394,6 @@ Gamepad * Storage::GetProcessedGamepad()
 	return processedGamepad;
 }
 
-void Storage::SetFeatureData(uint8_t * newData)
-{
-	memcpy(newData, featureData, sizeof(uint8_t)*sizeof(featureData));
-}
-
-void Storage::ClearFeatureData()
-{
-	memset(featureData, 0, sizeof(uint8_t)*sizeof(featureData));
-}
-
-uint8_t * Storage::GetFeatureData()
-{
-	return featureData;
-}
-
 /* Animation stuffs */
 AnimationOptions AnimationStorage::getAnimationOptions()
 {
@@ -219,13 +404,23 @@ AnimationOptions AnimationStorage::getAnimationOptions()
 	options.checksum = CHECKSUM_MAGIC;
 	if (CRC32::calculate(&options) != lastCRC)
 	{
-		options.baseAnimationIndex = LEDS_BASE_ANIMATION_INDEX;
-		options.brightness         = LEDS_BRIGHTNESS;
-		options.staticColorIndex   = LEDS_STATIC_COLOR_INDEX;
-		options.buttonColorIndex   = LEDS_BUTTON_COLOR_INDEX;
-		options.chaseCycleTime     = LEDS_CHASE_CYCLE_TIME;
-		options.rainbowCycleTime   = LEDS_RAINBOW_CYCLE_TIME;
-		options.themeIndex         = LEDS_THEME_INDEX;
+		AnimationOptionsV0 legacy;
+		if (getLegacyOptions(ANIMATION_STORAGE_INDEX, legacy))
+		{
+			// Keep what an older layout stored, only the press effect is new
+			memcpy(&options.baseAnimationIndex, legacy.fields, sizeof(legacy.fields));
+		}
+		else
+		{
+			options.baseAnimationIndex = LEDS_BASE_ANIMATION_INDEX;
+			options.brightness         = LEDS_BRIGHTNESS;
+			options.staticColorIndex   = LEDS_STATIC_COLOR_INDEX;
+			options.buttonColorIndex   = LEDS_BUTTON_COLOR_INDEX;
+			options.chaseCycleTime     = LEDS_CHASE_CYCLE_TIME;
+			options.rainbowCycleTime   = LEDS_RAINBOW_CYCLE_TIME;
+			options.themeIndex         = LEDS_THEME_INDEX;
+		}
+		options.pressEffectIndex   = LEDS_PRESS_EFFECT_INDEX;
 
 		setAnimationOptions(options);
 	}
@@ -252,5 +447,5 @@ void AnimationStorage::save()
 	}
 
 	if (dirty)
-		EEPROM.commit();
+		commitStorage();
 }
@@ -0,0 +1,99 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: Copyright (c) 2021 Jason Skuby (mytechtoybox.com)
+ */
+
+// Host benchmark of AnimationStation::ApplyBrightness: the per-pixel float path (RGB::value) against
+// the lookup table packers that replaced it. Both come straight from Animation.hpp, and every frame
+// is checked to pack to the same values before anything is timed.
+//
+//   g++ -O2 -std=gnu++14 -Ilib/AnimationStation/src -Ilib/NeoPico/src tools/bench-brightness.cpp -o bench-brightness
+//   ./bench-brightness [pixels] [frames]
+//
+// The RP2040 has no FPU, so every float multiply there is a software call and the gap is wider
+// than on a desktop CPU.
+
+#include <chrono>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+// Only LEDFormat is needed from NeoPico.hpp, the rest pulls in the Pico SDK
+#define _NEO_PICO_H_
+typedef enum
+{
+	LED_FORMAT_GRB = 0,
+	LED_FORMAT_RGB = 1,
+	LED_FORMAT_GRBW = 2,
+	LED_FORMAT_RGBW = 3,
+} LEDFormat;
+
+#include "Animation.hpp"
+
+static const char * const formatNames[] = { "GRB", "RGB", "GRBW", "RGBW" };
+
+static volatile uint32_t sink;
+
+template<typename F>
+static double timeFrames(int frames, F render)
+{
+	auto start = std::chrono::steady_clock::now();
+	for (int f = 0; f < frames; f++)
+		render();
+	auto end = std::chrono::steady_clock::now();
+	return std::chrono::duration<double, std::nano>(end - start).count() / frames;
+}
+
+int main(int argc, char *argv[])
+{
+	int pixels = (argc > 1) ? atoi(argv[1]) : 100;
+	int frames = (argc > 2) ? atoi(argv[2]) : 20000;
+	volatile float brightness = 0.6F; // Kept out of reach of constant folding, like the runtime setting
+
+	std::vector<RGB> frame(pixels);
+	srand(1);
+	for (RGB &color : frame)
+		color = (rand() % 4 == 0) ? RGB::wheel(rand() % 256) : RGB(rand() % 256, rand() % 256, rand() % 256);
+
+	// Same table AnimationStation::buildBrightnessLUT builds with ANIMATION_GAMMA at 1.0
+	uint8_t lut[256];
+	for (int i = 0; i < 256; i++)
+		lut[i] = (uint8_t)(i * brightness);
+
+	std::vector<uint32_t> floatValues(pixels);
+	std::vector<uint32_t> lutValues(pixels);
+	printf("%d pixels, %d frames\n", pixels, frames);
+	printf("%-6s %12s %12s %8s\n", "format", "float ns", "lut ns", "speedup");
+	for (int f = LED_FORMAT_GRB; f <= LED_FORMAT_RGBW; f++)
+	{
+		LEDFormat format = (LEDFormat)f;
+		PixelPacker packer = getPixelPacker(format);
+
+		auto floatPath = [&]() {
+			float x = brightness;
+			for (int i = 0; i < pixels; i++)
+				floatValues[i] = frame[i].value(format, x);
+			sink = floatValues[pixels - 1];
+		};
+		auto lutPath = [&]() {
+			for (int i = 0; i < pixels; i++)
+				lutValues[i] = packer(frame[i], lut);
+			sink = lutValues[pixels - 1];
+		};
+
+		floatPath();
+		lutPath();
+		if (floatValues != lutValues)
+		{
+			printf("%s: the paths disagree\n", formatNames[f]);
+			return 1;
+		}
+
+		double floatTime = timeFrames(frames, floatPath);
+		double lutTime = timeFrames(frames, lutPath);
+		printf("%-6s %12.0f %12.0f %7.1fx\n", formatNames[f], floatTime, lutTime, floatTime / lutTime);
+	}
+
+	return 0;
+}
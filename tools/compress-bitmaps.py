@@ -0,0 +1,188 @@
+#!/usr/bin/env python3
+#
+# SPDX-License-Identifier: MIT
+# SPDX-FileCopyrightText: Copyright (c) 2021 Jason Skuby (mytechtoybox.com)
+#
+# Compresses the images in include/bitmaps.h into include/bitmaps_rle.h.
+#
+# bitmaps.h stays the file to edit, it holds rows of pixels the way image converters export them.
+# The firmware only includes the generated header: each image is turned into OLED pages (a byte per
+# column holding 8 rows, top row in bit 0) and run-length encoded, so the decoder can write straight
+# into the display's back buffer.
+#
+# Runs before every PlatformIO build (see platformio.ini) and only rewrites the header when bitmaps.h
+# is newer. It can also be run by hand:
+#
+#   compress-bitmaps.py [include/bitmaps.h] [include/bitmaps_rle.h]
+
+import os
+import re
+import sys
+
+# Control byte: top 2 bits pick the code, the low 6 bits are the count
+RLE_LITERAL = 0x00 # count + 1 bytes follow as is
+RLE_ZEROS = 0x40   # count + 1 bytes of 0x00
+RLE_ONES = 0x80    # count + 1 bytes of 0xFF
+RLE_REPEAT = 0xC0  # count + 3 copies of the byte that follows
+RLE_MAX_COUNT = 0x3F
+
+IMAGE_PATTERN = re.compile(r'const\s+unsigned\s+char\s+(\w+)\s*\[\s*\]\s*=\s*\{(.*?)\};', re.S)
+SIZE_PATTERN = re.compile(r'(\d+)\s*x\s*(\d+)\s*px')
+
+
+def parse_images(source):
+	images = []
+	for name, body in IMAGE_PATTERN.findall(source):
+		size = SIZE_PATTERN.search(body)
+		body = re.sub(r'/\*.*?\*/', '', body, flags=re.S)
+		body = re.sub(r'//[^\n]*', '', body)
+		data = [int(value, 0) for value in re.findall(r'0x[0-9a-fA-F]+|\d+', body)]
+		if not data:
+			images.append((name, 0, 0, []))
+			continue
+		if size is None:
+			raise ValueError('{} has no size comment like "// \'name\', 128x64px"'.format(name))
+
+		width, height = int(size.group(1)), int(size.group(2))
+		pitch = (width + 7) // 8
+		if len(data) != pitch * height:
+			raise ValueError('{} is {}x{} but has {} bytes, expected {}'.format(name, width, height, len(data), pitch * height))
+
+		images.append((name, width, height, data))
+
+	return images
+
+
+# Rows of MSB-first pixels to display pages of LSB-top columns
+def to_pages(width, height, data):
+	pitch = (width + 7) // 8
+	pages = []
+	for page in range((height + 7) // 8):
+		for x in range(width):
+			column = 0
+			for bit in range(8):
+				y = page * 8 + bit
+				if y < height and data[y * pitch + x // 8] & (0x80 >> (x % 8)):
+					column |= 1 << bit
+			pages.append(column)
+
+	return pages
+
+
+def compress(data):
+	out = []
+	literal = []
+
+	def flush_literal():
+		while literal:
+			chunk = literal[:RLE_MAX_COUNT + 1]
+			del literal[:len(chunk)]
+			out.append(RLE_LITERAL | (len(chunk) - 1))
+			out.extend(chunk)
+
+	i = 0
+	while i < len(data):
+		value = data[i]
+		run = 1
+		while i + run < len(data) and data[i + run] == value:
+			run += 1
+
+		# Blank and solid runs cost one byte, anything else needs 3 to beat a literal
+		if value in (0x00, 0xFF) and run >= 2 or run >= 3:
+			flush_literal()
+			i += run
+			while run > 0:
+				if value in (0x00, 0xFF):
+					count = min(run, RLE_MAX_COUNT + 1)
+					out.append((RLE_ZEROS if value == 0x00 else RLE_ONES) | (count - 1))
+				elif run >= 3:
+					count = min(run, RLE_MAX_COUNT + 3)
+					out.extend([RLE_REPEAT | (count - 3), value])
+				else:
+					count = run
+					literal.extend([value] * count)
+				run -= count
+		else:
+			literal.extend(data[i:i + run])
+			i += run
+
+	flush_literal()
+	return out
+
+
+def decompress(data, size):
+	out = []
+	i = 0
+	while len(out) < size:
+		control = data[i]
+		count = control & RLE_MAX_COUNT
+		code = control & ~RLE_MAX_COUNT
+		i += 1
+		if code == RLE_LITERAL:
+			out.extend(data[i:i + count + 1])
+			i += count + 1
+		elif code == RLE_ZEROS:
+			out.extend([0x00] * (count + 1))
+		elif code == RLE_ONES:
+			out.extend([0xFF] * (count + 1))
+		else:
+			out.extend([data[i]] * (count + 3))
+			i += 1
+
+	return out
+
+
+def generate(source_path, output_path):
+	with open(source_path) as f:
+		images = parse_images(f.read())
+
+	lines = [
+		'// Generated by tools/compress-bitmaps.py from bitmaps.h, edit that file instead.',
+		'',
+		'#ifndef BITMAPS_RLE_H_',
+		'#define BITMAPS_RLE_H_',
+		'',
+		'#include "rlebitmap.h"',
+		'',
+	]
+
+	for name, width, height, data in images:
+		pages = to_pages(width, height, data)
+		packed = compress(pages)
+		assert decompress(packed, len(pages)) == pages, name
+
+		if packed:
+			lines.append('// {}x{}px, {} bytes from {}'.format(width, height, len(packed), len(data)))
+			lines.append('static const uint8_t {}Data[] = {{'.format(name))
+			for row in range(0, len(packed), 16):
+				lines.append('\t' + ', '.join('0x{:02x}'.format(value) for value in packed[row:row + 16]) + ',')
+			lines.append('};')
+			lines.append('const RLEBitmap {} = {{ {}, {}, sizeof({}Data), {}Data }};'.format(name, width, height, name, name))
+		else:
+			lines.append('// Empty in bitmaps.h')
+			lines.append('const RLEBitmap {} = {{ 0, 0, 0, nullptr }};'.format(name))
+		lines.append('')
+
+	lines.append('#endif')
+	with open(output_path, 'w') as f:
+		f.write('\n'.join(lines) + '\n')
+
+
+def generate_if_changed(source_path, output_path):
+	if os.path.exists(output_path) and os.path.getmtime(output_path) >= os.path.getmtime(source_path):
+		return
+
+	print('Compressing {}'.format(source_path))
+	generate(source_path, output_path)
+
+
+try:
+	Import('env') # PlatformIO pre script
+	project = env.subst('$PROJECT_DIR')
+	generate_if_changed(os.path.join(project, 'include', 'bitmaps.h'), os.path.join(project, 'include', 'bitmaps_rle.h'))
+except NameError:
+	if __name__ == '__main__':
+		root = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..')
+		source = sys.argv[1] if len(sys.argv) > 1 else os.path.join(root, 'include', 'bitmaps.h')
+		output = sys.argv[2] if len(sys.argv) > 2 else os.path.join(root, 'include', 'bitmaps_rle.h')
+		generate(source, output)
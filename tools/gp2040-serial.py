@@ -0,0 +1,247 @@
+#!/usr/bin/env python3
+#
+# SPDX-License-Identifier: MIT
+# SPDX-FileCopyrightText: Copyright (c) 2021 Jason Skuby (mytechtoybox.com)
+#
+# Host side of the GP2040 serial config protocol (include/configs/serialconfig.h).
+# Hold S1 while plugging the controller in to start serial config mode.
+#
+#   gp2040-serial.py -p /dev/ttyACM0 ping
+#   gp2040-serial.py -p /dev/ttyACM0 dump profile.bin
+#   gp2040-serial.py -p /dev/ttyACM0 -p /dev/ttyACM1 load profile.bin --reboot
+#   gp2040-serial.py -p /dev/ttyACM0 telemetry --stream 100
+#
+# Profiles are the records of a SET command as is, so they only load on firmware with the same block sizes.
+# Requires pyserial.
+
+import argparse
+import struct
+import sys
+import zlib
+
+import serial
+
+SYNC = 0xA5
+HEADER_SIZE = 5
+RECORD = struct.Struct('<BH')
+TELEMETRY = struct.Struct('<IBHHIIII')
+
+CMD_PING = 0x01
+CMD_GET = 0x02
+CMD_SET = 0x03
+CMD_TELEMETRY = 0x04
+CMD_STREAM = 0x05
+CMD_REBOOT = 0x06
+CMD_REPLY = 0x80
+
+BLOCKS = ['gamepad', 'board', 'led', 'animation']
+STATUS = ['ok', 'bad crc', 'bad command', 'bad block', 'bad size']
+
+
+class SerialConfigError(Exception):
+	pass
+
+
+class Device:
+	def __init__(self, port, timeout):
+		self.port = serial.Serial(port, timeout=timeout)
+		self.port.dtr = True # The firmware only talks while the port is open
+		self.sequence = 0
+
+	def close(self):
+		self.port.close()
+
+	def send(self, command, payload=b''):
+		self.sequence = (self.sequence + 1) & 0xFF
+		body = struct.pack('<BBH', command, self.sequence, len(payload)) + payload
+		self.port.write(bytes([SYNC]) + body + struct.pack('<I', zlib.crc32(body)))
+
+	def receive(self):
+		while True:
+			sync = self.port.read(1)
+			if not sync:
+				raise SerialConfigError('timed out waiting for a reply')
+			if sync[0] == SYNC:
+				break
+
+		header = self.port.read(HEADER_SIZE - 1)
+		if len(header) != HEADER_SIZE - 1:
+			raise SerialConfigError('short reply')
+		command, sequence, length = struct.unpack('<BBH', header)
+		payload = self.port.read(length)
+		checksum = self.port.read(4)
+		if len(payload) != length or len(checksum) != 4:
+			raise SerialConfigError('short reply')
+		if zlib.crc32(header + payload) != struct.unpack('<I', checksum)[0]:
+			raise SerialConfigError('reply failed its CRC')
+
+		if length == 0 or not command & CMD_REPLY:
+			raise SerialConfigError('not a reply')
+
+		return command & ~CMD_REPLY, sequence, payload[0], payload[1:]
+
+	def request(self, command, payload=b''):
+		self.send(command, payload)
+		while True:
+			reply, sequence, status, data = self.receive()
+			if reply == command and sequence == self.sequence:
+				break
+
+		if status != 0:
+			name = STATUS[status] if status < len(STATUS) else str(status)
+			raise SerialConfigError('{}: {}'.format(self.port.port, name))
+
+		return data
+
+	def ping(self):
+		data = self.request(CMD_PING)
+		version, max_payload = struct.unpack_from('<BH', data)
+		sizes = struct.unpack_from('<' + 'H' * len(BLOCKS), data, 3)
+		firmware = data[3 + 2 * len(BLOCKS):].decode('ascii', 'replace')
+		return version, max_payload, dict(zip(BLOCKS, sizes)), firmware
+
+	def get(self, blocks):
+		return self.request(CMD_GET, bytes(BLOCKS.index(block) for block in blocks))
+
+	def set(self, records):
+		self.request(CMD_SET, records)
+
+	def telemetry(self):
+		return TELEMETRY.unpack(self.request(CMD_TELEMETRY))
+
+	def stream(self, interval):
+		self.request(CMD_STREAM, struct.pack('<H', interval))
+		while True:
+			command, _, _, data = self.receive()
+			if command == CMD_STREAM:
+				yield TELEMETRY.unpack(data)
+
+	def reboot(self):
+		self.request(CMD_REBOOT)
+
+
+def parse_records(data):
+	records = []
+	offset = 0
+	while offset < len(data):
+		block, size = RECORD.unpack_from(data, offset)
+		offset += RECORD.size
+		records.append((BLOCKS[block], size, data[offset:offset + size]))
+		offset += size
+
+	return records
+
+
+def format_telemetry(values):
+	uptime, dpad, buttons, aux, poll_rate, bad_frames, flash_commits, flash_stall = values
+	return 'uptime {:>8}ms  dpad {:04b}  buttons {:014b}  aux {:04x}  polls/s {:>6}  bad frames {}  flash {} ({}us)'.format(
+		uptime, dpad, buttons, aux, poll_rate, bad_frames, flash_commits, flash_stall)
+
+
+def command_ping(device, args):
+	version, max_payload, sizes, firmware = device.ping()
+	print('{}: firmware {}, protocol v{}, max payload {}'.format(device.port.port, firmware, version, max_payload))
+	for block, size in sizes.items():
+		print('  {:<10} {} bytes'.format(block, size))
+
+
+def command_get(device, args):
+	for block, size, data in parse_records(device.get(args.blocks or BLOCKS)):
+		print('{:<10} {}'.format(block, data.hex()))
+
+
+def command_dump(device, args):
+	data = device.get(BLOCKS)
+	with open(args.file, 'wb') as f:
+		f.write(data)
+	print('{}: saved {} bytes to {}'.format(device.port.port, len(data), args.file))
+
+
+def command_load(device, args):
+	with open(args.file, 'rb') as f:
+		data = f.read()
+
+	# Block layouts change between firmware versions, refuse anything that wasn't dumped from a match
+	_, _, sizes, firmware = device.ping()
+	records = parse_records(data)
+	for block, size, _ in records:
+		if sizes[block] != size:
+			raise SerialConfigError('{}: {} is {} bytes on firmware {}, the profile has {}'.format(
+				device.port.port, block, sizes[block], firmware, size))
+
+	if args.blocks:
+		data = b''.join(RECORD.pack(BLOCKS.index(block), size) + body for block, size, body in records if block in args.blocks)
+
+	device.set(data)
+	print('{}: loaded {}'.format(device.port.port, args.file))
+	if args.reboot:
+		device.reboot()
+
+
+def command_telemetry(device, args):
+	if args.stream:
+		try:
+			for values in device.stream(args.stream):
+				print(format_telemetry(values))
+		except KeyboardInterrupt:
+			device.request(CMD_STREAM, struct.pack('<H', 0))
+	else:
+		print(format_telemetry(device.telemetry()))
+
+
+def command_reboot(device, args):
+	device.reboot()
+
+
+def main():
+	parser = argparse.ArgumentParser(description='GP2040 serial config')
+	parser.add_argument('-p', '--port', action='append', required=True, help='serial port, repeat to configure several controllers')
+	parser.add_argument('-t', '--timeout', type=float, default=1.0, help='reply timeout in seconds')
+	commands = parser.add_subparsers(dest='command', required=True)
+
+	commands.add_parser('ping', help='show firmware and block sizes').set_defaults(run=command_ping)
+
+	get = commands.add_parser('get', help='print blocks as hex')
+	get.add_argument('blocks', nargs='*', choices=BLOCKS)
+	get.set_defaults(run=command_get)
+
+	dump = commands.add_parser('dump', help='save every block to a profile')
+	dump.add_argument('file')
+	dump.set_defaults(run=command_dump)
+
+	load = commands.add_parser('load', help='store a profile')
+	load.add_argument('file')
+	load.add_argument('-b', '--blocks', nargs='+', choices=BLOCKS, help='only load these blocks')
+	load.add_argument('--reboot', action='store_true', help='restart into gamepad mode afterwards')
+	load.set_defaults(run=command_load)
+
+	telemetry = commands.add_parser('telemetry', help='read inputs and counters')
+	telemetry.add_argument('-s', '--stream', type=int, metavar='MS', help='keep reading every MS milliseconds until interrupted')
+	telemetry.set_defaults(run=command_telemetry)
+
+	commands.add_parser('reboot', help='restart into gamepad mode').set_defaults(run=command_reboot)
+
+	args = parser.parse_args()
+
+	failed = False
+	for port in args.port:
+		try:
+			device = Device(port, args.timeout)
+		except serial.SerialException as e:
+			print(e, file=sys.stderr)
+			failed = True
+			continue
+
+		try:
+			args.run(device, args)
+		except SerialConfigError as e:
+			print(e, file=sys.stderr)
+			failed = True
+		finally:
+			device.close()
+
+	return 1 if failed else 0
+
+
+if __name__ == '__main__':
+	sys.exit(main())
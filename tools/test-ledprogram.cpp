@@ -0,0 +1,76 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: Copyright (c) 2021 Jason Skuby (mytechtoybox.com)
+ */
+
+// Host checks of LEDProgram::Validate and Load against uploads the web config could send, deeply
+// nested chains in particular. Compiling recurses once per nesting level and both run on a 2 KB
+// core stack, so these have to be turned away while parsing.
+//
+//   g++ -O2 -std=gnu++14 -Ilib/AnimationStation/src -Ilib/NeoPico/src tools/test-ledprogram.cpp -o test-ledprogram
+//   ./test-ledprogram
+
+#include <stdint.h>
+#include <stdio.h>
+#include <vector>
+
+// Only LEDFormat is needed from NeoPico.hpp, the rest pulls in the Pico SDK
+#define _NEO_PICO_H_
+typedef enum
+{
+	LED_FORMAT_GRB = 0,
+	LED_FORMAT_RGB = 1,
+	LED_FORMAT_GRBW = 2,
+	LED_FORMAT_RGBW = 3,
+} LEDFormat;
+
+#include "LEDProgram.cpp"
+
+static int failures = 0;
+
+static void check(const char *name, const std::vector<uint8_t> &code, LEDProgramError expected)
+{
+	LEDProgramError validated = LEDProgram::Validate(code.data(), code.size());
+	LEDProgram program;
+	LEDProgramError loaded = program.Load(code.data(), code.size());
+	bool passed = (validated == expected && loaded == expected);
+	printf("%-4s %-36s %4zu bytes  validate: %s, load: %s\n", passed ? "ok" : "FAIL", name, code.size(),
+		LEDProgram::ErrorName(validated), LEDProgram::ErrorName(loaded));
+	if (!passed)
+		failures++;
+}
+
+// TIME, then (TIME ADD) or (DUP ADD) count times, nesting one level deeper each time, then r, g, b
+static std::vector<uint8_t> chain(uint8_t operand, int count)
+{
+	std::vector<uint8_t> code = { LED_OP_TIME };
+	for (int i = 0; i < count; i++)
+	{
+		code.push_back(operand);
+		code.push_back(LED_OP_ADD);
+	}
+	code.push_back(LED_OP_DUP);
+	code.push_back(LED_OP_DUP);
+	code.push_back(LED_OP_END);
+	return code;
+}
+
+int main()
+{
+	check("x y time", { LED_OP_X, LED_OP_Y, LED_OP_TIME, LED_OP_END }, LED_PROGRAM_OK);
+	check("time chain at the depth limit", chain(LED_OP_TIME, LED_PROGRAM_MAX_DEPTH - 1), LED_PROGRAM_OK);
+	check("time chain past the depth limit", chain(LED_OP_TIME, LED_PROGRAM_MAX_DEPTH), LED_PROGRAM_TOO_COMPLEX);
+	check("time chain filling the upload", chain(LED_OP_TIME, (LED_PROGRAM_MAX_SIZE - 4) / 2), LED_PROGRAM_TOO_COMPLEX);
+	check("dup chain filling the upload", chain(LED_OP_DUP, (LED_PROGRAM_MAX_SIZE - 4) / 2), LED_PROGRAM_TOO_COMPLEX);
+
+	// SWAP and OVER carry the nesting of the entries they move
+	std::vector<uint8_t> swapped = chain(LED_OP_TIME, LED_PROGRAM_MAX_DEPTH - 1);
+	swapped.insert(swapped.end() - 3, { LED_OP_X, LED_OP_SWAP, LED_OP_TIME, LED_OP_ADD, LED_OP_ADD });
+	check("swap past the depth limit", swapped, LED_PROGRAM_TOO_COMPLEX);
+	std::vector<uint8_t> over = chain(LED_OP_TIME, LED_PROGRAM_MAX_DEPTH - 1);
+	over.insert(over.end() - 3, { LED_OP_X, LED_OP_OVER, LED_OP_TIME, LED_OP_ADD, LED_OP_ADD, LED_OP_ADD });
+	check("over past the depth limit", over, LED_PROGRAM_TOO_COMPLEX);
+
+	printf("%s\n", failures ? "FAILED" : "all passed");
+	return failures ? 1 : 0;
+}
@@ -75,6 +75,10 @@ app.get('/api/getLedOptions', (req, res) => {
 		ledFormat: 0,
 		ledLayout: 1,
 		ledsPerButton: 2,
+		frameRate: 0,
+		chains: [
+			{ dataPin: 16, ledFormat: 0, ledCount: 12 },
+		],
 		ledButtonMap: {
 			Up: 3,
 			Down: 1,
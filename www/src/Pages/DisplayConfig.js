@@ -17,6 +17,35 @@ const I2C_BLOCKS = [
 	{ label: 'i2c1', value: 1 },
 ];
 
+const BUTTON_LAYOUTS = [
+	{ label: 'Arcade', value: 0 },
+	{ label: 'Hitbox', value: 1 },
+	{ label: 'WASD', value: 2 },
+	{ label: 'UDLR', value: 3 },
+	{ label: 'Keyboard Angled', value: 4 },
+	{ label: 'Keyboard', value: 5 },
+	{ label: 'Dancepad', value: 6 },
+	{ label: 'Twinstick', value: 7 },
+	{ label: 'Blank', value: 8 },
+	{ label: 'Custom', value: 9 },
+];
+
+const BUTTON_LAYOUTS_RIGHT = [
+	{ label: 'Arcade', value: 0 },
+	{ label: 'Hitbox', value: 1 },
+	{ label: 'WASD', value: 2 },
+	{ label: 'Vewlix', value: 3 },
+	{ label: 'Vewlix 7', value: 4 },
+	{ label: 'Capcom', value: 5 },
+	{ label: 'Capcom 6', value: 6 },
+	{ label: 'Sega 2P', value: 7 },
+	{ label: 'Noir 8', value: 8 },
+	{ label: 'Keyboard', value: 9 },
+	{ label: 'Dancepad', value: 10 },
+	{ label: 'Twinstick', value: 11 },
+	{ label: 'Blank', value: 12 },
+];
+
 const defaultValues = {
 	enabled: false,
 	sdaPin: -1,
@@ -26,6 +55,8 @@ const defaultValues = {
 	i2cSpeed: 400000,
 	flipDisplay: false,
 	invertDisplay: false,
+	buttonLayout: 0,
+	buttonLayoutRight: 0,
 };
 
 let usedPins = [];
@@ -41,6 +72,8 @@ const schema = yup.object().shape({
 	i2cSpeed: yup.number().required().label('I2C Speed'),
 	flipDisplay: yup.number().label('Flip Display'),
 	invertDisplay: yup.number().label('Invert Display'),
+	buttonLayout: yup.number().required().oneOf(BUTTON_LAYOUTS.map(o => o.value)).label('Button Layout Left'),
+	buttonLayoutRight: yup.number().required().oneOf(BUTTON_LAYOUTS_RIGHT.map(o => o.value)).label('Button Layout Right'),
 });
 
 const FormContext = () => {
@@ -64,11 +97,69 @@ const FormContext = () => {
 			values.flipDisplay = parseInt(values.flipDisplay);
 		if (!!values.invertDisplay)
 			values.invertDisplay = parseInt(values.invertDisplay);
+		if (!!values.buttonLayout)
+			values.buttonLayout = parseInt(values.buttonLayout);
+		if (!!values.buttonLayoutRight)
+			values.buttonLayoutRight = parseInt(values.buttonLayoutRight);
 	}, [values, setValues]);
 
 	return null;
 };
 
+const DisplayLayoutSection = () => {
+	const [layout, setLayout] = useState('[]');
+	const [maxElements, setMaxElements] = useState(32);
+	const [layoutMessage, setLayoutMessage] = useState('');
+
+	useEffect(() => {
+		async function fetchData() {
+			const data = await WebApi.getDisplayLayout();
+			if (data) {
+				setLayout(JSON.stringify(data.elements).replace(/\],\[/g, '],\n['));
+				setMaxElements(data.maxElements);
+			}
+		}
+		fetchData();
+	}, []);
+
+	const uploadLayout = async () => {
+		let elements;
+		try {
+			elements = JSON.parse(layout);
+		}
+		catch (err) {
+			setLayoutMessage('Unable to Upload: invalid JSON');
+			return;
+		}
+
+		const result = await WebApi.setDisplayLayout(elements);
+		setLayoutMessage(result.success ? 'Uploaded! Select the Custom left layout to show it' : `Unable to Upload: ${result.error}`);
+	};
+
+	return (
+		<Section title="Custom Display Layout">
+			<p className="card-text">
+				Up to {maxElements} elements as <code>[shape, x, y, width, height, mask]</code>, shown in place of the left layout when
+				Custom is selected. Shapes are 0 for an ellipse centered on x, y with width and height as the radii, 1 for a rectangle
+				from its top left corner, 2 for a diamond centered on x, y with width as its size, and 3 for a stick starting at x, y
+				with width as the ball radius and height as its travel. The mask is the button that fills the shape, the dpad is
+				<code>0x10000</code> up, <code>0x20000</code> down, <code>0x40000</code> left and <code>0x80000</code> right. A stick's
+				mask holds the bit numbers of its up, down, left and right buttons a byte each, <code>0x13121110</code> for the dpad.
+				Use the Blank right layout for a full screen layout. Changes apply without a restart.
+			</p>
+			<Form.Control
+				as="textarea"
+				rows={8}
+				className="form-control-sm mb-3 font-monospace"
+				value={layout}
+				onChange={(e) => setLayout(e.target.value)}
+			/>
+			<Button onClick={uploadLayout}>Upload</Button>
+			{layoutMessage ? <span className="alert">{layoutMessage}</span> : null}
+		</Section>
+	);
+};
+
 export default function DisplayConfigPage() {
 	const [saveMessage, setSaveMessage] = useState('');
 
@@ -78,173 +169,202 @@ export default function DisplayConfigPage() {
 	};
 
 	return (
-		<Formik validationSchema={schema} onSubmit={onSuccess} initialValues={defaultValues}>
-			{({
-				handleSubmit,
-				handleChange,
-				handleBlur,
-				values,
-				touched,
-				errors,
-			}) => (
-				<Section title="Display Configuration">
-					<p>
-						A monochrome display can be used to show controller status and button activity. Ensure your display module
-						has the following attributes:
-					</p>
-					<ul>
-						<li>Monochrome display with 128x64 resolution</li>
-						<li>Uses I2C with a SSD1306, SH1106, SH1107 or other compatible display IC</li>
-						<li>Supports 3.3v operation</li>
-					</ul>
-					<p>
-						Use these tables to determine which I2C block to select based on the configured SDA and SCL pins:
-					</p>
-					<Row>
-						<Col>
-							<table className="table table-sm mb-4">
-								<thead>
-									<tr>
-										<th>SDA/SCL Pins</th>
-										<th>I2C Block</th>
-									</tr>
-								</thead>
-								<tbody>
-									<tr><td>0/1</td><td>i2c0</td></tr>
-									<tr><td>2/3</td><td>i2c1</td></tr>
-									<tr><td>4/5</td><td>i2c0</td></tr>
-									<tr><td>6/7</td><td>i2c1</td></tr>
-									<tr><td>8/9</td><td>i2c0</td></tr>
-									<tr><td>10/11</td><td>i2c1</td></tr>
-								</tbody>
-							</table>
-						</Col>
-						<Col>
-							<table className="table table-sm mb-4">
-								<thead>
-									<tr>
-										<th>SDA/SCL Pins</th>
-										<th>I2C Block</th>
-									</tr>
-								</thead>
-								<tbody>
-									<tr><td>12/13</td><td>i2c0</td></tr>
-									<tr><td>14/15</td><td>i2c1</td></tr>
-									<tr><td>16/17</td><td>i2c0</td></tr>
-									<tr><td>18/19</td><td>i2c1</td></tr>
-									<tr><td>20/21</td><td>i2c0</td></tr>
-									<tr><td>26/27</td><td>i2c1</td></tr>
-								</tbody>
-							</table>
-						</Col>
-					</Row>
-					<Form noValidate onSubmit={handleSubmit}>
+		<>
+			<Formik validationSchema={schema} onSubmit={onSuccess} initialValues={defaultValues}>
+				{({
+					handleSubmit,
+					handleChange,
+					handleBlur,
+					values,
+					touched,
+					errors,
+				}) => (
+					<Section title="Display Configuration">
+						<p>
+							A monochrome display can be used to show controller status and button activity. Ensure your display module
+							has the following attributes:
+						</p>
+						<ul>
+							<li>Monochrome display with 128x64 resolution</li>
+							<li>Uses I2C with a SSD1306, SH1106, SH1107 or other compatible display IC</li>
+							<li>Supports 3.3v operation</li>
+						</ul>
+						<p>
+							Use these tables to determine which I2C block to select based on the configured SDA and SCL pins:
+						</p>
 						<Row>
-							<FormSelect
-								label="Use Display"
-								name="enabled"
-								className="form-select-sm"
-								groupClassName="col-sm-3 mb-3"
-								value={values.enabled}
-								error={errors.enabled}
-								isInvalid={errors.enabled}
-								onChange={handleChange}
-							>
-								{ON_OFF_OPTIONS.map((o, i) => <option key={`enabled-option-${i}`} value={o.value}>{o.label}</option>)}
-							</FormSelect>
-							<FormSelect
-								label="I2C Block"
-								name="i2cBlock"
-								className="form-select-sm"
-								groupClassName="col-sm-3 mb-3"
-								value={values.i2cBlock}
-								error={errors.i2cBlock}
-								isInvalid={errors.i2cBlock}
-								onChange={handleChange}
-							>
-								{I2C_BLOCKS.map((o, i) => <option key={`i2cBlock-option-${i}`} value={o.value}>{o.label}</option>)}
-							</FormSelect>
-							<FormControl type="number"
-								label="SDA Pin"
-								name="sdaPin"
-								className="form-control-sm"
-								groupClassName="col-sm-3 mb-3"
-								value={values.sdaPin}
-								error={errors.sdaPin}
-								isInvalid={errors.sdaPin}
-								onChange={handleChange}
-								min={-1}
-								max={29}
-							/>
-							<FormControl type="number"
-								label="SCL Pin"
-								name="sclPin"
-								className="form-control-sm"
-								groupClassName="col-sm-3 mb-3"
-								value={values.sclPin}
-								error={errors.sclPin}
-								isInvalid={errors.sclPin}
-								onChange={handleChange}
-								min={-1}
-								max={29}
-							/>
-						</Row>
-						<Row className="mb-3">
-							<FormControl type="text"
-								label="I2C Address"
-								name="i2cAddress"
-								className="form-control-sm"
-								groupClassName="col-sm-3 mb-3"
-								value={values.i2cAddress}
-								error={errors.i2cAddress}
-								isInvalid={errors.i2cAddress}
-								onChange={handleChange}
-								maxLength={4}
-							/>
-							<FormControl type="number"
-								label="I2C Speed"
-								name="i2cSpeed"
-								className="form-control-sm"
-								groupClassName="col-sm-3 mb-3"
-								value={values.i2cSpeed}
-								error={errors.i2cSpeed}
-								isInvalid={errors.i2cSpeed}
-								onChange={handleChange}
-								min={100000}
-							/>
-							<FormSelect
-								label="Flip Display"
-								name="flipDisplay"
-								className="form-select-sm"
-								groupClassName="col-sm-3 mb-3"
-								value={values.flipDisplay}
-								error={errors.flipDisplay}
-								isInvalid={errors.flipDisplay}
-								onChange={handleChange}
-							>
-								{ON_OFF_OPTIONS.map((o, i) => <option key={`flipDisplay-option-${i}`} value={o.value}>{o.label}</option>)}
-							</FormSelect>
-							<FormSelect
-								label="Invert Display"
-								name="invertDisplay"
-								className="form-select-sm"
-								groupClassName="col-sm-3 mb-3"
-								value={values.invertDisplay}
-								error={errors.invertDisplay}
-								isInvalid={errors.invertDisplay}
-								onChange={handleChange}
-							>
-								{ON_OFF_OPTIONS.map((o, i) => <option key={`invertDisplay-option-${i}`} value={o.value}>{o.label}</option>)}
-							</FormSelect>
+							<Col>
+								<table className="table table-sm mb-4">
+									<thead>
+										<tr>
+											<th>SDA/SCL Pins</th>
+											<th>I2C Block</th>
+										</tr>
+									</thead>
+									<tbody>
+										<tr><td>0/1</td><td>i2c0</td></tr>
+										<tr><td>2/3</td><td>i2c1</td></tr>
+										<tr><td>4/5</td><td>i2c0</td></tr>
+										<tr><td>6/7</td><td>i2c1</td></tr>
+										<tr><td>8/9</td><td>i2c0</td></tr>
+										<tr><td>10/11</td><td>i2c1</td></tr>
+									</tbody>
+								</table>
+							</Col>
+							<Col>
+								<table className="table table-sm mb-4">
+									<thead>
+										<tr>
+											<th>SDA/SCL Pins</th>
+											<th>I2C Block</th>
+										</tr>
+									</thead>
+									<tbody>
+										<tr><td>12/13</td><td>i2c0</td></tr>
+										<tr><td>14/15</td><td>i2c1</td></tr>
+										<tr><td>16/17</td><td>i2c0</td></tr>
+										<tr><td>18/19</td><td>i2c1</td></tr>
+										<tr><td>20/21</td><td>i2c0</td></tr>
+										<tr><td>26/27</td><td>i2c1</td></tr>
+									</tbody>
+								</table>
+							</Col>
 						</Row>
-						<div className="mt-3">
-							<Button type="submit">Save</Button>
-							{saveMessage ? <span className="alert">{saveMessage}</span> : null}
-						</div>
-						<FormContext />
-					</Form>
-				</Section>
-			)}
-		</Formik>
+						<Form noValidate onSubmit={handleSubmit}>
+							<Row>
+								<FormSelect
+									label="Use Display"
+									name="enabled"
+									className="form-select-sm"
+									groupClassName="col-sm-3 mb-3"
+									value={values.enabled}
+									error={errors.enabled}
+									isInvalid={errors.enabled}
+									onChange={handleChange}
+								>
+									{ON_OFF_OPTIONS.map((o, i) => <option key={`enabled-option-${i}`} value={o.value}>{o.label}</option>)}
+								</FormSelect>
+								<FormSelect
+									label="I2C Block"
+									name="i2cBlock"
+									className="form-select-sm"
+									groupClassName="col-sm-3 mb-3"
+									value={values.i2cBlock}
+									error={errors.i2cBlock}
+									isInvalid={errors.i2cBlock}
+									onChange={handleChange}
+								>
+									{I2C_BLOCKS.map((o, i) => <option key={`i2cBlock-option-${i}`} value={o.value}>{o.label}</option>)}
+								</FormSelect>
+								<FormControl type="number"
+									label="SDA Pin"
+									name="sdaPin"
+									className="form-control-sm"
+									groupClassName="col-sm-3 mb-3"
+									value={values.sdaPin}
+									error={errors.sdaPin}
+									isInvalid={errors.sdaPin}
+									onChange={handleChange}
+									min={-1}
+									max={29}
+								/>
+								<FormControl type="number"
+									label="SCL Pin"
+									name="sclPin"
+									className="form-control-sm"
+									groupClassName="col-sm-3 mb-3"
+									value={values.sclPin}
+									error={errors.sclPin}
+									isInvalid={errors.sclPin}
+									onChange={handleChange}
+									min={-1}
+									max={29}
+								/>
+							</Row>
+							<Row className="mb-3">
+								<FormControl type="text"
+									label="I2C Address"
+									name="i2cAddress"
+									className="form-control-sm"
+									groupClassName="col-sm-3 mb-3"
+									value={values.i2cAddress}
+									error={errors.i2cAddress}
+									isInvalid={errors.i2cAddress}
+									onChange={handleChange}
+									maxLength={4}
+								/>
+								<FormControl type="number"
+									label="I2C Speed"
+									name="i2cSpeed"
+									className="form-control-sm"
+									groupClassName="col-sm-3 mb-3"
+									value={values.i2cSpeed}
+									error={errors.i2cSpeed}
+									isInvalid={errors.i2cSpeed}
+									onChange={handleChange}
+									min={100000}
+								/>
+								<FormSelect
+									label="Flip Display"
+									name="flipDisplay"
+									className="form-select-sm"
+									groupClassName="col-sm-3 mb-3"
+									value={values.flipDisplay}
+									error={errors.flipDisplay}
+									isInvalid={errors.flipDisplay}
+									onChange={handleChange}
+								>
+									{ON_OFF_OPTIONS.map((o, i) => <option key={`flipDisplay-option-${i}`} value={o.value}>{o.label}</option>)}
+								</FormSelect>
+								<FormSelect
+									label="Invert Display"
+									name="invertDisplay"
+									className="form-select-sm"
+									groupClassName="col-sm-3 mb-3"
+									value={values.invertDisplay}
+									error={errors.invertDisplay}
+									isInvalid={errors.invertDisplay}
+									onChange={handleChange}
+								>
+									{ON_OFF_OPTIONS.map((o, i) => <option key={`invertDisplay-option-${i}`} value={o.value}>{o.label}</option>)}
+								</FormSelect>
+							</Row>
+							<Row className="mb-3">
+								<FormSelect
+									label="Button Layout Left"
+									name="buttonLayout"
+									className="form-select-sm"
+									groupClassName="col-sm-3 mb-3"
+									value={values.buttonLayout}
+									error={errors.buttonLayout}
+									isInvalid={errors.buttonLayout}
+									onChange={handleChange}
+								>
+									{BUTTON_LAYOUTS.map((o, i) => <option key={`buttonLayout-option-${i}`} value={o.value}>{o.label}</option>)}
+								</FormSelect>
+								<FormSelect
+									label="Button Layout Right"
+									name="buttonLayoutRight"
+									className="form-select-sm"
+									groupClassName="col-sm-3 mb-3"
+									value={values.buttonLayoutRight}
+									error={errors.buttonLayoutRight}
+									isInvalid={errors.buttonLayoutRight}
+									onChange={handleChange}
+								>
+									{BUTTON_LAYOUTS_RIGHT.map((o, i) => <option key={`buttonLayoutRight-option-${i}`} value={o.value}>{o.label}</option>)}
+								</FormSelect>
+							</Row>
+							<div className="mt-3">
+								<Button type="submit">Save</Button>
+								{saveMessage ? <span className="alert">{saveMessage}</span> : null}
+							</div>
+							<FormContext />
+						</Form>
+					</Section>
+				)}
+			</Formik>
+			<DisplayLayoutSection />
+		</>
 	);
 }
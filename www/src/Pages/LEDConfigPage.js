@@ -1,6 +1,6 @@
 import React, { useContext, useEffect, useState } from 'react';
 import { Button, Form, Row } from 'react-bootstrap';
-import { Formik, useFormikContext } from 'formik';
+import { Formik, getIn, useFormikContext } from 'formik';
 import { orderBy } from 'lodash';
 import * as yup from 'yup';
 import { AppContext } from '../Contexts/AppContext';
@@ -24,6 +24,10 @@ const BUTTON_LAYOUTS = [
 	{ label: 'WASD Layout', value: 2 },
 ];
 
+// Match LED_MAX_CHAINS and LED_MAX_CHAIN_LEDS in storagemanager.h
+const MAX_CHAINS = 4;
+const MAX_CHAIN_LEDS = 256;
+
 const defaultValue = {
 	brightnessMaximum: 255,
 	brightnessSteps: 5,
@@ -31,6 +35,8 @@ const defaultValue = {
 	ledFormat: 0,
 	ledLayout: 0,
 	ledsPerButton: 2,
+	frameRate: 0,
+	chains: [],
 };
 
 let usedPins = [];
@@ -43,6 +49,13 @@ const schema = yup.object().shape({
 	ledFormat         : yup.number().required().positive().integer().min(0).max(3).label('LED Format'),
 	ledLayout         : yup.number().required().positive().integer().min(0).max(2).label('LED Layout'),
 	ledsPerButton      : yup.number().required().positive().integer().min(1).label('LEDs Per Pixel'),
+	frameRate         : yup.number().required().integer().min(0).max(255).label('Frame Rate'),
+	chains            : yup.array().max(MAX_CHAINS).of(yup.object().shape({
+		// eslint-disable-next-line no-template-curly-in-string
+		dataPin         : yup.number().required().min(-1).max(29).test('', '${originalValue} is already assigned!', (value) => usedPins.indexOf(value) === -1).label('Data Pin'),
+		ledFormat       : yup.number().required().integer().min(0).max(3).label('LED Format'),
+		ledCount        : yup.number().required().integer().min(0).max(MAX_CHAIN_LEDS).label('LED Count'),
+	})).test('', `Chains can drive ${MAX_CHAIN_LEDS} LEDs in total`, (chains) => (chains || []).reduce((total, chain) => total + (chain.ledCount || 0), 0) <= MAX_CHAIN_LEDS),
 });
 
 const getLedButtons = (buttonLabels, map, excludeNulls) => {
@@ -112,6 +125,46 @@ const FormContext = ({ buttonLabels, ledButtonMap, ledFormat, setDataSources })
 	return null;
 };
 
+const LEDProgramSection = () => {
+	const [program, setProgram] = useState('');
+	const [maxSize, setMaxSize] = useState(512);
+	const [programMessage, setProgramMessage] = useState('');
+
+	useEffect(() => {
+		async function fetchData() {
+			const data = await WebApi.getLedProgram();
+			if (data) {
+				setProgram(data.program);
+				setMaxSize(data.maxSize);
+			}
+		}
+		fetchData();
+	}, []);
+
+	const uploadProgram = async () => {
+		const result = await WebApi.setLedProgram(program.replace(/\s/g, ''));
+		setProgramMessage(result.success ? 'Uploaded! Select the Custom animation to run it' : `Unable to Upload: ${result.error}`);
+	};
+
+	return (
+		<Section title="Custom LED Program">
+			<p className="card-text">
+				Bytecode for the Custom animation as a hex string, up to {maxSize} bytes.
+				The program is checked before it's saved and takes effect without a restart. Upload an empty program to remove it.
+			</p>
+			<Form.Control
+				as="textarea"
+				rows={4}
+				className="form-control-sm mb-3 font-monospace"
+				value={program}
+				onChange={(e) => setProgram(e.target.value)}
+			/>
+			<Button onClick={uploadProgram}>Upload</Button>
+			{programMessage ? <span className="alert">{programMessage}</span> : null}
+		</Section>
+	);
+};
+
 export default function LEDConfigPage() {
 	const { buttonLabels } = useContext(AppContext);
 	const [saveMessage, setSaveMessage] = useState('');
@@ -129,118 +182,191 @@ export default function LEDConfigPage() {
 	};
 
 	return (
-		<Formik validationSchema={schema} onSubmit={onSuccess} initialValues={defaultValue}>
-			{({
-				handleSubmit,
-				handleChange,
-				handleBlur,
-				values,
-				touched,
-				errors,
-			}) => (
-				<Form noValidate onSubmit={handleSubmit}>
-					<Section title="LED Configuration">
-						<Row>
-							<FormControl type="number"
-								label="Data Pin (-1 for disabled)"
-								name="dataPin"
-								className="form-control-sm"
-								groupClassName="col-sm-4 mb-3"
-								value={values.dataPin}
-								error={errors.dataPin}
-								isInvalid={errors.dataPin}
-								onChange={handleChange}
-								min={-1}
-								max={29}
-							/>
-							<FormSelect
-								label="LED Format"
-								name="ledFormat"
-								className="form-select-sm"
-								groupClassName="col-sm-4 mb-3"
-								value={values.ledFormat}
-								error={errors.ledFormat}
-								isInvalid={errors.ledFormat}
-								onChange={handleChange}
+		<>
+			<Formik validationSchema={schema} onSubmit={onSuccess} initialValues={defaultValue}>
+				{({
+					handleSubmit,
+					handleChange,
+					handleBlur,
+					setFieldValue,
+					values,
+					touched,
+					errors,
+				}) => (
+					<Form noValidate onSubmit={handleSubmit}>
+						<Section title="LED Configuration">
+							<Row>
+								<FormControl type="number"
+									label="Data Pin (-1 for disabled)"
+									name="dataPin"
+									className="form-control-sm"
+									groupClassName="col-sm-4 mb-3"
+									value={values.dataPin}
+									error={errors.dataPin}
+									isInvalid={errors.dataPin}
+									onChange={handleChange}
+									min={-1}
+									max={29}
+								/>
+								<FormSelect
+									label="LED Format"
+									name="ledFormat"
+									className="form-select-sm"
+									groupClassName="col-sm-4 mb-3"
+									value={values.ledFormat}
+									error={errors.ledFormat}
+									isInvalid={errors.ledFormat}
+									onChange={handleChange}
+									>
+									{LED_FORMATS.map((o, i) => <option key={`ledFormat-option-${i}`} value={o.value}>{o.label}</option>)}
+								</FormSelect>
+								<FormSelect
+									label="LED Layout"
+									name="ledLayout"
+									className="form-select-sm"
+									groupClassName="col-sm-4 mb-3"
+									value={values.ledLayout}
+									error={errors.ledLayout}
+									isInvalid={errors.ledLayout}
+									onChange={handleChange}
 								>
-								{LED_FORMATS.map((o, i) => <option key={`ledFormat-option-${i}`} value={o.value}>{o.label}</option>)}
-							</FormSelect>
-							<FormSelect
-								label="LED Layout"
-								name="ledLayout"
-								className="form-select-sm"
-								groupClassName="col-sm-4 mb-3"
-								value={values.ledLayout}
-								error={errors.ledLayout}
-								isInvalid={errors.ledLayout}
-								onChange={handleChange}
+									{BUTTON_LAYOUTS.map((o, i) => <option key={`ledLayout-option-${i}`} value={o.value}>{o.label}</option>)}
+								</FormSelect>
+							</Row>
+							<Row>
+								<FormControl type="number"
+									label="LEDs Per Button"
+									name="ledsPerButton"
+									className="form-control-sm"
+									groupClassName="col-sm-4 mb-3"
+									value={values.ledsPerButton}
+									error={errors.ledsPerButton}
+									isInvalid={errors.ledsPerButton}
+									onChange={handleChange}
+									min={1}
+								/>
+								<FormControl type="number"
+									label="Max Brightness"
+									name="brightnessMaximum"
+									className="form-control-sm"
+									groupClassName="col-sm-4 mb-3"
+									value={values.brightnessMaximum}
+									error={errors.brightnessMaximum}
+									isInvalid={errors.brightnessMaximum}
+									onChange={handleChange}
+									min={0}
+									max={255}
+								/>
+								<FormControl type="number"
+									label="Brightness Steps"
+									name="brightnessSteps"
+									className="form-control-sm"
+									groupClassName="col-sm-4 mb-3"
+									value={values.brightnessSteps}
+									error={errors.brightnessSteps}
+									isInvalid={errors.brightnessSteps}
+									onChange={handleChange}
+									min={1}
+									max={10}
+								/>
+							</Row>
+							<Row>
+								<FormControl type="number"
+									label="Frame Rate (0 for board default)"
+									name="frameRate"
+									className="form-control-sm"
+									groupClassName="col-sm-4 mb-3"
+									value={values.frameRate}
+									error={errors.frameRate}
+									isInvalid={errors.frameRate}
+									onChange={handleChange}
+									min={0}
+									max={255}
+								/>
+							</Row>
+						</Section>
+						<Section title="LED Chains">
+							<p className="card-text">
+								Extra LED chains on their own data pins, up to {MAX_CHAINS}. Each chain drives the next LEDs after the button LEDs,
+								and all chains together can drive up to {MAX_CHAIN_LEDS} LEDs.
+							</p>
+							{(values.chains || []).map((chain, i) =>
+								<Row key={`chain-${i}`}>
+									<FormControl type="number"
+										label="Data Pin"
+										name={`chains[${i}].dataPin`}
+										className="form-control-sm"
+										groupClassName="col-sm-3 mb-3"
+										value={chain.dataPin}
+										error={getIn(errors, `chains[${i}].dataPin`)}
+										isInvalid={getIn(errors, `chains[${i}].dataPin`)}
+										onChange={handleChange}
+										min={-1}
+										max={29}
+									/>
+									<FormSelect
+										label="LED Format"
+										name={`chains[${i}].ledFormat`}
+										className="form-select-sm"
+										groupClassName="col-sm-3 mb-3"
+										value={chain.ledFormat}
+										error={getIn(errors, `chains[${i}].ledFormat`)}
+										isInvalid={getIn(errors, `chains[${i}].ledFormat`)}
+										onChange={(e) => setFieldValue(`chains[${i}].ledFormat`, parseInt(e.target.value))}
+									>
+										{LED_FORMATS.map((o, j) => <option key={`chain-${i}-ledFormat-option-${j}`} value={o.value}>{o.label}</option>)}
+									</FormSelect>
+									<FormControl type="number"
+										label="LED Count"
+										name={`chains[${i}].ledCount`}
+										className="form-control-sm"
+										groupClassName="col-sm-3 mb-3"
+										value={chain.ledCount}
+										error={getIn(errors, `chains[${i}].ledCount`)}
+										isInvalid={getIn(errors, `chains[${i}].ledCount`)}
+										onChange={handleChange}
+										min={0}
+										max={MAX_CHAIN_LEDS}
+									/>
+									<div className="col-sm-3 mb-3 d-flex align-items-end">
+										<Button size="sm" variant="secondary" onClick={() => setFieldValue('chains', values.chains.filter((c, j) => j !== i))}>Remove</Button>
+									</div>
+								</Row>
+							)}
+							{typeof errors.chains === 'string' ? <div className="text-danger mb-3">{errors.chains}</div> : null}
+							<Button size="sm" variant="secondary" disabled={(values.chains || []).length >= MAX_CHAINS}
+								onClick={() => setFieldValue('chains', [...(values.chains || []), { dataPin: -1, ledFormat: values.ledFormat, ledCount: 0 }])}
 							>
-								{BUTTON_LAYOUTS.map((o, i) => <option key={`ledLayout-option-${i}`} value={o.value}>{o.label}</option>)}
-							</FormSelect>
-						</Row>
-						<Row>
-							<FormControl type="number"
-								label="LEDs Per Button"
-								name="ledsPerButton"
-								className="form-control-sm"
-								groupClassName="col-sm-4 mb-3"
-								value={values.ledsPerButton}
-								error={errors.ledsPerButton}
-								isInvalid={errors.ledsPerButton}
-								onChange={handleChange}
-								min={1}
-							/>
-							<FormControl type="number"
-								label="Max Brightness"
-								name="brightnessMaximum"
-								className="form-control-sm"
-								groupClassName="col-sm-4 mb-3"
-								value={values.brightnessMaximum}
-								error={errors.brightnessMaximum}
-								isInvalid={errors.brightnessMaximum}
-								onChange={handleChange}
-								min={0}
-								max={255}
-							/>
-							<FormControl type="number"
-								label="Brightness Steps"
-								name="brightnessSteps"
-								className="form-control-sm"
-								groupClassName="col-sm-4 mb-3"
-								value={values.brightnessSteps}
-								error={errors.brightnessSteps}
-								isInvalid={errors.brightnessSteps}
-								onChange={handleChange}
-								min={1}
-								max={10}
+								Add Chain
+							</Button>
+						</Section>
+						<Section title="LED Button Order">
+							<p className="card-text">
+								Here you can define which buttons have RGB LEDs and in what order they run from the control board.
+								This is required for certain LED animations and static theme support.
+							</p>
+							<p className="card-text">
+								Drag and drop list items to assign and reorder the RGB LEDs.
+							</p>
+							<DraggableListGroup
+								groupName="test"
+								titles={['Available Buttons', 'Assigned Buttons']}
+								dataSources={dataSources}
+								onChange={ledOrderChanged}
 							/>
-						</Row>
-					</Section>
-					<Section title="LED Button Order">
-						<p className="card-text">
-							Here you can define which buttons have RGB LEDs and in what order they run from the control board.
-							This is required for certain LED animations and static theme support.
-						</p>
-						<p className="card-text">
-							Drag and drop list items to assign and reorder the RGB LEDs.
-						</p>
-						<DraggableListGroup
-							groupName="test"
-							titles={['Available Buttons', 'Assigned Buttons']}
-							dataSources={dataSources}
-							onChange={ledOrderChanged}
-						/>
-					</Section>
-					<Button type="submit">Save</Button>
-					{saveMessage ? <span className="alert">{saveMessage}</span> : null}
-					<FormContext {...{
-						buttonLabels,
-						ledButtonMap,
-						setDataSources,
-						ledFormat: values.ledFormat
-					}} />
-				</Form>
-			)}
-		</Formik>
+						</Section>
+						<Button type="submit">Save</Button>
+						{saveMessage ? <span className="alert">{saveMessage}</span> : null}
+						<FormContext {...{
+							buttonLabels,
+							ledButtonMap,
+							setDataSources,
+							ledFormat: values.ledFormat
+						}} />
+					</Form>
+				)}
+			</Formik>
+			<LEDProgramSection />
+		</>
 	);
 }
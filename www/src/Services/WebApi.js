@@ -90,6 +90,57 @@ async function setLedOptions(options) {
 		});
 }
 
+async function getLedProgram() {
+	return axios.get(`${baseUrl}/api/getLedProgram`)
+		.then((response) => response.data)
+		.catch(console.error);
+}
+
+async function setLedProgram(program) {
+	return axios.post(`${baseUrl}/api/setLedProgram`, { program })
+		.then((response) => {
+			console.log(response.data);
+			return response.data;
+		})
+		.catch((err) => {
+			console.error(err);
+			return { success: false, error: 'Unable to Save' };
+		});
+}
+
+// Layout elements are [shape, x, y, width, height, mask], sent as 9 bytes each with the mask big endian
+async function getDisplayLayout() {
+	return axios.get(`${baseUrl}/api/getDisplayLayout`)
+		.then((response) => {
+			const bytes = response.data.layout.match(/../g) || [];
+			let elements = [];
+			for (let i = 0; i + 9 <= bytes.length; i += 9) {
+				const b = bytes.slice(i, i + 9).map((h) => parseInt(h, 16));
+				elements.push([b[0], b[1], b[2], b[3], b[4], ((b[5] << 24) | (b[6] << 16) | (b[7] << 8) | b[8]) >>> 0]);
+			}
+
+			return { elements, maxElements: response.data.maxElements };
+		})
+		.catch(console.error);
+}
+
+async function setDisplayLayout(elements) {
+	const hex = (value, digits) => (value >>> 0).toString(16).padStart(digits, '0');
+	const layout = elements
+		.map((e) => e.slice(0, 5).map((v) => hex(v & 0xFF, 2)).join('') + hex(e[5], 8))
+		.join('');
+
+	return axios.post(`${baseUrl}/api/setDisplayLayout`, { layout })
+		.then((response) => {
+			console.log(response.data);
+			return response.data;
+		})
+		.catch((err) => {
+			console.error(err);
+			return { success: false, error: 'Unable to Save' };
+		});
+}
+
 async function getPinMappings() {
 	return axios.get(`${baseUrl}/api/getPinMappings`)
 		.then((response) => {
@@ -143,6 +194,10 @@ const WebApi = {
 	setGamepadOptions,
 	getLedOptions,
 	setLedOptions,
+	getLedProgram,
+	setLedProgram,
+	getDisplayLayout,
+	setDisplayLayout,
 	getPinMappings,
 	setPinMappings,
 	getAddonsOptions,